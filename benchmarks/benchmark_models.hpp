@@ -0,0 +1,203 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_BENCHMARK_MODELS_HPP
+#define CASADI_BENCHMARK_MODELS_HPP
+
+#include <casadi/casadi.hpp>
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+/** \brief Test problems shared by the benchmarks
+ *
+ * Each model builds its inputs and outputs for either SX or MX, so that the same
+ * problem can be timed in both graph representations.
+ */
+namespace casadi {
+namespace benchmarks {
+
+  /// Function class for a given expression type
+  template<typename MatType> struct FunctionFor;
+  template<> struct FunctionFor<SX> { typedef SXFunction Type; };
+  template<> struct FunctionFor<MX> { typedef MXFunction Type; };
+
+  /// Determinant by expansion by minors (after ADOL-C's det_minor example)
+  struct DetMinor {
+    static const char* name() { return "DetMinor";}
+
+    /// Expand along row k, skipping the columns already used
+    template<typename MatType>
+    static MatType det(const MatType& A, int k, std::vector<bool>& used) {
+      if (k==A.size1()) return 1;
+      MatType t = 0;
+      bool plus = true;
+      for (int j=0; j<A.size2(); ++j) {
+        if (used[j]) continue;
+        used[j] = true;
+        MatType term = A(k, j)*det(A, k+1, used);
+        used[j] = false;
+        if (plus) {
+          t += term;
+        } else {
+          t -= term;
+        }
+        plus = !plus;
+      }
+      return t;
+    }
+
+    /// Determinant of an n-by-n matrix
+    template<typename MatType>
+    static void build(int n, std::vector<MatType>& arg, std::vector<MatType>& res) {
+      MatType A = MatType::sym("A", n, n);
+      std::vector<bool> used(n, false);
+      arg = std::vector<MatType>(1, A);
+      res = std::vector<MatType>(1, det(A, 0, used));
+    }
+  };
+
+  /// Hanging chain of n masses, one end fixed and the other one controlled
+  struct ChainMass {
+    static const char* name() { return "ChainMass";}
+
+    /// ODE right hand side with states [positions; velocities] and parameters the end position
+    template<typename MatType>
+    static void build(int n, std::vector<MatType>& arg, std::vector<MatType>& res) {
+      const double D = 1, L = 0.033, m = 0.03, g = 9.81;
+      int nf = n-1; // free masses
+      MatType x = MatType::sym("x", 6*nf);
+      MatType u = MatType::sym("u", 3);
+
+      // Positions of all masses, including the fixed and the controlled one
+      std::vector<MatType> p(1, MatType::zeros(3, 1));
+      for (int i=0; i<nf; ++i) p.push_back(x(Slice(3*i, 3*i+3)));
+      p.push_back(u);
+
+      // Spring forces
+      std::vector<MatType> F;
+      for (int i=0; i<n; ++i) {
+        MatType d = p[i+1]-p[i];
+        F.push_back(D*(1-L/sqrt(inner_prod(d, d)+1e-10))*d);
+      }
+
+      // Accelerations of the free masses
+      MatType gz = MatType::zeros(3, 1);
+      gz(2) = g;
+      std::vector<MatType> a;
+      for (int i=0; i<nf; ++i) a.push_back((F[i+1]-F[i])/m - gz);
+
+      arg.resize(2);
+      arg[0] = x;
+      arg[1] = u;
+      res = std::vector<MatType>(1, vertcat(x(Slice(3*nf, 6*nf)), vertcat(a)));
+    }
+  };
+
+  /// Shallow water equations on an n-by-n grid, integrated with explicit Euler
+  struct ShallowWater {
+    static const char* name() { return "ShallowWater";}
+
+    /// Number of time steps in the expression graph
+    static int nsteps() { return 20;}
+
+    /// Final height as a function of the initial height and the drag coefficient
+    template<typename MatType>
+    static void build(int n, std::vector<MatType>& arg, std::vector<MatType>& res) {
+      const double dx = 1./n, dy = 1./n, dt = 1e-3, g = 9.81, depth = 0.01;
+      MatType h0 = MatType::sym("h0", n, n);
+      MatType drag = MatType::sym("drag");
+
+      MatType h = h0, u = MatType::zeros(n+1, n), v = MatType::zeros(n, n+1);
+      Slice all, lo(0, n-1), hi(1, n);
+      for (int k=0; k<nsteps(); ++k) {
+        // Velocities, zero on the walls
+        MatType u_int = u(hi, all) - dt*g/dx*(h(hi, all)-h(lo, all)) - dt*drag*u(hi, all);
+        u = vertcat(vertcat(MatType::zeros(1, n), u_int), MatType::zeros(1, n));
+        MatType v_int = v(all, hi) - dt*g/dy*(h(all, hi)-h(all, lo)) - dt*drag*v(all, hi);
+        v = horzcat(horzcat(MatType::zeros(n, 1), v_int), MatType::zeros(n, 1));
+
+        // Height
+        h = h - depth*dt/dx*(u(Slice(1, n+1), all)-u(Slice(0, n), all))
+              - depth*dt/dy*(v(all, Slice(1, n+1))-v(all, Slice(0, n)));
+      }
+
+      arg.resize(2);
+      arg[0] = h0;
+      arg[1] = drag;
+      res = std::vector<MatType>(1, h);
+    }
+  };
+
+  /// Build and initialize the function of a model
+  template<typename MatType, typename Model>
+  typename FunctionFor<MatType>::Type makeFunction(int size) {
+    std::vector<MatType> arg, res;
+    Model::build(size, arg, res);
+    typename FunctionFor<MatType>::Type f(arg, res);
+    f.init();
+    return f;
+  }
+
+  /// Set all nonzeros of all inputs of a function
+  inline void setInputs(Function& f, double val) {
+    for (int i=0; i<f.getNumInputs(); ++i) {
+      std::fill(f.input(i).begin(), f.input(i).end(), val);
+    }
+  }
+
+  /// Skip a benchmark if a plugin cannot be loaded
+  template<typename Solver>
+  bool requirePlugin(benchmark::State& state, const std::string& name) {
+    if (Solver::hasPlugin(name)) return true;
+    state.SkipWithError(("plugin '" + name + "' not available").c_str());
+    return false;
+  }
+
+  /// Register one NLP benchmark per CUTEr problem found on disk
+  void registerCuterBenchmarks();
+
+  /// Sparse 2-D Laplacian on an n-by-n grid (five-point stencil)
+  inline DMatrix laplacian2D(int n) {
+    std::vector<int> row, col;
+    std::vector<double> val;
+    for (int i=0; i<n; ++i) {
+      for (int j=0; j<n; ++j) {
+        int k = i*n+j;
+        row.push_back(k); col.push_back(k); val.push_back(4);
+        if (i>0) { row.push_back(k); col.push_back(k-n); val.push_back(-1);}
+        if (i<n-1) { row.push_back(k); col.push_back(k+n); val.push_back(-1);}
+        if (j>0) { row.push_back(k); col.push_back(k-1); val.push_back(-1);}
+        if (j<n-1) { row.push_back(k); col.push_back(k+1); val.push_back(-1);}
+      }
+    }
+    return DMatrix::triplet(row, col, val, n*n, n*n);
+  }
+
+} // namespace benchmarks
+} // namespace casadi
+
+#endif // CASADI_BENCHMARK_MODELS_HPP
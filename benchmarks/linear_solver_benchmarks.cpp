@@ -0,0 +1,71 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "benchmark_models.hpp"
+
+using namespace casadi;
+using namespace casadi::benchmarks;
+
+/// Linear solver for the 2-D Laplacian on an n-by-n grid, factorized once
+static LinearSolver makeLinearSolver(const std::string& name, int n, int nrhs) {
+  DMatrix A = laplacian2D(n);
+  LinearSolver s(name, A.sparsity(), nrhs);
+  s.init();
+  s.setInput(A, LINSOL_A);
+  s.prepare();
+  return s;
+}
+
+/// Numerical factorization
+static void linearSolverPrepare(benchmark::State& state, const std::string& name) {
+  if (!requirePlugin<LinearSolver>(state, name)) return;
+  LinearSolver s = makeLinearSolver(name, state.range(0), 1);
+  for (auto _ : state) s.prepare();
+}
+
+/// Solve with an existing factorization, forward and transposed
+static void linearSolverSolve(benchmark::State& state, const std::string& name) {
+  if (!requirePlugin<LinearSolver>(state, name)) return;
+  int nrhs = 4;
+  LinearSolver s = makeLinearSolver(name, state.range(0), nrhs);
+  std::vector<double> b(s.input(LINSOL_A).size1()*nrhs, 1);
+  for (auto _ : state) {
+    s.solve(getPtr(b), nrhs, false);
+    s.solve(getPtr(b), nrhs, true);
+  }
+}
+
+#define CASADI_LINEAR_SOLVER_BENCHMARKS(NAME, SMALL, LARGE) \
+  BENCHMARK_CAPTURE(linearSolverPrepare, NAME, #NAME)->Arg(SMALL)->Arg(LARGE) \
+    ->Unit(benchmark::kMicrosecond); \
+  BENCHMARK_CAPTURE(linearSolverSolve, NAME, #NAME)->Arg(SMALL)->Arg(LARGE) \
+    ->Unit(benchmark::kMicrosecond);
+
+CASADI_LINEAR_SOLVER_BENCHMARKS(csparse, 8, 32)
+CASADI_LINEAR_SOLVER_BENCHMARKS(csparsecholesky, 8, 32)
+CASADI_LINEAR_SOLVER_BENCHMARKS(lapacklu, 8, 32)
+CASADI_LINEAR_SOLVER_BENCHMARKS(lapackqr, 8, 32)
+// The factorization is an SX expression graph, which grows quickly with the size
+CASADI_LINEAR_SOLVER_BENCHMARKS(symbolicqr, 4, 8)
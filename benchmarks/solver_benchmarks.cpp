@@ -0,0 +1,146 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "benchmark_models.hpp"
+#include <casadi/core/misc/symbolic_nlp.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace casadi;
+using namespace casadi::benchmarks;
+
+namespace {
+  /// Discard what the solvers print while a benchmark is running
+  class SilenceStdout {
+  public:
+    SilenceStdout() : buf_(std::cout.rdbuf(null_.rdbuf())) {}
+    ~SilenceStdout() { std::cout.rdbuf(buf_);}
+  private:
+    std::ofstream null_;
+    std::streambuf* buf_;
+  };
+} // namespace
+
+/// Integrate the chain mass ODE over one second
+static void integrate(benchmark::State& state, const std::string& name) {
+  if (!requirePlugin<Integrator>(state, name)) return;
+  int n = state.range(0);
+  std::vector<SX> arg, res;
+  ChainMass::build(n, arg, res);
+  SXFunction dae(daeIn("x", arg[0], "p", arg[1]), daeOut("ode", res[0]));
+  Integrator f(name, dae);
+  if (name=="collocation" || name=="oldcollocation") {
+    Dictionary implicit_solver_options;
+    implicit_solver_options["linear_solver"] = "csparse";
+    f.setOption("implicit_solver", "newton");
+    f.setOption("implicit_solver_options", implicit_solver_options);
+  }
+  f.init();
+
+  // Start from the masses equally spaced between the fixed end and the controlled one
+  DMatrix& x0 = f.input(INTEGRATOR_X0);
+  for (int i=0; i<n-1; ++i) x0.at(3*i) = (i+1.)/n;
+  f.setInput(DMatrix::ones(3, 1), INTEGRATOR_P);
+
+  for (auto _ : state) f.evaluate();
+}
+
+#define CASADI_INTEGRATOR_BENCHMARK(NAME) \
+  BENCHMARK_CAPTURE(integrate, NAME, #NAME)->Arg(5)->Arg(10)->Unit(benchmark::kMillisecond);
+
+CASADI_INTEGRATOR_BENCHMARK(cvodes)
+CASADI_INTEGRATOR_BENCHMARK(idas)
+CASADI_INTEGRATOR_BENCHMARK(rk)
+CASADI_INTEGRATOR_BENCHMARK(collocation)
+CASADI_INTEGRATOR_BENCHMARK(oldcollocation)
+
+/// Solve an NLP read from an NL-file, from the same initial guess every time
+static void solveNl(benchmark::State& state, const std::string& solver, const std::string& file) {
+  SymbolicNLP nl;
+  nl.parseNL(file);
+  SXFunction nlp(nlpIn("x", nl.x), nlpOut("f", nl.f, "g", nl.g));
+  NlpSolver f(solver, nlp);
+  if (solver=="sqpmethod") {
+    Dictionary qp_solver_options;
+    qp_solver_options["printLevel"] = "none";
+    f.setOption("qp_solver", "qpoases");
+    f.setOption("qp_solver_options", qp_solver_options);
+    f.setOption("print_header", false);
+    f.setOption("print_time", false);
+  }
+  f.init();
+  f.setInput(nl.x_lb, "lbx");
+  f.setInput(nl.x_ub, "ubx");
+  f.setInput(nl.g_lb, "lbg");
+  f.setInput(nl.g_ub, "ubg");
+
+  SilenceStdout silence;
+  for (auto _ : state) {
+    f.setInput(nl.x_init, "x0");
+    try {
+      f.evaluate();
+    } catch(std::exception& e) {
+      // A failed solve is reported, the remaining problems still run
+      state.SkipWithError(e.what());
+      break;
+    }
+  }
+}
+
+namespace casadi {
+namespace benchmarks {
+
+  void registerCuterBenchmarks() {
+    // Small problems from experimental/joel/cuter/cuter_problems.csv that sqpmethod solves with
+    // qpOASES from the standard starting point (bt1, bt9, hs100 and hs107 give QPs that qpOASES
+    // reports as unbounded or infeasible)
+    const char* problems[] = {"bt4", "genhs28", "hs6", "hs14", "hs71"};
+    const char* env_dir = std::getenv("CASADI_CUTER_DIR");
+    std::vector<std::string> dirs;
+    if (env_dir) dirs.push_back(env_dir);
+    dirs.push_back(CASADI_BENCHMARK_CUTER_DIR);
+    dirs.push_back(CASADI_BENCHMARK_NL_DIR);
+
+    // Solvers that do not need third-party NLP libraries
+    const char* solvers[] = {"sqpmethod"};
+    for (size_t s=0; s<sizeof(solvers)/sizeof(*solvers); ++s) {
+      if (!NlpSolver::hasPlugin(solvers[s]) || !QpSolver::hasPlugin("qpoases")) continue;
+      for (size_t p=0; p<sizeof(problems)/sizeof(*problems); ++p) {
+        for (size_t d=0; d<dirs.size(); ++d) {
+          std::string file = dirs[d] + "/" + problems[p] + ".nl";
+          if (!std::ifstream(file.c_str())) continue;
+          std::string name = std::string("CUTEr/") + solvers[s] + "/" + problems[p];
+          benchmark::RegisterBenchmark(name.c_str(), solveNl, solvers[s], file)
+            ->Unit(benchmark::kMillisecond);
+          break;
+        }
+      }
+    }
+  }
+
+} // namespace benchmarks
+} // namespace casadi
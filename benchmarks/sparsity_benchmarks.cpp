@@ -0,0 +1,98 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "benchmark_models.hpp"
+
+using namespace casadi;
+using namespace casadi::benchmarks;
+
+/// Jacobian sparsity pattern detection, on a freshly initialized function every time
+template<typename MatType, typename Model>
+static void BM_JacSparsity(benchmark::State& state) {
+  std::vector<MatType> arg, res;
+  Model::build(state.range(0), arg, res);
+  for (auto _ : state) {
+    state.PauseTiming();
+    typename FunctionFor<MatType>::Type f(arg, res);
+    f.init();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(f.jacSparsity(0, 0).size());
+  }
+}
+
+BENCHMARK_TEMPLATE2(BM_JacSparsity, SX, ChainMass)->Arg(10)->Arg(40)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE2(BM_JacSparsity, MX, ChainMass)->Arg(10)->Arg(40)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE2(BM_JacSparsity, SX, ShallowWater)->Arg(8)->Arg(16)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE2(BM_JacSparsity, MX, ShallowWater)->Arg(8)->Arg(16)
+  ->Unit(benchmark::kMicrosecond);
+
+/// Jacobian of the chain mass ODE, a non-symmetric banded pattern
+static Sparsity chainMassJacobian(int n) {
+  SXFunction f = makeFunction<SX, ChainMass>(n);
+  return f.jacSparsity(0, 0);
+}
+
+static void BM_UnidirectionalColoring(benchmark::State& state) {
+  Sparsity sp = chainMassJacobian(state.range(0));
+  Sparsity spT = sp.T();
+  Sparsity D;
+  for (auto _ : state) D = spT.unidirectionalColoring(sp);
+  state.counters["colors"] = D.size2();
+}
+BENCHMARK(BM_UnidirectionalColoring)->Arg(40)->Arg(160)->Unit(benchmark::kMicrosecond);
+
+static void BM_BidirectionalColoring(benchmark::State& state) {
+  Sparsity sp = chainMassJacobian(state.range(0));
+  Sparsity spT = sp.T();
+  Sparsity D1, D2;
+  for (auto _ : state) spT.bidirectionalColoring(sp, D1, D2);
+  state.counters["colors"] = D1.size2() + D2.size2();
+}
+BENCHMARK(BM_BidirectionalColoring)->Arg(40)->Arg(160)->Unit(benchmark::kMicrosecond);
+
+/// Symmetric colorings of the 2-D Laplacian
+enum SymmetricColoring { STAR, STAR2, ACYCLIC};
+
+static void symmetricColoring(benchmark::State& state, SymmetricColoring alg) {
+  Sparsity sp = laplacian2D(state.range(0)).sparsity();
+  Sparsity D;
+  for (auto _ : state) {
+    switch (alg) {
+    case STAR: D = sp.starColoring(); break;
+    case STAR2: D = sp.starColoring2(); break;
+    case ACYCLIC: D = sp.acyclicColoring(); break;
+    }
+  }
+  state.counters["colors"] = D.size2();
+}
+BENCHMARK_CAPTURE(symmetricColoring, StarColoring, STAR)->Arg(32)->Arg(64)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(symmetricColoring, StarColoring2, STAR2)->Arg(32)->Arg(64)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(symmetricColoring, AcyclicColoring, ACYCLIC)->Arg(32)->Arg(64)
+  ->Unit(benchmark::kMicrosecond);
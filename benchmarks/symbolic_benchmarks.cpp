@@ -0,0 +1,97 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "benchmark_models.hpp"
+
+using namespace casadi;
+using namespace casadi::benchmarks;
+
+/// Build the expression graph and the function object
+template<typename MatType, typename Model>
+static void BM_Construct(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<MatType> arg, res;
+    Model::build(state.range(0), arg, res);
+    typename FunctionFor<MatType>::Type f(arg, res);
+    benchmark::DoNotOptimize(f.get());
+  }
+}
+
+/// Sort the expression graph into an algorithm
+template<typename MatType, typename Model>
+static void BM_Init(benchmark::State& state) {
+  std::vector<MatType> arg, res;
+  Model::build(state.range(0), arg, res);
+  for (auto _ : state) {
+    typename FunctionFor<MatType>::Type f(arg, res);
+    f.init();
+  }
+}
+
+/// Numerical evaluation of a function
+static void evaluate(benchmark::State& state, Function f) {
+  setInputs(f, 0.5);
+  for (auto _ : state) f.evaluate();
+}
+
+template<typename MatType, typename Model>
+static void BM_Evaluate(benchmark::State& state) {
+  typename FunctionFor<MatType>::Type f = makeFunction<MatType, Model>(state.range(0));
+  evaluate(state, f);
+  state.counters["ops"] = f.getAlgorithmSize();
+}
+
+/// One forward directional derivative
+template<typename MatType, typename Model>
+static void BM_Forward(benchmark::State& state) {
+  Function f = makeFunction<MatType, Model>(state.range(0)).derivative(1, 0);
+  f.init();
+  evaluate(state, f);
+}
+
+/// One adjoint directional derivative
+template<typename MatType, typename Model>
+static void BM_Adjoint(benchmark::State& state) {
+  Function f = makeFunction<MatType, Model>(state.range(0)).derivative(0, 1);
+  f.init();
+  evaluate(state, f);
+}
+
+#define CASADI_SYMBOLIC_BENCHMARK(BM, MatType, Model, SMALL, LARGE) \
+  BENCHMARK_TEMPLATE2(BM, MatType, Model)->Arg(SMALL)->Arg(LARGE)->Unit(benchmark::kMicrosecond);
+
+#define CASADI_SYMBOLIC_BENCHMARKS(MatType, Model, SMALL, LARGE) \
+  CASADI_SYMBOLIC_BENCHMARK(BM_Construct, MatType, Model, SMALL, LARGE) \
+  CASADI_SYMBOLIC_BENCHMARK(BM_Init, MatType, Model, SMALL, LARGE) \
+  CASADI_SYMBOLIC_BENCHMARK(BM_Evaluate, MatType, Model, SMALL, LARGE) \
+  CASADI_SYMBOLIC_BENCHMARK(BM_Forward, MatType, Model, SMALL, LARGE) \
+  CASADI_SYMBOLIC_BENCHMARK(BM_Adjoint, MatType, Model, SMALL, LARGE)
+
+CASADI_SYMBOLIC_BENCHMARKS(SX, DetMinor, 5, 7)
+CASADI_SYMBOLIC_BENCHMARKS(MX, DetMinor, 4, 5)
+CASADI_SYMBOLIC_BENCHMARKS(SX, ChainMass, 10, 40)
+CASADI_SYMBOLIC_BENCHMARKS(MX, ChainMass, 10, 40)
+CASADI_SYMBOLIC_BENCHMARKS(SX, ShallowWater, 8, 16)
+CASADI_SYMBOLIC_BENCHMARKS(MX, ShallowWater, 8, 16)
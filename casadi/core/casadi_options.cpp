@@ -25,6 +25,7 @@
 
 #include "casadi_options.hpp"
 #include "casadi_exception.hpp"
+#include "profiling.hpp"
 
 namespace casadi {
 
@@ -33,12 +34,29 @@ namespace casadi {
   bool CasadiOptions::profiling = false;
   std::ofstream CasadiOptions::profilingLog;
   bool CasadiOptions::profilingBinary = true;
+  int CasadiOptions::profilingSampling = 1;
   bool CasadiOptions::purgeSeeds = false;
   bool CasadiOptions::allowed_internal_api = false;
+  std::string CasadiOptions::codegen_cache_dir;
+
+  void CasadiOptions::setProfilingSampling(int n) {
+    casadi_assert_message(n>=1, "Profiling sampling must be positive, got " << n);
+    profilingSampling = n;
+  }
 
   void CasadiOptions::startProfiling(const std::string &filename) {
-    profilingLog.open(filename.c_str(), std::ofstream::out);
+    casadi_assert_message(profilingSampling>=1,
+                          "Profiling sampling must be positive, got " << profilingSampling);
+    stopProfiling();
+    ProfilingLogLock lock;
+    profilingLog.open(filename.c_str(), std::ofstream::out | std::ofstream::binary);
     if (profilingLog.is_open()) {
+      if (profilingBinary) {
+        ProfilingData_CLOCK s;
+        s.ticks = getTicks();
+        s.time = getRealTime();
+        profileWrite(profilingLog, s);
+      }
       profiling = true;
     } else {
       casadi_error("Did not manage to open file " << filename << " for logging.");
@@ -46,10 +64,17 @@ namespace casadi {
   }
 
   void CasadiOptions::stopProfiling() {
-    if (profiling) {
-      profilingLog.close();
-    }
+    if (!profiling) return;
     profiling = false;
+    ProfilingBuffer::flushAll();
+    ProfilingLogLock lock;
+    if (profilingBinary) {
+      ProfilingData_CLOCK s;
+      s.ticks = getTicks();
+      s.time = getRealTime();
+      profileWrite(profilingLog, s);
+    }
+    profilingLog.close();
   }
 
 } // namespace casadi
@@ -75,10 +75,20 @@ namespace casadi {
 
       static bool profilingBinary;
 
+      /** \brief Record only every n-th outermost function call on each thread
+      * Default: 1
+      */
+      static int profilingSampling;
+
       static bool purgeSeeds;
 
       static bool allowed_internal_api;
 
+      /** \brief Directory in which dynamically compiled functions are cached
+      * Empty (default) disables the cache
+      */
+      static std::string codegen_cache_dir;
+
 #endif //SWIG
       // Setter and getter for catch_errors_swig
       static void setCatchErrorsSwig(bool flag) { catch_errors_swig = flag; }
@@ -93,6 +103,12 @@ namespace casadi {
       *  When profiling is active, each primitive of an MX algorithm is profiling and dumped into the supplied file _filename_
       *  After the profiling is done, convert the supplied file to a viewable webpage with:
       * `casadi-build-dir/bin/profilereport _filename_`
+      *  or to a Chrome trace-event file (chrome://tracing) with:
+      * `casadi-build-dir/bin/profiletrace _filename_ trace.json`
+      *
+      *  In binary mode, each thread records into its own buffer and the buffers are
+      *  written out when full and by stopProfiling, which should be called once all
+      *  evaluations have finished.
       */
       static void startProfiling(const std::string &filename);
       static void stopProfiling();
@@ -100,11 +116,27 @@ namespace casadi {
       static void setProfilingBinary(bool flag) {  profilingBinary = flag; }
       static bool getProfilingBinary() { return  profilingBinary; }
 
+      /** \brief Record only every n-th outermost call on each thread, n must be positive
+      *
+      *  This reduces the overhead of profiling long runs to roughly 1/n.
+      */
+      static void setProfilingSampling(int n);
+      static int getProfilingSampling() { return profilingSampling; }
+
       static void setPurgeSeeds(bool flag) { purgeSeeds = flag; }
       static bool setPurgeSeeds() { return purgeSeeds; }
 
       static void setAllowedInternalAPI(bool flag) { allowed_internal_api= flag; }
       static bool getAllowedInternalAPI() { return allowed_internal_api; }
+
+      /** \brief Cache dynamically compiled functions in a directory
+      *
+      *  Generated code is keyed by a hash of its contents, the compiler and the compiler flags,
+      *  so that unchanged functions are reloaded instead of recompiled. The directory
+      *  can be shared between concurrent processes.
+      */
+      static void setCodegenCacheDir(const std::string& dir) { codegen_cache_dir = dir; }
+      static std::string getCodegenCacheDir() { return codegen_cache_dir; }
   };
 
 } // namespace casadi
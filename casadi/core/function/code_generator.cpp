@@ -33,6 +33,39 @@ using namespace std;
 namespace casadi {
 
   void CodeGenerator::flush(std::ostream& s) const {
+    flushMain(s);
+
+    // Chunks in the same translation unit
+    for (int i=0; i<chunks_.size(); ++i) {
+      s << chunks_[i];
+    }
+  }
+
+  void CodeGenerator::flush(std::ostream& s, std::vector<std::string>& units) const {
+    flushMain(s);
+
+    // Each chunk in a separate translation unit, the auxiliaries are defined in the main one
+    units.clear();
+    for (int i=0; i<chunks_.size(); ++i) {
+      stringstream u;
+      u << "/* This function was automatically generated by CasADi */" << endl;
+      u << includes_.str() << endl;
+      u << "#define d double" << endl << endl;
+      u << auxiliary_declarations_.str() << endl;
+      u << chunks_[i];
+      units.push_back(u.str());
+    }
+  }
+
+  std::string CodeGenerator::addChunk(const std::string& prefix, const std::string& args,
+                                      const std::string& body) {
+    string name = prefix + "_chunk" + numToString(chunks_.size());
+    declarations_ << "void " << name << args << ";" << endl;
+    chunks_.push_back("void " + name + args + " {\n" + body + "}\n\n");
+    return name;
+  }
+
+  void CodeGenerator::flushMain(std::ostream& s) const {
     s << includes_.str();
     s << endl;
 
@@ -56,6 +89,7 @@ namespace casadi {
       printVector(s, name.str(), double_constants_[i]);
     }
 
+    s << declarations_.str();
     s << dependencies_.str();
     s << function_.str();
     s << finalization_.str();
@@ -278,15 +312,37 @@ namespace casadi {
     case AUX_TRANS:
       auxiliaries_ << codegen_str_trans << endl;
       break;
+    case AUX_DENSIFY:
+      auxiliaries_ << codegen_str_densify << endl;
+      break;
+    case AUX_NORM_INF:
+      auxiliaries_ << codegen_str_norm_inf << endl;
+      break;
+    case AUX_MAX_VIOL:
+      auxiliaries_ << codegen_str_max_viol << endl;
+      break;
+    case AUX_CHOL:
+      auxiliaries_ << codegen_str_chol << endl;
+      auxiliaries_ << codegen_str_chol_solve << endl;
+      break;
+    case AUX_QP_DENSE:
+      addAuxiliary(AUX_CHOL);
+      auxiliaries_ << codegen_str_qp_dense_c << endl;
+      auxiliaries_ << codegen_str_qp_dense_ct << endl;
+      auxiliaries_ << codegen_str_qp_dense_step << endl;
+      auxiliaries_ << codegen_str_qp_dense << endl;
+      break;
     }
   }
 
   void CodeGenerator::auxSq() {
     auxiliaries_ << "d sq(d x) { return x*x;}" << endl << endl;
+    auxiliary_declarations_ << "d sq(d x);" << endl;
   }
 
   void CodeGenerator::auxSign() {
     auxiliaries_ << "d sign(d x) { return x<0 ? -1 : x>0 ? 1 : x;}" << endl << endl;
+    auxiliary_declarations_ << "d sign(d x);" << endl;
   }
 
   void CodeGenerator::printConstant(std::ostream& s, double v) {
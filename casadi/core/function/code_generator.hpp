@@ -83,15 +83,33 @@ namespace casadi {
       AUX_SIGN,
       AUX_MM_SPARSE,
       AUX_COPY_SPARSE,
-      AUX_TRANS
+      AUX_TRANS,
+      AUX_DENSIFY,
+      AUX_NORM_INF,
+      AUX_MAX_VIOL,
+
+      // Dense linear algebra and optimization
+      AUX_CHOL,
+      AUX_QP_DENSE
     };
 
     /** \brief Add a built-in auxiliary function */
     void addAuxiliary(Auxiliary f);
 
+    /** \brief Add a function whose definition can be compiled as a separate translation unit
+     *
+     * The function is declared as "void name(args);" and its name, which starts with prefix, is
+     * returned. The chunks have external linkage, so the prefix should identify the function.
+     */
+    std::string addChunk(const std::string& prefix, const std::string& args,
+                         const std::string& body);
+
     /// Flush generated file to a stream
     void flush(std::ostream& s) const;
 
+    /// Flush generated file to a stream, with the chunks as separate translation units
+    void flush(std::ostream& s, std::vector<std::string>& units) const;
+
     /** Convert in integer to a string */
     static std::string numToString(int n);
 
@@ -113,12 +131,17 @@ namespace casadi {
     /// SIGN
     void auxSign();
 
+    /// Print everything but the chunks
+    void flushMain(std::ostream& s) const;
+
     //  private:
   public:
 
     // Stringstreams holding the different parts of the file being generated
     std::stringstream includes_;
     std::stringstream auxiliaries_;
+    std::stringstream auxiliary_declarations_;
+    std::stringstream declarations_;
     std::stringstream dependencies_;
     std::stringstream function_;
     std::stringstream finalization_;
@@ -132,6 +155,9 @@ namespace casadi {
     std::multimap<size_t, size_t> added_double_constants_;
     std::multimap<size_t, size_t> added_integer_constants_;
 
+    // Definitions of functions that can be compiled separately
+    std::vector<std::string> chunks_;
+
     // Constants
     std::vector<std::vector<double> > double_constants_;
     std::vector<std::vector<int> > integer_constants_;
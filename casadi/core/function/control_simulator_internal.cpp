@@ -55,6 +55,9 @@ namespace casadi {
               "Options to be passed to the integrator");
     addOption("simulator_options",       OT_DICTIONARY, GenericType(),
               "Options to be passed to the simulator");
+    addOption("dense_output",            OT_BOOLEAN,       false,
+              "Evaluate the minor grid from the dense output of the integrator "
+              "instead of stopping the integrator at each minor grid point.");
     addOption("control_interpolation",   OT_STRING,     "none", "none|nearest|linear");
     addOption("control_endpoint",        OT_BOOLEAN,       false,
               "Include a control value at the end of the simulation domain. "
@@ -328,6 +331,7 @@ namespace casadi {
 
     // Create the simulator
     simulator_ = Simulator(integrator_, output_fcn_, gridlocal_);
+    simulator_.setOption("dense_output", getOption("dense_output"));
     if (hasSetOption("simulator_options")) {
       simulator_.setOption(getOption("simulator_options"));
     }
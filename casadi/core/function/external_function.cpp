@@ -41,6 +41,10 @@ using namespace std;
     assignNode(new ExternalFunctionInternal(bin_name));
   }
 
+  ExternalFunction::ExternalFunction(const std::string& bin_name, const std::string& prefix) {
+    assignNode(new ExternalFunctionInternal(bin_name, prefix));
+  }
+
   ExternalFunctionInternal* ExternalFunction::operator->() {
     return static_cast<ExternalFunctionInternal*>(Function::operator->());
   }
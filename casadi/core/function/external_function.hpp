@@ -50,6 +50,10 @@ public:
   /** \brief  Create an empty function */
   explicit ExternalFunction(const std::string& bin_name);
 
+  /** \brief  Load a function whose entry points carry a prefix, e.g. "fwd_" for the
+   * forward derivative kernel exported with the option "codegen_derivatives" */
+  ExternalFunction(const std::string& bin_name, const std::string& prefix);
+
   /** \brief  Access functions of the node */
   ExternalFunctionInternal* operator->();
 
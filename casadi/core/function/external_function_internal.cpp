@@ -25,6 +25,8 @@
 
 #include "external_function_internal.hpp"
 #include "../std_vector_tools.hpp"
+#include "mx_function.hpp"
+#include "../mx/mx_tools.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -34,8 +36,9 @@ namespace casadi {
 
 using namespace std;
 
-ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name) :
-    bin_name_(bin_name) {
+ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name,
+                                                   const std::string& prefix) :
+    bin_name_(bin_name), prefix_(prefix) {
 #ifdef WITH_DL
 
   // Load the dll
@@ -43,33 +46,30 @@ ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name)
   handle_ = LoadLibrary(TEXT(bin_name_.c_str()));
   casadi_assert_message(handle_!=0, "ExternalFunctionInternal: Cannot open function: "
                         << bin_name_ << ". error code (WIN32): "<< GetLastError());
-
-  initPtr init = (initPtr)GetProcAddress(handle_, TEXT("init"));
-  if (init==0) throw CasadiException("ExternalFunctionInternal: no \"init\" found");
-  getSparsityPtr getSparsity = (getSparsityPtr)GetProcAddress(handle_, TEXT("getSparsity"));
-  if (getSparsity==0) throw CasadiException("ExternalFunctionInternal: no \"getSparsity\" found");
-  evaluate_ = (evaluatePtr) GetProcAddress(handle_, TEXT("evaluateWrap"));
-  if (evaluate_==0) throw CasadiException("ExternalFunctionInternal: no \"evaluateWrap\" found");
-
 #else // _WIN32
   handle_ = dlopen(bin_name_.c_str(), RTLD_LAZY);
   casadi_assert_message(handle_!=0, "ExternalFunctionInternal: Cannot open function: "
                         << bin_name_ << ". error code: "<< dlerror());
-
-  // reset error
-  dlerror();
+#endif // _WIN32
 
   // Load symbols
-  initPtr init = (initPtr)dlsym(handle_, "init");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"init\" found. "
-                                       "Possible cause: If the function was generated from CasADi, "
-                                       "make sure that it was compiled with a C compiler. If the "
-                                       "function is C++, make sure to use extern \"C\" linkage.");
-  getSparsityPtr getSparsity = (getSparsityPtr)dlsym(handle_, "getSparsity");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"getSparsity\" found");
-  evaluate_ = (evaluatePtr) dlsym(handle_, "evaluateWrap");
-  if (dlerror()) throw CasadiException("ExternalFunctionInternal: no \"evaluateWrap\" found");
-#endif // _WIN32
+  initPtr init = (initPtr)getSymbol(prefix_ + "init");
+  if (init==0) throw CasadiException("ExternalFunctionInternal: no \"" + prefix_ + "init\" found. "
+                                     "Possible cause: If the function was generated from CasADi, "
+                                     "make sure that it was compiled with a C compiler. If the "
+                                     "function is C++, make sure to use extern \"C\" linkage.");
+  getSparsityPtr getSparsity = (getSparsityPtr)getSymbol(prefix_ + "getSparsity");
+  if (getSparsity==0) throw CasadiException("ExternalFunctionInternal: no \"" + prefix_
+                                            + "getSparsity\" found");
+  evaluate_ = (evaluatePtr)getSymbol(prefix_ + "evaluateWrap");
+  if (evaluate_==0) throw CasadiException("ExternalFunctionInternal: no \"" + prefix_
+                                          + "evaluateWrap\" found");
+
+  // Optional derivative kernels and Jacobian sparsity
+  has_fwd_ = getSymbol(prefix_ + "fwd_evaluateWrap")!=0;
+  has_adj_ = getSymbol(prefix_ + "adj_evaluateWrap")!=0;
+  has_jac_ = getSymbol(prefix_ + "jac_evaluateWrap")!=0;
+  jac_sparsity_fcn_ = (getJacSparsityPtr)getSymbol(prefix_ + "getJacSparsity");
 
   // Initialize and get the number of inputs and outputs
   int n_in=-1, n_out=-1;
@@ -113,6 +113,22 @@ ExternalFunctionInternal::ExternalFunctionInternal(const std::string& bin_name)
 
 }
 
+void* ExternalFunctionInternal::getSymbol(const std::string& name) {
+#ifdef WITH_DL
+#ifdef _WIN32
+  return (void*)GetProcAddress(handle_, name.c_str());
+#else // _WIN32
+  // reset error
+  dlerror();
+  void* ret = dlsym(handle_, name.c_str());
+  if (dlerror()) return 0;
+  return ret;
+#endif // _WIN32
+#else // WITH_DL
+  return 0;
+#endif // WITH_DL
+}
+
 ExternalFunctionInternal* ExternalFunctionInternal::clone() const {
   throw CasadiException("Error ExternalFunctionInternal cannot be cloned");
 }
@@ -150,6 +166,103 @@ void ExternalFunctionInternal::init() {
     output_array_[i] = output(i).ptr();
 }
 
+Function ExternalFunctionInternal::getDerivative(int nfwd, int nadj) {
+  // Use the directional derivative kernels, if exported
+  if ((nfwd==0 || has_fwd_) && (nadj==0 || has_adj_)) {
+    int n_in = getNumInputs();
+    int n_out = getNumOutputs();
+
+    // Nondifferentiated inputs and outputs
+    vector<MX> arg = symbolicInput();
+    vector<MX> ret_arg = arg;
+    vector<MX> ret_res = shared_from_this<Function>().call(arg);
+    vector<MX> v, d;
+
+    // Forward directions, one kernel call each
+    if (nfwd>0) {
+      ExternalFunction fwd(bin_name_, prefix_ + "fwd_");
+      fwd.init();
+      for (int dir=0; dir<nfwd; ++dir) {
+        v = arg;
+        for (int i=0; i<n_in; ++i) {
+          stringstream ss;
+          ss << "fseed" << dir << "_" << i;
+          d.push_back(MX::sym(ss.str(), input(i).sparsity()));
+        }
+        v.insert(v.end(), d.begin(), d.end());
+        ret_arg.insert(ret_arg.end(), d.begin(), d.end());
+        d.clear();
+        v = fwd.call(v);
+        ret_res.insert(ret_res.end(), v.begin()+n_out, v.end());
+      }
+    }
+
+    // Adjoint directions, one kernel call each
+    if (nadj>0) {
+      ExternalFunction adj(bin_name_, prefix_ + "adj_");
+      adj.init();
+      for (int dir=0; dir<nadj; ++dir) {
+        v = arg;
+        for (int i=0; i<n_out; ++i) {
+          stringstream ss;
+          ss << "aseed" << dir << "_" << i;
+          d.push_back(MX::sym(ss.str(), output(i).sparsity()));
+        }
+        v.insert(v.end(), d.begin(), d.end());
+        ret_arg.insert(ret_arg.end(), d.begin(), d.end());
+        d.clear();
+        v = adj.call(v);
+        ret_res.insert(ret_res.end(), v.begin()+n_out, v.end());
+      }
+    }
+
+    return MXFunction(ret_arg, ret_res);
+  }
+
+  // Use the Jacobian kernel, if exported
+  if (has_jac_) {
+    return getDerivativeViaJac(nfwd, nadj);
+  }
+
+  return FunctionInternal::getDerivative(nfwd, nadj);
+}
+
+Function ExternalFunctionInternal::getFullJacobian() {
+  if (has_jac_) {
+    ExternalFunction ret(bin_name_, prefix_ + "jac_");
+    ret.init();
+    return ret;
+  } else {
+    return FunctionInternal::getFullJacobian();
+  }
+}
+
+Function ExternalFunctionInternal::getJacobian(int iind, int oind, bool compact, bool symmetric) {
+  // For a single input, single output function, the full Jacobian is the compact Jacobian
+  if (has_jac_ && compact && getNumInputs()==1 && getNumOutputs()==1) {
+    ExternalFunction ret(bin_name_, prefix_ + "jac_");
+    ret.init();
+    return ret;
+  } else {
+    return FunctionInternal::getJacobian(iind, oind, compact, symmetric);
+  }
+}
+
+Sparsity ExternalFunctionInternal::getJacSparsity(int iind, int oind, bool symmetric) {
+  // Dense sparsity, unless exported
+  if (jac_sparsity_fcn_==0) {
+    return FunctionInternal::getJacSparsity(iind, oind, symmetric);
+  }
+
+  // Get the compact pattern of the Jacobian block
+  int nrow, ncol, *colind, *row;
+  int flag = jac_sparsity_fcn_(iind, oind, &nrow, &ncol, &colind, &row);
+  if (flag) throw CasadiException("ExternalFunctionInternal: \"getJacSparsity\" failed");
+  vector<int> colindv(colind, colind+ncol+1);
+  vector<int> rowv(row, row+colindv.back());
+  return Sparsity(nrow, ncol, colindv, rowv);
+}
+
 
 
 
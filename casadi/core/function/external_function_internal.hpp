@@ -47,7 +47,8 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
   public:
 
     /** \brief  constructor */
-    explicit ExternalFunctionInternal(const std::string& bin_name);
+    explicit ExternalFunctionInternal(const std::string& bin_name,
+                                      const std::string& prefix="");
 
     /** \brief  clone function */
     virtual ExternalFunctionInternal* clone() const;
@@ -61,6 +62,25 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
     /** \brief  Initialize */
     virtual void init();
 
+    /** \brief  Generate a function that calculates \a nfwd forward derivatives
+     * and \a nadj adjoint derivatives, using the exported kernels if available */
+    virtual Function getDerivative(int nfwd, int nadj);
+
+    /** \brief  Return the exported full Jacobian kernel, if available */
+    virtual Function getFullJacobian();
+
+    /** \brief  Calculate the jacobian of output \a oind with respect to input \a iind */
+    virtual Function getJacobian(int iind, int oind, bool compact, bool symmetric);
+
+    /** \brief  Get the sparsity of a Jacobian block, exported or dense */
+    virtual Sparsity getJacSparsity(int iind, int oind, bool symmetric);
+
+    /** \brief  Propagate the sparsity pattern using the exported Jacobian sparsity */
+    virtual void spEvaluate(bool fwd) { spEvaluateViaJacSparsity(fwd);}
+
+    /** \brief  Is the Jacobian sparsity exported? */
+    virtual bool spCanEvaluate(bool fwd) { return jac_sparsity_fcn_!=0;}
+
   protected:
 
 ///@{
@@ -68,13 +88,25 @@ class CASADI_EXPORT ExternalFunctionInternal : public FunctionInternal {
   typedef int (*evaluatePtr)(const double** x, double** r);
   typedef int (*initPtr)(int *n_in_, int *n_out_);
   typedef int (*getSparsityPtr)(int n_in, int *n_row, int *n_col, int **colind, int **row);
+  typedef int (*getJacSparsityPtr)(int iind, int oind, int *n_row, int *n_col,
+                                   int **colind, int **row);
 ///@}
 
+  /** \brief  Get a symbol from the dll, null if not found */
+  void* getSymbol(const std::string& name);
+
   /** \brief  Name of binary */
   std::string bin_name_;
 
+  /** \brief  Prefix of the entry points */
+  std::string prefix_;
+
   /** \brief  Function pointers */
   evaluatePtr evaluate_;
+  getJacSparsityPtr jac_sparsity_fcn_;
+
+  /** \brief  Are derivative kernels exported? */
+  bool has_fwd_, has_adj_, has_jac_;
 
 #if defined(WITH_DL) && defined(_WIN32) // also for 64-bit
   typedef HINSTANCE handle_t;
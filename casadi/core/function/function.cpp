@@ -30,6 +30,7 @@
 #include "../std_vector_tools.hpp"
 #include "../matrix/matrix_tools.hpp"
 #include "parallelizer.hpp"
+#include "../sx/constant_sx.hpp"
 
 using namespace std;
 
@@ -126,7 +127,7 @@ namespace casadi {
 
   void Function::evaluate() {
     assertInit();
-    (*this)->evaluate();
+    (*this)->evaluateWithStats();
   }
 
   int Function::getNumInputNonzeros() const {
@@ -190,6 +191,10 @@ namespace casadi {
     (*this)->monitors_.erase(mon);
   }
 
+  void Function::statsIO(bool input, int nnz) const {
+    if (!isNull()) (*this)->statsIO(input, nnz);
+  }
+
   const Dictionary & Function::getStats() const {
     return (*this)->getStats();
   }
@@ -198,6 +203,20 @@ namespace casadi {
     return (*this)->getStat(name);
   }
 
+  Dictionary Function::getMemoryUsage() const {
+    return (*this)->getMemoryUsage();
+  }
+
+  Dictionary Function::getGlobalMemoryUsage() {
+    Dictionary mem;
+    Sparsity::CacheStats sp = Sparsity::getCacheStats();
+    mem["sparsity_cache"] = static_cast<double>(sp.interned_bytes + sp.table_bytes);
+    mem["sx_constants"] = static_cast<double>(RealtypeSX::numCached()*sizeof(RealtypeSX)
+                                              + IntegerSX::numCached()*sizeof(IntegerSX));
+    mem["total"] = mem["sparsity_cache"].toDouble() + mem["sx_constants"].toDouble();
+    return mem;
+  }
+
   Sparsity& Function::jacSparsity(int iind, int oind, bool compact, bool symmetric) {
     return (*this)->jacSparsity(iind, oind, compact, symmetric);
   }
@@ -426,14 +426,36 @@ NOTE: Does _not_ take ownership, only weak references to the derivatives are kep
 
     /// Check if a particular cast is allowed
     static bool testCast(const SharedObjectNode* ptr);
+
+    /// Record that nnz nonzeros were passed through setInput or getOutput
+    void statsIO(bool input, int nnz) const;
     /// \endcond
 
-    /// Get all statistics obtained at the end of the last evaluate call
+    /** \brief Get all statistics obtained at the end of the last evaluate call
+     *
+     * With the option gather_stats set, this includes call counts and wall times of
+     * evaluations, derivative evaluations and sparsity sweeps, see FunctionInternal::getStats
+     */
     const Dictionary& getStats() const;
 
     /// Get a single statistic obtained at the end of the last evaluate call
     GenericType getStat(const std::string& name) const;
 
+    /** \brief Get the memory used by the function, in bytes by category
+     *
+     * The categories depend on the class, e.g. "algorithm", "work", "symbolic" and
+     * "sx_nodes" for SXFunction. Cached derivative functions that are still alive are
+     * counted under "derivatives", and "total" is the sum of all categories.
+     */
+    Dictionary getMemoryUsage() const;
+
+    /** \brief Get the memory held by the global caches, in bytes by category
+     *
+     * "sparsity_cache" is the cache of sparsity patterns including the patterns themselves,
+     * "sx_constants" the cached constants of the SX graphs, and "total" the sum.
+     */
+    static Dictionary getGlobalMemoryUsage();
+
     /** \brief  Get a vector of symbolic variables with the same dimensions as the inputs
      *
      * There is no guarantee that consecutive calls return identical objects
@@ -32,20 +32,58 @@
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
 #include "external_function.hpp"
+#include "sparsity_cache.hpp"
 
 #include "../casadi_options.hpp"
 #include "../profiling.hpp"
 
 #include <cctype>
+#include <ctime>
+#ifdef USE_CXX11
+#include <thread>
+#include <exception>
+#include <chrono>
+#endif // USE_CXX11
 #ifdef WITH_DL
 #include <cstdlib>
-#include <ctime>
+#include <cstdio>
+#include <fstream>
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else // _WIN32
+#include <unistd.h>
+#endif // _WIN32
 #endif // WITH_DL
 
 using namespace std;
 
 namespace casadi {
 
+  double getStatsTime() {
+#ifdef USE_CXX11
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+#else // USE_CXX11
+    // Processor time, as for the batch statistics of NlpSolverInternal
+    return clock()/static_cast<double>(CLOCKS_PER_SEC);
+#endif // USE_CXX11
+  }
+
+  void EvaluationStats::add(const EvaluationStats& s) {
+    if (s.n_call==0) return;
+    if (n_call==0 || s.t_min<t_min) t_min = s.t_min;
+    if (n_call==0 || s.t_max>t_max) t_max = s.t_max;
+    t_total += s.t_total;
+    n_call += s.n_call;
+  }
+
+  void EvaluationStats::write(Dictionary& stats, const std::string& suffix) const {
+    stats["n_" + suffix] = n_call;
+    stats["t_" + suffix] = t_total;
+    stats["t_" + suffix + "_min"] = t_min;
+    stats["t_" + suffix + "_max"] = t_max;
+  }
+
   FunctionInternal::FunctionInternal() {
     setOption("name", "unnamed_function"); // name of the function
     addOption("verbose",                  OT_BOOLEAN,             false,
@@ -54,6 +92,17 @@ namespace casadi {
               "How to calculate the Jacobians.",
               "forward: only forward mode|reverse: only adjoint mode|automatic: "
               "a heuristic decides which is more appropriate");
+    addOption("symmetric_coloring",       OT_STRING,              "star",
+              "Graph coloring for symmetric Jacobians (Hessians).",
+              "star: star coloring, direct recovery|acyclic: acyclic coloring, "
+              "fewer directions, recovery by substitution");
+    addOption("sparsity_cache",           OT_STRING,              GenericType(),
+              "File for caching Jacobian sparsity patterns and seed matrices between runs. "
+              "Records are keyed by a hash of the structure of the algorithm.");
+    addOption("sparsity_threads",         OT_INTEGER,             1,
+              "Number of threads for the sweeps of the Jacobian sparsity detection, "
+              "0 for the number of hardware threads. Ignored for functions that "
+              "do not support concurrent propagation.");
     addOption("user_data",                OT_VOIDPTR,             GenericType(),
               "A user-defined field that can be used to identify "
               "the function or pass additional information");
@@ -65,12 +114,16 @@ namespace casadi {
               "Throw exceptions when the numerical values of the inputs don't make sense");
     addOption("gather_stats",             OT_BOOLEAN,             false,
               "Flag to indicate whether statistics must be gathered");
+    addOption("codegen_derivatives",      OT_BOOLEAN,             false,
+              "Also export forward and adjoint directional derivatives, the full Jacobian "
+              "and the Jacobian sparsity patterns in generated code");
     addOption("derivative_generator",     OT_DERIVATIVEGENERATOR,   GenericType(),
               "Function that returns a derivative function given a number of forward "
               "and reverse directional derivative, overrides internal routines. "
               "Check documentation of DerivativeGenerator.");
 
     verbose_ = false;
+    stats_bytes_in_ = stats_bytes_out_ = 0;
     user_data_ = 0;
     monitor_inputs_ = false;
     monitor_outputs_ = false;
@@ -87,7 +140,9 @@ namespace casadi {
         i!=derivative_fcn_.end(); ++i) {
       for (vector<WeakRef>::iterator j=i->begin(); j!=i->end(); ++j) {
         if (!j->isNull()) {
-          *j = getcopy(j->shared(), already_copied);
+          // Derivatives that were not copied are regenerated on demand
+          SharedObject temp = getcopy(j->shared(), already_copied);
+          *j = temp.isNull() ? WeakRef() : WeakRef(temp);
         }
       }
     }
@@ -111,6 +166,25 @@ namespace casadi {
         SparseStorage<Sparsity>(Sparsity::sparse(getNumOutputs(), getNumInputs()));
     jac_ = jac_compact_ = SparseStorage<WeakRef>(Sparsity::sparse(getNumOutputs(), getNumInputs()));
 
+    // On-disk cache for the sparsities
+    sparsity_cache_ = hasSetOption("sparsity_cache") ? getOption("sparsity_cache").toString() : "";
+    structural_hash_ = 0;
+
+    // Threads for the sparsity propagation
+    sparsity_threads_ = getOption("sparsity_threads");
+    casadi_assert_message(sparsity_threads_>=0, "Option \"sparsity_threads\" must be nonnegative");
+#ifdef USE_CXX11
+    if (sparsity_threads_==0) {
+      sparsity_threads_ = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+#else // USE_CXX11
+    if (sparsity_threads_!=1) {
+      casadi_warning("Option \"sparsity_threads\" requires CasADi to be compiled with C++11. "
+                     "Falling back to one thread.");
+      sparsity_threads_ = 1;
+    }
+#endif // USE_CXX11
+
     if (hasSetOption("user_data")) {
       user_data_ = getOption("user_data").toVoidPointer();
     }
@@ -127,6 +201,8 @@ namespace casadi {
     monitor_outputs_ = monitored("outputs");
 
     gather_stats_ = getOption("gather_stats");
+    stats_eval_ = stats_der_ = stats_sp_ = EvaluationStats();
+    stats_bytes_in_ = stats_bytes_out_ = 0;
 
     inputs_check_ = getOption("inputs_check");
 
@@ -201,6 +277,9 @@ namespace casadi {
 
     ret.setOutputScheme(ionames);
 
+    // Report evaluations of the gradient in the statistics of this function
+    if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
     return ret;
   }
 
@@ -230,6 +309,9 @@ namespace casadi {
 
     ret.setOutputScheme(ionames);
 
+    // Report evaluations of the tangent in the statistics of this function
+    if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
     return ret;
   }
 
@@ -261,6 +343,9 @@ namespace casadi {
 
     ret.setOutputScheme(ionames);
 
+    // Report evaluations of the Hessian in the statistics of this function
+    if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
     return ret;
   }
 
@@ -298,6 +383,10 @@ namespace casadi {
     log("FunctionInternal::getHessian generating gradient");
     Function g = gradient(iind, oind);
     g.setOption("verbose", getOption("verbose"));
+    g.setOption("symmetric_coloring", getOption("symmetric_coloring"));
+    if (hasSetOption("sparsity_cache")) {
+      g.setOption("sparsity_cache", getOption("sparsity_cache"));
+    }
     g.setInputScheme(input_.scheme);
     g.init();
 
@@ -327,15 +416,44 @@ namespace casadi {
   }
 
   const Dictionary & FunctionInternal::getStats() const {
+    if (gather_stats_) {
+      stats_eval_.write(stats_, "eval");
+      stats_der_.write(stats_, "eval_der");
+      stats_sp_.write(stats_, "eval_sp");
+      stats_["bytes_in"] = stats_bytes_in_;
+      stats_["bytes_out"] = stats_bytes_out_;
+
+      // Calls to other functions
+      Dictionary calls;
+      getCallStats(calls);
+      if (!calls.empty()) stats_["calls"] = calls;
+    }
     return stats_;
   }
 
+  void FunctionInternal::evaluateWithStats() {
+    if (!gather_stats_ && derivative_of_.isNull()) {
+      evaluate();
+      return;
+    }
+
+    double time_start = getStatsTime();
+    evaluate();
+    double t = getStatsTime() - time_start;
+    if (gather_stats_) stats_eval_.add(t);
+
+    // Report to the function that this is a derivative of
+    SharedObject f = derivative_of_.shared();
+    if (!f.isNull()) static_cast<FunctionInternal*>(f.get())->stats_der_.add(t);
+  }
+
   GenericType FunctionInternal::getStat(const string & name) const {
     // Locate the statistic
-    Dictionary::const_iterator it = stats_.find(name);
+    const Dictionary& stats = getStats();
+    Dictionary::const_iterator it = stats.find(name);
 
     // Check if found
-    if (it == stats_.end()) {
+    if (it == stats.end()) {
       casadi_error("Statistic: " << name << " has not been set." << endl <<
                    "Note: statistcs are only set after an evaluate call");
     }
@@ -343,6 +461,62 @@ namespace casadi {
     return GenericType(it->second);
   }
 
+  Dictionary FunctionInternal::getMemoryUsage() const {
+    Dictionary mem;
+    addMemoryUsage(mem);
+    double total = 0;
+    for (Dictionary::const_iterator it=mem.begin(); it!=mem.end(); ++it) {
+      total += it->second.toDouble();
+    }
+    mem["total"] = total;
+    return mem;
+  }
+
+  void FunctionInternal::addMemory(Dictionary& mem, const std::string& category, double bytes) {
+    Dictionary::iterator it = mem.find(category);
+    if (it==mem.end()) {
+      mem[category] = bytes;
+    } else {
+      it->second = it->second.toDouble() + bytes;
+    }
+  }
+
+  void FunctionInternal::addMemoryUsage(Dictionary& mem) const {
+    // Numerical inputs and outputs
+    double io = 0;
+    for (int i=0; i<input_.data.size(); ++i) io += vectorMemory(input_.data[i].data());
+    for (int i=0; i<output_.data.size(); ++i) io += vectorMemory(output_.data[i].data());
+    addMemory(mem, "io", io);
+
+    // Cached Jacobian sparsity patterns, these are shared through the sparsity cache
+    double jac_sp = 0;
+    for (int k=0; k<2; ++k) {
+      const SparseStorage<Sparsity>& cache = k==0 ? jac_sparsity_ : jac_sparsity_compact_;
+      for (vector<Sparsity>::const_iterator it=cache.data().begin();
+           it!=cache.data().end(); ++it) {
+        if (it->isNull()) continue;
+        jac_sp += vectorMemory(it->colind()) + vectorMemory(it->row());
+      }
+    }
+    addMemory(mem, "jac_sparsity", jac_sp);
+
+    // Cached derivative functions that are still alive
+    vector<WeakRef> cached(1, full_jacobian_);
+    for (vector<vector<WeakRef> >::const_iterator i=derivative_fcn_.begin();
+         i!=derivative_fcn_.end(); ++i) {
+      cached.insert(cached.end(), i->begin(), i->end());
+    }
+    cached.insert(cached.end(), jac_.data().begin(), jac_.data().end());
+    cached.insert(cached.end(), jac_compact_.data().begin(), jac_compact_.data().end());
+    double der = 0;
+    for (vector<WeakRef>::iterator it=cached.begin(); it!=cached.end(); ++it) {
+      if (it->isNull() || !it->alive()) continue;
+      Function f = shared_cast<Function>(it->shared());
+      if (!f.isNull()) der += f->getMemoryUsage()["total"].toDouble();
+    }
+    addMemory(mem, "derivatives", der);
+  }
+
   std::vector<MX> FunctionInternal::symbolicInput() const {
     vector<MX> ret(getNumInputs());
     assertInit();
@@ -389,6 +563,100 @@ namespace casadi {
   }
   /// \endcond
 
+#ifdef USE_CXX11
+  /// \cond INTERNAL
+  // Propagate the sweeps t, t+nthreads, ... using buffers local to the thread
+  static void spSweepsWorker(FunctionInternal* f, bool fwd, int iind, int oind,
+                             int t, int nthreads, const vector<vector<bvec_t> >* seed,
+                             vector<vector<bvec_t> >* sens, std::exception_ptr* err) {
+    try {
+      // Input and output buffers
+      vector<vector<bvec_t> > arg_buf(f->getNumInputs()), res_buf(f->getNumOutputs());
+      vector<bvec_t*> arg(arg_buf.size()), res(res_buf.size());
+      for (int ind=0; ind<arg.size(); ++ind) {
+        arg_buf[ind].resize(f->input(ind).size(), bvec_t(0));
+        arg[ind] = getPtr(arg_buf[ind]);
+      }
+      for (int ind=0; ind<res.size(); ++ind) {
+        res_buf[ind].resize(f->output(ind).size(), bvec_t(0));
+        res[ind] = getPtr(res_buf[ind]);
+      }
+
+      // Work vector
+      vector<bvec_t> w(f->spWorkSize(), bvec_t(0));
+
+      // Seeds and sensitivities
+      vector<bvec_t>& seed_v = fwd ? arg_buf[iind] : res_buf[oind];
+      vector<bvec_t>& sens_v = fwd ? res_buf[oind] : arg_buf[iind];
+
+      for (int s=t; s<seed->size(); s+=nthreads) {
+        copy((*seed)[s].begin(), (*seed)[s].end(), seed_v.begin());
+        f->spEvaluateBuffered(fwd, getPtr(arg), getPtr(res), getPtr(w));
+        (*sens)[s] = sens_v;
+
+        // Clear the seeds and sensitivities for the next sweep
+        fill(seed_v.begin(), seed_v.end(), bvec_t(0));
+        fill(sens_v.begin(), sens_v.end(), bvec_t(0));
+      }
+    } catch(...) {
+      *err = std::current_exception();
+    }
+  }
+  /// \endcond
+#endif // USE_CXX11
+
+  void FunctionInternal::spEvaluateBuffered(bool fwd, bvec_t** arg, bvec_t** res, bvec_t* w) {
+    casadi_error("FunctionInternal::spEvaluateBuffered not defined for class "
+                 << typeid(*this).name());
+  }
+
+  int FunctionInternal::spSweepsChunk() const {
+    // A few sweeps per thread, the seeds are stored densely
+    return sparsity_threads_>1 ? 4*sparsity_threads_ : 1;
+  }
+
+  void FunctionInternal::spSweeps(bool fwd, int iind, int oind,
+                                  const vector<vector<bvec_t> >& seed,
+                                  vector<vector<bvec_t> >& sens) {
+    sens.resize(seed.size());
+    double time_start = gather_stats_ ? getStatsTime() : 0;
+
+    // Propagate concurrently, if possible
+    int nthreads = std::min(sparsity_threads_, static_cast<int>(seed.size()));
+#ifdef USE_CXX11
+    if (nthreads>1 && spCanEvaluateConcurrently(fwd)) {
+      vector<std::thread> threads;
+      vector<std::exception_ptr> err(nthreads);
+      for (int t=0; t<nthreads; ++t) {
+        threads.push_back(std::thread(spSweepsWorker, this, fwd, iind, oind, t, nthreads,
+                                      &seed, &sens, &err[t]));
+      }
+      for (int t=0; t<nthreads; ++t) threads[t].join();
+      for (int t=0; t<nthreads; ++t) {
+        if (err[t]) std::rethrow_exception(err[t]);
+      }
+      if (gather_stats_) stats_sp_.add(getStatsTime() - time_start);
+      return;
+    }
+#endif // USE_CXX11
+
+    // Propagate one sweep at a time, using the inputs and outputs of the function
+    vector<double>& seed_d = fwd ? inputNoCheck(iind).data() : outputNoCheck(oind).data();
+    vector<double>& sens_d = fwd ? outputNoCheck(oind).data() : inputNoCheck(iind).data();
+    bvec_t* seed_v = get_bvec_t(seed_d);
+    bvec_t* sens_v = get_bvec_t(sens_d);
+    for (int s=0; s<seed.size(); ++s) {
+      copy(seed[s].begin(), seed[s].end(), seed_v);
+      spEvaluate(fwd);
+      sens[s].assign(sens_v, sens_v+sens_d.size());
+
+      // Clear the seeds and sensitivities for the next sweep
+      fill_n(seed_v, seed_d.size(), bvec_t(0));
+      fill_n(sens_v, sens_d.size(), bvec_t(0));
+    }
+    if (gather_stats_) stats_sp_.add(getStatsTime() - time_start);
+  }
+
   Sparsity FunctionInternal::getJacSparsityPlain(int iind, int oind) {
     // Number of nonzero inputs
     int nz_in = input(iind).size();
@@ -429,12 +697,6 @@ namespace casadi {
       if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
     }
 
-    // Get seeds and sensitivities
-    bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
-    bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
-    bvec_t* seed_v = use_fwd ? input_v : output_v;
-    bvec_t* sens_v = use_fwd ? output_v : input_v;
-
     // Number of sweeps needed
     int nsweep = use_fwd ? nsweep_fwd : nsweep_adj;
 
@@ -455,12 +717,18 @@ namespace casadi {
     // Temporary vectors
     std::vector<int> jcol, jrow;
 
+    // Number of sweeps propagated at once
+    int chunk = spSweepsChunk();
+
+    // Seeds and sensitivities of a chunk of sweeps
+    std::vector<std::vector<bvec_t> > seed, sens;
+
     // Loop over the variables, ndir variables at a time
-    for (int s=0; s<nsweep; ++s) {
+    for (int s0=0; s0<nsweep; s0+=chunk) {
 
       // Print progress
       if (verbose()) {
-        int progress_new = (s*100)/nsweep;
+        int progress_new = (s0*100)/nsweep;
         // Print when entering a new decade
         if (progress_new / 10 > progress / 10) {
           progress = progress_new;
@@ -468,50 +736,51 @@ namespace casadi {
         }
       }
 
-      // Nonzero offset
-      int offset = s*bvec_size;
+      // Set the seeds
+      seed.resize(std::min(chunk, nsweep-s0));
+      for (int s=0; s<seed.size(); ++s) {
+        seed[s].assign(nz_seed, bvec_t(0));
+
+        // Nonzero offset
+        int offset = (s0+s)*bvec_size;
 
-      // Number of local seed directions
-      int ndir_local = std::min(bvec_size, nz_seed-offset);
+        // Number of local seed directions
+        int ndir_local = std::min(bvec_size, nz_seed-offset);
 
-      for (int i=0; i<ndir_local; ++i) {
-        seed_v[offset+i] |= bvec_t(1)<<i;
+        for (int i=0; i<ndir_local; ++i) {
+          seed[s][offset+i] |= bvec_t(1)<<i;
+        }
       }
 
       // Propagate the dependencies
-      spEvaluate(use_fwd);
+      spSweeps(use_fwd, iind, oind, seed, sens);
 
-      // Loop over the nonzeros of the output
-      for (int el=0; el<nz_sens; ++el) {
+      for (int s=0; s<seed.size(); ++s) {
+        int offset = (s0+s)*bvec_size;
+        int ndir_local = std::min(bvec_size, nz_seed-offset);
 
-        // Get the sparsity sensitivity
-        bvec_t spsens = sens_v[el];
+        // Loop over the nonzeros of the output
+        for (int el=0; el<nz_sens; ++el) {
 
-        // Clear the sensitivities for the next sweep
-        if (!use_fwd) {
-          sens_v[el] = 0;
-        }
+          // Get the sparsity sensitivity
+          bvec_t spsens = sens[s][el];
 
-        // If there is a dependency in any of the directions
-        if (0!=spsens) {
+          // If there is a dependency in any of the directions
+          if (0!=spsens) {
 
-          // Loop over seed directions
-          for (int i=0; i<ndir_local; ++i) {
+            // Loop over seed directions
+            for (int i=0; i<ndir_local; ++i) {
 
-            // If dependents on the variable
-            if ((bvec_t(1) << i) & spsens) {
-              // Add to pattern
-              jcol.push_back(el);
-              jrow.push_back(i+offset);
+              // If dependents on the variable
+              if ((bvec_t(1) << i) & spsens) {
+                // Add to pattern
+                jcol.push_back(el);
+                jrow.push_back(i+offset);
+              }
             }
           }
         }
       }
-
-      // Remove the seeds
-      for (int i=0; i<bvec_size && offset+i<nz_seed; ++i) {
-        seed_v[offset+i] = 0;
-      }
     }
 
     // Set inputs and outputs to zero
@@ -568,6 +837,13 @@ namespace casadi {
 
     bool hasrun = false;
 
+    // Number of sweeps propagated at once
+    int chunk = spSweepsChunk();
+
+    // Seeds, sensitivities and lookup tables of the sweeps not yet propagated
+    std::vector<std::vector<bvec_t> > seed, sens;
+    std::vector<IMatrix> lookups;
+
     while (!hasrun || coarse.size()!=nz+1) {
       casadi_log("Block size: " << granularity);
 
@@ -585,14 +861,8 @@ namespace casadi {
       // Reset the virtual machine
       spInit(true);
 
-      // Get seeds and sensitivities
-      bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
-      bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
-      bvec_t* seed_v = input_v;
-      bvec_t* sens_v = output_v;
-
-      // Clear the seeds
-      for (int i=0; i<nz; ++i) seed_v[i]=0;
+      // Seeds of the current sweep
+      std::vector<bvec_t> seed_v(nz, bvec_t(0));
 
       // Subdivide the coarse block
       for (int k=0;k<coarse.size()-1;++k) {
@@ -658,7 +928,8 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(seed_v, fine[fci+fci_start], fine[fci+fci_start+1], bvec_i+bvec_i_mod);
+              bvec_toggle(getPtr(seed_v), fine[fci+fci_start], fine[fci+fci_start+1],
+                          bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
           }
@@ -686,52 +957,57 @@ namespace casadi {
             duplicates.makeSparse();
             lookup(duplicates.sparsity()) = -bvec_size;
 
+            // Store the sweep, ready for the next bvec sweep
+            seed.push_back(seed_v);
+            lookups.push_back(lookup);
+            fill(seed_v.begin(), seed_v.end(), bvec_t(0));
+
+            // Clean lookup table
+            lookup_col.clear();
+            lookup_row.clear();
+            lookup_value.clear();
+          }
+
+          // Propagate the stored sweeps if enough of them or if this was the last one
+          bool last = csd==D.size2()-1 && n_fine_blocks_max<=fci_cap;
+          if (seed.size()>=chunk || (last && !seed.empty())) {
+
             // Propagate the dependencies
-            spEvaluate(true);
-
-            // Temporary bit work vector
-            bvec_t spsens;
-
-            // Loop over the cols of coarse blocks
-            for (int cri=0;cri<coarse.size()-1;++cri) {
-
-              // Loop over the cols of fine blocks within the current coarse block
-              for (int fri=fine_lookup[coarse[cri]];fri<fine_lookup[coarse[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine[fri], fine[fri+1]);
-
-                // Loop over all bvec_bits
-                for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & (bvec_t(1) << bvec_i)) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    int lk = lookup.elem(bvec_i, cri);
-                    if (lk>-bvec_size) {
-                      jrow.push_back(bvec_i+lk);
-                      jcol.push_back(fri);
-                      jrow.push_back(fri);
-                      jcol.push_back(bvec_i+lk);
+            spSweeps(true, iind, oind, seed, sens);
+
+            for (int s=0; s<seed.size(); ++s) {
+              const IMatrix& lookup = lookups[s];
+              bvec_t* sens_v = getPtr(sens[s]);
+
+              // Temporary bit work vector
+              bvec_t spsens;
+
+              // Loop over the cols of coarse blocks
+              for (int cri=0;cri<coarse.size()-1;++cri) {
+
+                // Loop over the cols of fine blocks within the current coarse block
+                for (int fri=fine_lookup[coarse[cri]];fri<fine_lookup[coarse[cri+1]];++fri) {
+                  // Lump individual sensitivities together into fine block
+                  bvec_or(sens_v, spsens, fine[fri], fine[fri+1]);
+
+                  // Loop over all bvec_bits
+                  for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                    if (spsens & (bvec_t(1) << bvec_i)) {
+                      // if dependency is found, add it to the new sparsity pattern
+                      int lk = lookup.elem(bvec_i, cri);
+                      if (lk>-bvec_size) {
+                        jrow.push_back(bvec_i+lk);
+                        jcol.push_back(fri);
+                        jrow.push_back(fri);
+                        jcol.push_back(bvec_i+lk);
+                      }
                     }
                   }
                 }
               }
             }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumInputs(); ++ind) {
-              vector<double> &v = inputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumOutputs(); ++ind) {
-              vector<double> &v = outputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
-
-            // Clean lookup table
-            lookup_col.clear();
-            lookup_row.clear();
-            lookup_value.clear();
+            seed.clear();
+            lookups.clear();
           }
 
           if (n_fine_blocks_max>fci_cap) {
@@ -814,6 +1090,13 @@ namespace casadi {
       bvec_lookup.push_back(bvec_t(1) << i);
     }
 
+    // Number of sweeps propagated at once
+    int chunk = spSweepsChunk();
+
+    // Seeds, sensitivities and lookup tables of the sweeps not yet propagated
+    std::vector<std::vector<bvec_t> > seed, sens;
+    std::vector<IMatrix> lookups;
+
     while (!hasrun || coarse_col.size()!=nz_out+1 || coarse_row.size()!=nz_in+1) {
       casadi_log("Block size: " << granularity_col << " x " << granularity_row);
 
@@ -867,18 +1150,12 @@ namespace casadi {
       // Reset the virtual machine
       spInit(use_fwd);
 
-      // Get seeds and sensitivities
-      bvec_t* input_v = get_bvec_t(inputNoCheck(iind).data());
-      bvec_t* output_v = get_bvec_t(outputNoCheck(oind).data());
-      bvec_t* seed_v = use_fwd ? input_v : output_v;
-      bvec_t* sens_v = use_fwd ? output_v : input_v;
-
       // The number of zeros in the seed and sensitivity directions
       int nz_seed = use_fwd ? nz_in  : nz_out;
       int nz_sens = use_fwd ? nz_out : nz_in;
 
-      // Clear the seeds
-      for (int i=0; i<nz_seed; ++i) seed_v[i]=0;
+      // Seeds of the current sweep
+      std::vector<bvec_t> seed_v(nz_seed, bvec_t(0));
 
       // Choose the active jacobian coloring scheme
       Sparsity D = use_fwd ? D1 : D2;
@@ -964,7 +1241,7 @@ namespace casadi {
               }
 
               // Toggle on seeds
-              bvec_toggle(seed_v, fine_row[fci+fci_start], fine_row[fci+fci_start+1],
+              bvec_toggle(getPtr(seed_v), fine_row[fci+fci_start], fine_row[fci+fci_start+1],
                           bvec_i+bvec_i_mod);
               bvec_i_mod++;
             }
@@ -980,55 +1257,57 @@ namespace casadi {
             // Statistics
             nsweeps+=1;
 
-            // Construct lookup table
-            IMatrix lookup = IMatrix::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
-                                              coarse_col.size());
+            // Store the sweep along with its lookup table, ready for the next bvec sweep
+            seed.push_back(seed_v);
+            lookups.push_back(IMatrix::triplet(lookup_row, lookup_col, lookup_value, bvec_size,
+                                               coarse_col.size()));
+            fill(seed_v.begin(), seed_v.end(), bvec_t(0));
+
+            // Clean lookup table
+            lookup_col.clear();
+            lookup_row.clear();
+            lookup_value.clear();
+          }
+
+          // Propagate the stored sweeps if enough of them or if this was the last one
+          bool last = csd==D.size2()-1 && n_fine_blocks_max<=fci_cap;
+          if (seed.size()>=chunk || (last && !seed.empty())) {
 
             // Propagate the dependencies
-            spEvaluate(use_fwd);
+            spSweeps(use_fwd, iind, oind, seed, sens);
+
+            for (int s=0; s<seed.size(); ++s) {
+              const IMatrix& lookup = lookups[s];
+              bvec_t* sens_v = getPtr(sens[s]);
 
-            // Temporary bit work vector
-            bvec_t spsens;
+              // Temporary bit work vector
+              bvec_t spsens;
 
-            // Loop over the cols of coarse blocks
-            for (int cri=0;cri<coarse_col.size()-1;++cri) {
+              // Loop over the cols of coarse blocks
+              for (int cri=0;cri<coarse_col.size()-1;++cri) {
 
-              // Loop over the cols of fine blocks within the current coarse block
-              for (int fri=fine_col_lookup[coarse_col[cri]];
-                   fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
-                // Lump individual sensitivities together into fine block
-                bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
+                // Loop over the cols of fine blocks within the current coarse block
+                for (int fri=fine_col_lookup[coarse_col[cri]];
+                     fri<fine_col_lookup[coarse_col[cri+1]];++fri) {
+                  // Lump individual sensitivities together into fine block
+                  bvec_or(sens_v, spsens, fine_col[fri], fine_col[fri+1]);
 
-                // Next iteration if no sparsity
-                if (!spsens) continue;
+                  // Next iteration if no sparsity
+                  if (!spsens) continue;
 
-                // Loop over all bvec_bits
-                for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
-                  if (spsens & bvec_lookup[bvec_i]) {
-                    // if dependency is found, add it to the new sparsity pattern
-                    jrow.push_back(bvec_i+lookup.elem(bvec_i, cri));
-                    jcol.push_back(fri);
+                  // Loop over all bvec_bits
+                  for (int bvec_i=0;bvec_i<bvec_size;++bvec_i) {
+                    if (spsens & bvec_lookup[bvec_i]) {
+                      // if dependency is found, add it to the new sparsity pattern
+                      jrow.push_back(bvec_i+lookup.elem(bvec_i, cri));
+                      jcol.push_back(fri);
+                    }
                   }
                 }
               }
             }
-
-            // Clear the forward seeds/adjoint sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumInputs(); ++ind) {
-              vector<double> &v = inputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
-
-            // Clear the adjoint seeds/forward sensitivities, ready for next bvec sweep
-            for (int ind=0; ind<getNumOutputs(); ++ind) {
-              vector<double> &v = outputNoCheck(ind).data();
-              if (!v.empty()) fill_n(get_bvec_t(v), v.size(), bvec_t(0));
-            }
-
-            // Clean lookup table
-            lookup_col.clear();
-            lookup_row.clear();
-            lookup_value.clear();
+            seed.clear();
+            lookups.clear();
           }
 
           if (n_fine_blocks_max>fci_cap) {
@@ -1104,8 +1383,19 @@ namespace casadi {
     if (jsp.isNull()) {
       if (compact) {
 
-        // Use internal routine to determine sparsity
-        jsp = getJacSparsity(iind, oind, symmetric);
+        // Look up in the on-disk cache
+        SparsityCache::Fingerprint fp = sparsityCacheFingerprint(0, iind, oind, true, symmetric);
+        vector<Sparsity> rec;
+        if (!fp.empty() && SparsityCache::lookup(sparsity_cache_, fp, rec) && rec.size()==1
+            && (rec[0].isNull() || (rec[0].size1()==output(oind).size()
+                                    && rec[0].size2()==input(iind).size()))) {
+          log("FunctionInternal::jacSparsity", "read from sparsity cache");
+          jsp = rec[0];
+        } else {
+          // Use internal routine to determine sparsity
+          jsp = getJacSparsity(iind, oind, symmetric);
+          if (!fp.empty()) SparsityCache::store(sparsity_cache_, fp, vector<Sparsity>(1, jsp));
+        }
 
       } else {
 
@@ -1157,6 +1447,19 @@ namespace casadi {
 
     // Sparsity pattern with transpose
     Sparsity &AT = jacSparsity(iind, oind, compact, symmetric);
+
+    // Look up in the on-disk cache
+    SparsityCache::Fingerprint fp = sparsityCacheFingerprint(1, iind, oind, compact, symmetric);
+    vector<Sparsity> rec;
+    if (!fp.empty() && SparsityCache::lookup(sparsity_cache_, fp, rec) && rec.size()==2
+        && (rec[0].isNull() || rec[0].size1()==AT.size2())
+        && (rec[1].isNull() || rec[1].size1()==AT.size1())) {
+      log("FunctionInternal::getPartition read from sparsity cache");
+      D1 = rec[0];
+      D2 = rec[1];
+      return;
+    }
+
     Sparsity A = symmetric ? AT : AT.T();
 
     // Which AD mode?
@@ -1173,11 +1476,26 @@ namespace casadi {
     // Get seed matrices by graph coloring
     if (symmetric) {
 
-      // Star coloring if symmetric
-      log("FunctionInternal::getPartition starColoring");
-      D1 = A.starColoring();
-      casadi_log("Star coloring completed: " << D1.size2() << " directional derivatives needed ("
-                 << A.size1() << " without coloring).");
+      if (getOption("symmetric_coloring") == "acyclic") {
+        // Acyclic coloring, recovery by substitution. A star coloring is also acyclic
+        // and is kept if the greedy acyclic coloring does not improve on it
+        log("FunctionInternal::getPartition acyclicColoring");
+        D1 = A.starColoring();
+        Sparsity D1_acyclic = A.acyclicColoring(1, D1.size2()-1);
+        if (!D1_acyclic.isNull()) D1 = D1_acyclic;
+        casadi_log("Acyclic coloring completed: " << D1.size2()
+                   << " directional derivatives needed (" << A.size1() << " without coloring).");
+      } else if (getOption("symmetric_coloring") == "star") {
+        // Star coloring, direct recovery
+        log("FunctionInternal::getPartition starColoring");
+        D1 = A.starColoring();
+        casadi_log("Star coloring completed: " << D1.size2() << " directional derivatives needed ("
+                   << A.size1() << " without coloring).");
+      } else {
+        casadi_error("FunctionInternal::jac: Unknown symmetric_coloring \""
+                     << getOption("symmetric_coloring")
+                     << "\". Possible values are \"star\" and \"acyclic\".");
+      }
 
     } else {
 
@@ -1231,10 +1549,70 @@ namespace casadi {
         }
       }
 
+      // Combine forward and adjoint directions if cheaper than either mode alone
+      if (test_ad_fwd && test_ad_adj) {
+        log("FunctionInternal::getPartition bidirectional coloring");
+        int best_cost = D1.isNull() ? adj_penalty*D2.size2() : D1.size2();
+        Sparsity D1_bi, D2_bi;
+        if (AT.bidirectionalColoring(A, D1_bi, D2_bi, adj_penalty, best_cost)) {
+          D1 = D1_bi;
+          D2 = D2_bi;
+          if (verbose()) cout << "Bidirectional coloring completed: "
+                             << (D1.isNull() ? 0 : D1.size2()) << " forward and "
+                             << D2.size2() << " adjoint directional derivatives needed."
+                             << endl;
+        }
+      }
+    }
+
+    // Save in the on-disk cache
+    if (!fp.empty()) {
+      rec.resize(2);
+      rec[0] = D1;
+      rec[1] = D2;
+      SparsityCache::store(sparsity_cache_, fp, rec);
     }
     log("FunctionInternal::getPartition end");
   }
 
+  SparsityCache::Fingerprint
+  FunctionInternal::sparsityCacheFingerprint(int type, int iind, int oind, bool compact,
+                                             bool symmetric) {
+    SparsityCache::Fingerprint fp;
+    if (sparsity_cache_.empty()) return fp;
+
+    // Structure of the algorithm
+    if (structural_hash_==0) structural_hash_ = getStructuralHash();
+    if (structural_hash_==0) return fp;
+    fp.push_back(structural_hash_);
+    fp.push_back(getAlgorithmSize());
+
+    // Record
+    fp.push_back(type);
+    fp.push_back(iind);
+    fp.push_back(oind);
+    fp.push_back(compact);
+    fp.push_back(symmetric);
+
+    // Options affecting the seed matrices
+    string opts = getOption("ad_mode").toString() + ","
+        + getOption("symmetric_coloring").toString();
+    size_t h = 0;
+    for (string::const_iterator c=opts.begin(); c!=opts.end(); ++c) hash_combine(h, *c);
+    fp.push_back(h);
+
+    // Input and output sparsities
+    for (int i=0; i<getNumInputs()+getNumOutputs(); ++i) {
+      const Sparsity& sp = i<getNumInputs() ? input(i).sparsity()
+          : output(i-getNumInputs()).sparsity();
+      fp.push_back(sp.size1());
+      fp.push_back(sp.size2());
+      fp.push_back(sp.size());
+      fp.push_back(sp.hash());
+    }
+    return fp;
+  }
+
   void FunctionInternal::evalSX(const std::vector<SX>& arg, std::vector<SX>& res,
                                 const std::vector<std::vector<SX> >& fseed,
                                 std::vector<std::vector<SX> >& fsens,
@@ -1534,6 +1912,9 @@ namespace casadi {
       }
       ret.setOutputScheme(ionames);
 
+      // Report evaluations of the Jacobian in the statistics of this function
+      if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
       // Save in cache
       compact ? jac_compact_.elem(oind, iind) : jac_.elem(oind, iind) = ret;
       return ret;
@@ -1719,6 +2100,9 @@ namespace casadi {
       }
     }
 
+    // Report evaluations of the derivative in the statistics of this function
+    if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
     // Save to cache
     derivative_fcn_[nfwd][nadj] = ret;
 
@@ -1987,6 +2371,9 @@ namespace casadi {
       // Initialize
       ret.init();
 
+      // Report evaluations of the Jacobian in the statistics of this function
+      if (gather_stats_) ret->derivative_of_ = shared_from_this<Function>();
+
       // Return and cache it for reuse
       full_jacobian_ = ret;
       return ret;
@@ -2087,6 +2474,11 @@ namespace casadi {
   }
 
   void FunctionInternal::generateCode(std::ostream &cfile, bool generate_main) {
+    generateCode(cfile, generate_main, 0);
+  }
+
+  void FunctionInternal::generateCode(std::ostream &cfile, bool generate_main,
+                                      std::vector<std::string>* units) {
     assertInit();
 
     // set stream parameters
@@ -2109,32 +2501,22 @@ namespace casadi {
     // Generate the actual function
     generateFunction(gen.function_, "evaluate", "const d*", "d*", "d", gen);
 
-    // Flush the code generator
-    gen.flush(cfile);
-
     // Define wrapper function
-    cfile << "int evaluateWrap(const d** x, d** r) {" << std::endl;
-    cfile << "  evaluate(";
+    std::stringstream wrappers;
+    generateWrapper(wrappers, "evaluate");
 
-    // Number of inputs/outputs
-    int n_i = input_.data.size();
-    int n_o = output_.data.size();
-
-    // Pass inputs
-    for (int i=0; i<n_i; ++i) {
-      if (i!=0) cfile << ", ";
-      cfile << "x[" << i << "]";
+    // Generate derivative kernels, if requested
+    if (getOption("codegen_derivatives")) {
+      generateDerivatives(gen, wrappers);
     }
 
-    // Pass outputs
-    for (int i=0; i<n_o; ++i) {
-      if (i+n_i!= 0) cfile << ", ";
-      cfile << "r[" << i << "]";
+    // Flush the code generator
+    if (units) {
+      gen.flush(cfile, *units);
+    } else {
+      gen.flush(cfile);
     }
-
-    cfile << "); " << std::endl;
-    cfile << "  return 0;" << std::endl;
-    cfile << "}" << std::endl << std::endl;
+    cfile << wrappers.str();
 
     // Create a main for debugging and profiling: TODO: Cleanup and expose to user, see #617
     if (generate_main) {
@@ -2247,7 +2629,83 @@ namespace casadi {
                  << typeid(*this).name());
   }
 
-  void FunctionInternal::generateIO(CodeGenerator& gen) {
+  void FunctionInternal::generateWrapper(std::ostream &stream, const std::string& fname,
+                                         const std::string& prefix) const {
+    stream << "int " << prefix << "evaluateWrap(const d** x, d** r) {" << std::endl;
+    stream << "  " << fname << "(";
+
+    // Number of inputs/outputs
+    int n_i = input_.data.size();
+    int n_o = output_.data.size();
+
+    // Pass inputs
+    for (int i=0; i<n_i; ++i) {
+      if (i!=0) stream << ", ";
+      stream << "x[" << i << "]";
+    }
+
+    // Pass outputs
+    for (int i=0; i<n_o; ++i) {
+      if (i+n_i!= 0) stream << ", ";
+      stream << "r[" << i << "]";
+    }
+
+    stream << "); " << std::endl;
+    stream << "  return 0;" << std::endl;
+    stream << "}" << std::endl << std::endl;
+  }
+
+  void FunctionInternal::generateDerivatives(CodeGenerator& gen, std::ostream &wrappers) {
+    // Kernels to be exported: one forward direction, one adjoint direction, full Jacobian
+    std::vector<std::pair<std::string, Function> > kernels;
+    kernels.push_back(std::make_pair(std::string("fwd_"), derivative(1, 0)));
+    kernels.push_back(std::make_pair(std::string("adj_"), derivative(0, 1)));
+    kernels.push_back(std::make_pair(std::string("jac_"), fullJacobian()));
+
+    for (int k=0; k<kernels.size(); ++k) {
+      Function& f = kernels[k].second;
+      if (!f.isInit()) f.init();
+
+      // Generate the kernel itself and its interface
+      int ind = gen.addDependency(f);
+      f->generateIO(gen, kernels[k].first);
+      f->generateWrapper(wrappers, "f" + CodeGenerator::numToString(ind), kernels[k].first);
+    }
+
+    // Sparsity patterns of the compact Jacobian blocks
+    int n_i = input_.data.size();
+    int n_o = output_.data.size();
+    std::vector<int> jac_sparsity_index(n_i*n_o);
+    for (int oind=0; oind<n_o; ++oind) {
+      for (int iind=0; iind<n_i; ++iind) {
+        jac_sparsity_index[iind + oind*n_i] = gen.addSparsity(jacSparsity(iind, oind, true, false));
+      }
+    }
+
+    // Function that returns the sparsity pattern of a Jacobian block
+    stringstream &s = gen.function_;
+    s << "int getJacSparsity(int iind, int oind, int *nrow, int *ncol, "
+      << "int **colind, int **row) {" << endl;
+    s << "  int* sp;" << endl;
+    s << "  if (iind<0 || iind>=" << n_i << " || oind<0 || oind>=" << n_o << ") return 1;" << endl;
+    s << "  switch (iind + oind*" << n_i << ") {" << endl;
+    for (int i=0; i<jac_sparsity_index.size(); ++i) {
+      s << "    case " << i << ": sp = s" << jac_sparsity_index[i] << "; break;" << endl;
+    }
+    s << "    default:" << endl;
+    s << "      return 1;" << endl;
+    s << "  }" << endl << endl;
+
+    // Decompress the sparsity pattern
+    s << "  *nrow = sp[0];" << endl;
+    s << "  *ncol = sp[1];" << endl;
+    s << "  *colind = sp + 2;" << endl;
+    s << "  *row = sp + 2 + (*ncol + 1);" << endl;
+    s << "  return 0;" << endl;
+    s << "}" << endl << endl;
+  }
+
+  void FunctionInternal::generateIO(CodeGenerator& gen, const std::string& prefix) {
     // Short-hands
     int n_i = input_.data.size();
     int n_o = output_.data.size();
@@ -2255,7 +2713,7 @@ namespace casadi {
     stringstream &s = gen.function_;
 
     // Function that returns the number of inputs and outputs
-    s << "int init(int *n_in, int *n_out) {" << endl;
+    s << "int " << prefix << "init(int *n_in, int *n_out) {" << endl;
     s << "  *n_in = " << n_i << ";" << endl;
     s << "  *n_out = " << n_o << ";" << endl;
     s << "  return 0;" << endl;
@@ -2282,7 +2740,8 @@ namespace casadi {
     }
 
     // Function that returns the sparsity pattern
-    s << "int getSparsity(int i, int *nrow, int *ncol, int **colind, int **row) {" << endl;
+    s << "int " << prefix << "getSparsity(int i, int *nrow, int *ncol, "
+      << "int **colind, int **row) {" << endl;
 
     // Get the sparsity index using a switch
     s << "  int* sp;" << endl;
@@ -2334,36 +2793,89 @@ namespace casadi {
 
     // Filenames
     string cname = fname + ".c";
-    string dlname = fname + ".so";
-
-    // Remove existing files, if any
-    string rm_command = "rm -rf " + cname + " " + dlname;
-    int flag = system(rm_command.c_str());
-    casadi_assert_message(flag==0, "Failed to remove old source");
+    string dlname = "./" + fname + ".so";
+
+    // Cache directory, if any
+    const string& cache_dir = CasadiOptions::codegen_cache_dir;
+
+    // Generate the code in memory, possibly split into several translation units
+    vector<string> units;
+    stringstream srcstream;
+    f->generateCode(srcstream, false, &units);
+    string src = srcstream.str();
+    if (verbose_ && !units.empty()) {
+      cout << "Split " << fdescr << " into " << units.size() << " additional translation units"
+           << endl;
+    }
+
+    if (cache_dir.empty()) {
+      // Remove existing files, if any
+      string rm_command = "rm -rf " + cname + " " + dlname;
+      int flag = system(rm_command.c_str());
+      casadi_assert_message(flag==0, "Failed to remove old source");
+
+      // Write it
+      std::ofstream cfile(cname.c_str());
+      cfile << src;
+      cfile.close();
+      if (verbose_) {
+        cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
+      }
 
-    // Codegen it
-    f.generateCode(cname);
-    if (verbose_) {
-      cout << "Generated c-code for " << fdescr << " (" << cname << ")" << endl;
-    }
+      // Compile it
+      compileCode(cname, units, dlname, fdescr, compiler, dlflag);
+    } else {
+      // Key the cache entry by the contents, the compiler and the flags
+      string key = src;
+      for (vector<string>::const_iterator it=units.begin(); it!=units.end(); ++it) key += *it;
+      key += "\n" + compiler + " " + dlflag;
+      size_t h = 0;
+      for (string::const_iterator it=key.begin(); it!=key.end(); ++it) hash_combine(h, *it);
+      stringstream ss;
+      ss << cache_dir << "/" << fname << "_" << std::hex << h;
+      cname = ss.str() + ".c";
+      dlname = ss.str() + ".so";
+
+      // The source is stored alongside the shared object to rule out hash collisions
+      std::ifstream cached(cname.c_str());
+      stringstream cached_src;
+      cached_src << cached.rdbuf();
+      if (cached.is_open() && cached_src.str()==src && std::ifstream(dlname.c_str()).good()) {
+        if (verbose_) {
+          cout << "Found " << fdescr << " in cache (" << dlname << ")" << endl;
+        }
+      } else {
+        // Work on files private to this process
+        stringstream tmp;
+        tmp << ss.str() << "_" << getpid();
+        string tmp_cname = tmp.str() + ".c";
+        string tmp_dlname = tmp.str() + ".so";
+        std::ofstream cfile(tmp_cname.c_str());
+        cfile << src;
+        cfile.close();
+        casadi_assert_message(cfile.good(), "Failed to write " << tmp_cname);
+        if (verbose_) {
+          cout << "Generated c-code for " << fdescr << " (" << tmp_cname << ")" << endl;
+        }
 
-    // Compile it
-    string compile_command = compiler + " " + dlflag + " " + cname + " -o " + dlname;
-    if (verbose_) {
-      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
-    }
+        // Compile it, the additional translation units are not kept
+        compileCode(tmp_cname, units, tmp_dlname, fdescr, compiler, dlflag);
+        for (int k=0; k<units.size(); ++k) {
+          string uname = tmp.str() + "_" + CodeGenerator::numToString(k);
+          remove((uname + ".c").c_str());
+          remove((uname + ".o").c_str());
+        }
 
-    time_t time1 = time(0);
-    flag = system(compile_command.c_str());
-    time_t time2 = time(0);
-    double comp_time = difftime(time2, time1);
-    casadi_assert_message(flag==0, "Compilation failed");
-    if (verbose_) {
-      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+        // Move into place atomically, the source last as it marks the entry as complete
+        int flag = rename(tmp_dlname.c_str(), dlname.c_str());
+        casadi_assert_message(flag==0, "Failed to move " << tmp_dlname << " to " << dlname);
+        flag = rename(tmp_cname.c_str(), cname.c_str());
+        casadi_assert_message(flag==0, "Failed to move " << tmp_cname << " to " << cname);
+      }
     }
 
     // Load it
-    ExternalFunction f_gen("./" + dlname);
+    ExternalFunction f_gen(dlname);
     f_gen.setOption("name", fname + "_gen");
 
     // Initialize it if f was initialized
@@ -2380,6 +2892,57 @@ namespace casadi {
 #endif // WITH_DL
   }
 
+  void FunctionInternal::compileCode(const std::string& cname,
+                                     const std::vector<std::string>& units,
+                                     const std::string& dlname, const std::string& fdescr,
+                                     const std::string& compiler, const std::string& dlflag) {
+#ifdef WITH_DL
+    time_t time1 = time(0);
+
+    // Write the additional translation units next to the main file
+    string base = cname.substr(0, cname.size()-2);
+    vector<string> objects(units.size());
+    for (int k=0; k<units.size(); ++k) {
+      string uname = base + "_" + CodeGenerator::numToString(k);
+      std::ofstream ufile((uname + ".c").c_str());
+      ufile << units[k];
+      ufile.close();
+      casadi_assert_message(ufile.good(), "Failed to write " << uname << ".c");
+      objects[k] = uname + ".o";
+    }
+
+    // Compile them to object files, in parallel if possible
+    vector<int> flags(units.size(), 0);
+#ifdef WITH_OPENMP
+#pragma omp parallel for
+#endif // WITH_OPENMP
+    for (int k=0; k<units.size(); ++k) {
+      string uname = base + "_" + CodeGenerator::numToString(k);
+      string unit_command = compiler + " -c " + uname + ".c -o " + objects[k];
+      flags[k] = system(unit_command.c_str());
+    }
+    for (int k=0; k<units.size(); ++k) {
+      casadi_assert_message(flags[k]==0, "Compilation of translation unit " << k << " failed");
+    }
+
+    // Compile the main file and link
+    string compile_command = compiler + " " + dlflag + " " + cname;
+    for (int k=0; k<objects.size(); ++k) compile_command += " " + objects[k];
+    compile_command += " -o " + dlname;
+    if (verbose_) {
+      cout << "Compiling " << fdescr <<  " using \"" << compile_command << "\"" << endl;
+    }
+
+    int flag = system(compile_command.c_str());
+    time_t time2 = time(0);
+    double comp_time = difftime(time2, time1);
+    casadi_assert_message(flag==0, "Compilation failed");
+    if (verbose_) {
+      cout << "Compiled " << fdescr << " (" << dlname << ") in " << comp_time << " s."  << endl;
+    }
+#endif // WITH_DL
+  }
+
   void FunctionInternal::createCall(const std::vector<MX> &arg,
                           std::vector<MX> &res, const std::vector<std::vector<MX> > &fseed,
                           std::vector<std::vector<MX> > &fsens,
@@ -2546,12 +3109,14 @@ namespace casadi {
     }
 
     // Propagate seeds
+    double time_start = gather_stats_ ? getStatsTime() : 0;
     spInit(use_fwd); // NOTE: should only be done once
     if (spCanEvaluate(use_fwd)) {
       spEvaluate(use_fwd);
     } else {
       spEvaluateViaJacSparsity(use_fwd);
     }
+    if (gather_stats_) stats_sp_.add(getStatsTime() - time_start);
 
     // Get the sensitivities
     if (use_fwd) {
@@ -2670,13 +3235,14 @@ namespace casadi {
   void FunctionInternal::evaluateD(MXNode* node, const DMatrixPtrV& arg, DMatrixPtrV& res,
                                    std::vector<int>& itmp, std::vector<double>& rtmp) {
 
-    // Set up timers for profiling
+    // Set up timers for text profiling, binary profiling is done by the callee
+    bool profiling_text = CasadiOptions::profiling && !CasadiOptions::profilingBinary;
     double time_zero=0;
     double time_start=0;
     double time_stop=0;
     double time_offset=0;
 
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_start = getRealTime(); // Start timer
     }
 
@@ -2694,13 +3260,13 @@ namespace casadi {
       }
     }
 
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_zero = getRealTime();
     }
 
     // Evaluate
-    evaluate();
-    if (CasadiOptions::profiling) {
+    evaluateWithStats();
+    if (profiling_text) {
       time_offset += getRealTime() - time_zero;
     }
 
@@ -2710,15 +3276,11 @@ namespace casadi {
     }
 
     // Write out profiling information
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_stop = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-
-      } else {
-        CasadiOptions::profilingLog
-            << "overhead " << this << ":" <<getOption("name") << "|"
-            << (time_stop-time_start-time_offset)*1e6 << " ns" << std::endl;
-      }
+      CasadiOptions::profilingLog
+        << "overhead " << this << ":" <<getOption("name") << "|"
+        << (time_stop-time_start-time_offset)*1e6 << " ns" << std::endl;
     }
   }
 
@@ -45,6 +45,31 @@ namespace casadi {
 
   class MXFunction;
 
+  /// Wall time in seconds for the evaluation statistics, processor time without C++11
+  CASADI_EXPORT double getStatsTime();
+
+  /** \brief Call count and wall time of one kind of evaluation of a function */
+  struct CASADI_EXPORT EvaluationStats {
+    EvaluationStats() : n_call(0), t_total(0), t_min(0), t_max(0) {}
+
+    /// Record a call that took t seconds
+    void add(double t) {
+      if (n_call==0 || t<t_min) t_min = t;
+      if (n_call==0 || t>t_max) t_max = t;
+      t_total += t;
+      n_call++;
+    }
+
+    /// Add the calls recorded in another instance
+    void add(const EvaluationStats& s);
+
+    /// Write as n_<suffix>, t_<suffix>, t_<suffix>_min and t_<suffix>_max
+    void write(Dictionary& stats, const std::string& suffix) const;
+
+    int n_call;
+    double t_total, t_min, t_max;
+  };
+
   /** \brief Internal class for Function
       \author Joel Andersson
       \date 2010
@@ -68,6 +93,9 @@ namespace casadi {
     /** \brief  Evaluate */
     virtual void evaluate() = 0;
 
+    /** \brief  Evaluate, recording the call in the statistics if gather_stats is set */
+    void evaluateWithStats();
+
     /** \brief  Obtain solver name from Adaptor */
     virtual std::string getAdaptorSolverName() const { return ""; }
 
@@ -92,6 +120,24 @@ namespace casadi {
     /** \brief  Reset the sparsity propagation */
     virtual void spInit(bool fwd) {}
 
+    /** \brief  Can the sparsity be propagated concurrently with spEvaluateBuffered? */
+    virtual bool spCanEvaluateConcurrently(bool fwd) { return false;}
+
+    /** \brief  Size of the work vector needed by spEvaluateBuffered */
+    virtual int spWorkSize() const { return 0;}
+
+    /** \brief  Propagate the sparsity pattern using external input, output and work buffers
+        Must not modify the class, so that several threads can propagate at once */
+    virtual void spEvaluateBuffered(bool fwd, bvec_t** arg, bvec_t** res, bvec_t* w);
+
+    /** \brief  Propagate a set of seed vectors through the input iind (forward)
+        or output oind (reverse) and collect the sensitivities */
+    void spSweeps(bool fwd, int iind, int oind, const std::vector<std::vector<bvec_t> >& seed,
+                  std::vector<std::vector<bvec_t> >& sens);
+
+    /** \brief  Number of sweeps that spSweeps is given at once */
+    int spSweepsChunk() const;
+
     /** \brief  Evaluate symbolically, SXElement type, possibly nonmatching sparsity patterns */
     virtual void evalSX(const std::vector<SX>& arg, std::vector<SX>& res,
                         const std::vector<std::vector<SX> >& fseed,
@@ -217,8 +263,24 @@ namespace casadi {
     /** \brief  Print to a stream */
     virtual void generateCode(std::ostream &cfile, bool generate_main);
 
+    /** \brief  Print to a stream, functions split off by the code generator are returned
+     * as separate translation units if \a units is not null */
+    void generateCode(std::ostream &cfile, bool generate_main, std::vector<std::string>* units);
+
     /** \brief Generate code for function inputs and outputs */
-    void generateIO(CodeGenerator& gen);
+    void generateIO(CodeGenerator& gen, const std::string& prefix="");
+
+    /** \brief Generate the evaluation wrapper calling the generated function \a fname */
+    void generateWrapper(std::ostream &stream, const std::string& fname,
+                         const std::string& prefix="") const;
+
+    /** \brief Generate derivative kernels and the Jacobian sparsity patterns
+     *
+     * Exported with the prefixes "fwd_" (one forward direction), "adj_" (one adjoint direction)
+     * and "jac_" (full Jacobian), each with the same interface as the function itself.
+     * The compact Jacobian blocks are exported through "getJacSparsity".
+     */
+    void generateDerivatives(CodeGenerator& gen, std::ostream &wrappers);
 
     /** \brief Generate code the function */
     virtual void generateFunction(std::ostream &stream, const std::string& fname,
@@ -263,12 +325,62 @@ namespace casadi {
     /** \brief  Get total number of elements in all of the matrix-valued outputs */
     int getNumOutputElements() const;
 
-    /// Get all statistics obtained at the end of the last evaluate call
+    /** \brief Get all statistics obtained at the end of the last evaluate call
+     *
+     * With gather_stats set, this includes the number of calls and the total, minimum and
+     * maximum wall time of evaluations (n_eval, t_eval, ...), of evaluations of derivative
+     * functions generated from this function (n_eval_der, ...) and of batches of sparsity
+     * propagation sweeps (n_eval_sp, ...), as well as the bytes passed through setInput
+     * and getOutput.
+     * Calls to other functions, as timed by the caller, are nested in "calls" by function
+     * name, together with the calls that these make in turn if they gather statistics.
+     * Distinct functions with the same name are told apart as name[0], name[1], ...
+     */
     const Dictionary & getStats() const;
 
+    /// Record that nnz nonzeros were passed through setInput or getOutput
+    void statsIO(bool input, int nnz) const {
+      if (gather_stats_) (input ? stats_bytes_in_ : stats_bytes_out_) += nnz*sizeof(double);
+    }
+
+    /// Add the statistics of calls to other functions, by function name
+    virtual void getCallStats(Dictionary& calls) const {}
+
     /// Get single statistic obtained at the end of the last evaluate call
     GenericType getStat(const std::string & name) const;
 
+    /** \brief Memory used by the function, in bytes by category
+     * The categories added by addMemoryUsage are summed up in "total".
+     */
+    Dictionary getMemoryUsage() const;
+
+    /** \brief Add the memory used by the class to the categories of a memory report
+     * Counts the numerical inputs and outputs ("io"), the cached Jacobian sparsity patterns
+     * ("jac_sparsity") and the totals of the cached derivative functions that are still
+     * alive ("derivatives"). Classes with work vectors or expression graphs add their own.
+     */
+    virtual void addMemoryUsage(Dictionary& mem) const;
+
+    /// Add bytes to a category of a memory report
+    static void addMemory(Dictionary& mem, const std::string& category, double bytes);
+
+    /// Bytes allocated by a vector
+    template<typename T>
+    static double vectorMemory(const std::vector<T>& v) { return v.capacity()*sizeof(T);}
+
+    /** \brief Hash of the structure of the algorithm, zero if not available
+     * Functions with the same structural hash and the same input and output sparsities
+     * have the same Jacobian sparsity patterns
+     */
+    virtual std::size_t getStructuralHash() const { return 0;}
+
+    /// Number of elementary operations of the algorithm, zero if not available
+    virtual int getAlgorithmSize() const { return 0;}
+
+    /// Fingerprint of a record in the on-disk sparsity cache, empty if not cached
+    std::vector<std::size_t> sparsityCacheFingerprint(int type, int iind, int oind, bool compact,
+                                                      bool symmetric);
+
     /// Generate the sparsity of a Jacobian block
     virtual Sparsity getJacSparsity(int iind, int oind, bool symmetric);
 
@@ -329,10 +441,23 @@ namespace casadi {
     /** \brief  Log the status of the solver, function given */
     void log(const std::string& fcn, const std::string& msg) const;
 
-    /// Codegen function
+    /** \brief Codegen, compile and load a function
+     *
+     * If CasadiOptions::codegen_cache_dir is set, the shared object is looked up in and
+     * stored to this directory instead of being recompiled.
+     */
     Function dynamicCompilation(Function f, std::string fname, std::string fdescr,
                                 std::string compiler);
 
+    /** \brief Compile a generated C file into a shared object
+     *
+     * The additional translation units are written next to \a cname and compiled
+     * to object files in parallel (with OpenMP) before linking.
+     */
+    void compileCode(const std::string& cname, const std::vector<std::string>& units,
+                     const std::string& dlname, const std::string& fdescr,
+                     const std::string& compiler, const std::string& dlflag);
+
     /// The following functions are called internally from EvaluateMX.
     /// For documentation, see the MXNode class
     ///@{
@@ -385,11 +510,20 @@ namespace casadi {
     std::set<std::string> monitors_;
 
     /** \brief  Dictionary of statistics (resulting from evaluate) */
-    Dictionary stats_;
+    mutable Dictionary stats_;
 
     /** \brief  Flag to indicate whether statistics must be gathered */
     bool gather_stats_;
 
+    /// Statistics of evaluations, of evaluations of derivatives and of sparsity sweeps
+    EvaluationStats stats_eval_, stats_der_, stats_sp_;
+
+    /// Bytes passed through setInput and getOutput
+    mutable double stats_bytes_in_, stats_bytes_out_;
+
+    /// Function of which this is a derivative, its statistics include calls to this function
+    WeakRef derivative_of_;
+
     /// Cache for functions to evaluate directional derivatives
     std::vector<std::vector<WeakRef> > derivative_fcn_;
 
@@ -399,6 +533,15 @@ namespace casadi {
     /// Cache for sparsities of the Jacobian blocks
     SparseStorage<Sparsity> jac_sparsity_, jac_sparsity_compact_;
 
+    /// File for caching sparsities and seed matrices between runs (empty if not used)
+    std::string sparsity_cache_;
+
+    /// Structural hash, calculated when first needed
+    std::size_t structural_hash_;
+
+    /// Number of threads for the sparsity propagation
+    int sparsity_threads_;
+
     /// Cache for Jacobians
     SparseStorage<WeakRef> jac_, jac_compact_;
 
@@ -34,6 +34,10 @@ namespace casadi {
   HomotopyNlpSolver::HomotopyNlpSolver() {
   }
 
+  HomotopyNlpSolver::HomotopyNlpSolver(const std::string& name, const Function& hnlp) {
+    assignNode(HomotopyNLPInternal::instantiatePlugin(name, hnlp));
+  }
+
   HomotopyNLPInternal* HomotopyNlpSolver::operator->() {
     return static_cast<HomotopyNLPInternal*>(Function::operator->());
   }
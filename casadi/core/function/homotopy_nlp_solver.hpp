@@ -82,6 +82,20 @@ namespace casadi {
     /// Default constructor
     HomotopyNlpSolver();
 
+    /// Homotopy NLP solver factory
+    HomotopyNlpSolver(
+      const std::string& name,
+      /**< \pluginargument{HomotopyNlpSolver}
+      */
+      const Function& hnlp
+      /**< \parblock
+       *  @copydoc scheme_HNLPInput
+       *  @copydoc scheme_NLPOutput
+       *
+       *  \endparblock
+       */
+      ); // NOLINT(whitespace/parens)
+
     /// Access functions of the node
     HomotopyNLPInternal* operator->();
     const HomotopyNLPInternal* operator->() const;
@@ -62,6 +62,18 @@ namespace casadi {
     (*this)->integrate(t_out);
   }
 
+  double Integrator::step(double t_out) {
+    return (*this)->step(t_out);
+  }
+
+  bool Integrator::hasDenseOutput() const {
+    return (*this)->hasDenseOutput();
+  }
+
+  void Integrator::interpolate(double t) {
+    (*this)->interpolate(t);
+  }
+
   bool Integrator::testCast(const SharedObjectNode* ptr) {
     return dynamic_cast<const IntegratorInternal*>(ptr)!=0;
   }
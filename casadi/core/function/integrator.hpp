@@ -216,6 +216,22 @@ namespace casadi {
     /// Integrate forward until a specified time point
     void integrate(double t_out);
 
+    /** \brief Take one internal step of the forward problem towards a time point
+     *
+     * Returns the time reached. Plugins without dense output integrate all the way to t_out.
+     */
+    double step(double t_out);
+
+    /// Can the forward solution be interpolated within the last step?
+    bool hasDenseOutput() const;
+
+    /** \brief Evaluate the dense output of the last step
+     *
+     * The outputs INTEGRATOR_XF, INTEGRATOR_ZF and INTEGRATOR_QF are set to the interpolated
+     * solution at time t, which must lie within the last step taken.
+     */
+    void interpolate(double t);
+
     /** \brief Reset the backward problem
      *
      * Time will be set to tf and backward state to input(INTEGRATOR_RX0)
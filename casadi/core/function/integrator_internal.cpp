@@ -897,6 +897,11 @@ namespace casadi {
     log("IntegratorInternal::reset", "end");
   }
 
+  void IntegratorInternal::interpolate(double t) {
+    casadi_error("IntegratorInternal::interpolate not defined for class "
+                 << typeid(*this).name());
+  }
+
   void IntegratorInternal::resetB() {
     log("IntegratorInternal::resetB", "begin");
 
@@ -71,6 +71,15 @@ namespace casadi {
     /** \brief  Integrate forward until a specified time point */
     virtual void integrate(double t_out) = 0;
 
+    /** \brief  Take one internal step towards a time point, returns the time reached */
+    virtual double step(double t_out) { integrate(t_out); return t_;}
+
+    /** \brief  Is the dense output of the last step available? */
+    virtual bool hasDenseOutput() const { return false;}
+
+    /** \brief  Interpolate the forward solution within the last step */
+    virtual void interpolate(double t);
+
     /** \brief  Integrate backward until a specified time point */
     virtual void integrateB(double t_out) = 0;
 
@@ -256,13 +256,17 @@ namespace casadi {
     *
     *  @copydoc oind
     */
-    Matrix<double> getOutput(int oind=0) const  { return output(oind); }
+    Matrix<double> getOutput(int oind=0) const  {
+      static_cast<const Derived*>(this)->statsIO(false, output(oind).size());
+      return output(oind);
+    }
     /** \brief Get an output by name
     *
     *  @copydoc oname
     *
      */
-    Matrix<double> getOutput(const std::string &oname) const  { return output(oname); }
+    Matrix<double> getOutput(const std::string &oname) const
+    { return getOutput(outputSchemeEntry(oname)); }
 
 #ifdef DOXYGENPROC
     /** \brief Set an input by index
@@ -347,6 +351,7 @@ namespace casadi {
       catch(std::exception& e) {                                                \
         casadi_error(e.what() << "Occurred at iind = " << iind << ".");         \
       }                                                                         \
+      static_cast<const Derived*>(this)->statsIO(true, input(iind).size());     \
     }                                                                           \
     void setOutput(T val, int oind=0)                                           \
     { static_cast<const Derived*>(this)->assertInit(); output(oind).set(val); } \
@@ -370,7 +375,8 @@ namespace casadi {
     void getInput(T val, int iind=0) const                                     \
     { static_cast<const Derived*>(this)->assertInit(); input(iind).get(val);}  \
     void getOutput(T val, int oind=0) const                                    \
-    { static_cast<const Derived*>(this)->assertInit(); output(oind).get(val);} \
+    { static_cast<const Derived*>(this)->assertInit(); output(oind).get(val);  \
+      static_cast<const Derived*>(this)->statsIO(false, output(oind).size());} \
     void getInput(T val, const std::string &iname) const                       \
     { getInput(val, inputSchemeEntry(iname)); }                                 \
     void getOutput(T val, const std::string &oname) const                      \
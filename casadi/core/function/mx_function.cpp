@@ -98,18 +98,22 @@ MXFunctionInternal* MXFunction::operator->() {
 }
 
 const MX& MXFunction::inputExpr(int ind) const {
+  (*this)->assertSymbolic();
   return (*this)->inputv_.at(ind);
 }
 
 const MX& MXFunction::outputExpr(int ind) const {
+  (*this)->assertSymbolic();
   return (*this)->outputv_.at(ind);
 }
 
 const std::vector<MX>& MXFunction::inputExpr() const {
+  (*this)->assertSymbolic();
   return (*this)->inputv_;
 }
 
 const std::vector<MX> & MXFunction::outputExpr() const {
+  (*this)->assertSymbolic();
   return (*this)->outputv_;
 }
 
@@ -122,6 +126,10 @@ int MXFunction::countNodes() const {
   return algorithm().size();
 }
 
+void MXFunction::clearSymbolic() {
+  (*this)->clearSymbolic();
+}
+
 MX MXFunction::jac(int iind, int oind, bool compact, bool symmetric) {
   return (*this)->jac(iind, oind, compact, symmetric);
 }
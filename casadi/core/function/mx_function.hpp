@@ -141,6 +141,10 @@ public:
   /** \brief Number of nodes in the algorithm */
   int countNodes() const;
 
+  /** \brief Clear the function from its symbolic inputs and outputs, to free up memory,
+   * no symbolic evaluations are possible after this */
+  void clearSymbolic();
+
   /// Check if a particular cast is allowed
   static bool testCast(const SharedObjectNode* ptr);
 
@@ -107,6 +107,7 @@ namespace casadi {
 
   void MXFunctionInternal::init() {
     log("MXFunctionInternal::init begin");
+    assertSymbolic();
 
     // Call the init function of the base class
     XFunctionInternal<MXFunction, MXFunctionInternal, MX, MXNode>::init();
@@ -384,7 +385,12 @@ namespace casadi {
       }
     }
 
+    // Statistics of the function calls
+    call_stats_.clear();
+    if (gather_stats_) call_stats_.resize(algorithm_.size());
+
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      ProfilingLogLock lock;
       profileWriteName(CasadiOptions::profilingLog, this, getOption("name"),
                        ProfilingData_FunctionType_MXFunction, algorithm_.size());
       int alg_counter = 0;
@@ -397,9 +403,53 @@ namespace casadi {
       }
     }
 
+    // Release the expression graph if requested
+    if (getOption("release_symbolic")) clearSymbolic();
+
     log("MXFunctionInternal::init end");
   }
 
+  void MXFunctionInternal::clearSymbolic() {
+    XFunctionInternal<MXFunction, MXFunctionInternal, MX, MXNode>::clearSymbolic();
+
+    // The symbolic inputs are not needed for the numerical evaluation, the other nodes
+    // of the algorithm are
+    for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      if (it->op==OP_INPUT) it->data.assignNode(0);
+    }
+  }
+
+  void MXFunctionInternal::addMemoryUsage(Dictionary& mem) const {
+    XFunctionInternal<MXFunction, MXFunctionInternal, MX, MXNode>::addMemoryUsage(mem);
+
+    // Algorithm and the nodes it keeps alive
+    double algorithm = vectorMemory(algorithm_), nodes = 0;
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      algorithm += vectorMemory(it->arg) + vectorMemory(it->res);
+      if (it->data.isNull()) continue;
+      nodes += sizeof(MXNode) + it->data->ndep()*sizeof(MX);
+      if (it->op==OP_CONST) nodes += it->data.size()*sizeof(double);
+    }
+    addMemory(mem, "algorithm", algorithm);
+    addMemory(mem, "mx_nodes", nodes);
+
+    // Work vectors
+    double work = vectorMemory(work_) + vectorMemory(itmp_) + vectorMemory(rtmp_)
+      + vectorMemory(tape_);
+    for (vector<pair<DMatrix, int> >::const_iterator it=work_.begin(); it!=work_.end(); ++it) {
+      work += vectorMemory(it->first.data());
+    }
+    for (vector<pair<pair<int, int>, DMatrix> >::const_iterator it=tape_.begin();
+         it!=tape_.end(); ++it) {
+      work += vectorMemory(it->second.data());
+    }
+    addMemory(mem, "work", work);
+
+    // References to the expression graph
+    addMemory(mem, "symbolic",
+              vectorMemory(inputv_) + vectorMemory(outputv_) + vectorMemory(free_vars_));
+  }
+
   void MXFunctionInternal::updatePointers(const AlgEl& el) {
     mx_input_.resize(el.arg.size());
     mx_output_.resize(el.res.size());
@@ -428,17 +478,18 @@ namespace casadi {
 
   void MXFunctionInternal::evaluate() {
     casadi_log("MXFunctionInternal::evaluate():begin "  << getOption("name"));
-    // Set up timers for profiling
+    // Record into the event buffer of this thread in binary mode
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = 0;
+
+    // Set up timers for text profiling
+    bool profiling_text = CasadiOptions::profiling && !CasadiOptions::profilingBinary;
     double time_zero=0;
     double time_start=0;
     double time_stop=0;
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_zero = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteEntry(CasadiOptions::profilingLog, this);
-      } else {
-        CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
-      }
+      CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
     }
 
     // Make sure that there are no free variables
@@ -453,7 +504,9 @@ namespace casadi {
     // should only evaluate nodes that have not yet been calculated!
     int alg_counter = 0;
     for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it, ++alg_counter) {
-      if (CasadiOptions::profiling) {
+      if (prof.active()) {
+        ticks_start = getTicks(); // Start timer
+      } else if (profiling_text) {
         time_start = getRealTime(); // Start timer
       }
 
@@ -468,43 +521,40 @@ namespace casadi {
         // Point pointers to the data corresponding to the element
         updatePointers(*it);
 
-        // Evaluate
-        it->data->evaluateD(mx_input_, mx_output_, itmp_, rtmp_);
+        // Evaluate, timing calls to other functions for the statistics
+        if (gather_stats_ && it->op==OP_CALL) {
+          double t = getStatsTime();
+          it->data->evaluateD(mx_input_, mx_output_, itmp_, rtmp_);
+          call_stats_[alg_counter].add(getStatsTime() - t);
+        } else {
+          it->data->evaluateD(mx_input_, mx_output_, itmp_, rtmp_);
+        }
 
       }
 
       // Write out profiling information
-      if (CasadiOptions::profiling) {
+      if (prof.active()) {
+        prof.line(alg_counter, ticks_start);
+      } else if (profiling_text) {
         time_stop = getRealTime(); // Stop timer
-
-        if (CasadiOptions::profilingBinary) {
-          profileWriteTime(CasadiOptions::profilingLog, this, alg_counter,
-                           time_stop-time_start, time_stop-time_zero);
-        } else {
-          CasadiOptions::profilingLog  << (time_stop-time_start)*1e6 << " ns | "
-                                       << (time_stop-time_zero)*1e3 << " ms | "
-                                       << this << ":" <<getOption("name") << ":"
-                                       << alg_counter <<"|";
-          if (it->op == OP_CALL) {
-            Function f = it->data->getFunction();
-            CasadiOptions::profilingLog << f.get() << ":" << f.getOption("name");
-          }
-          CasadiOptions::profilingLog << "|";
-          print(CasadiOptions::profilingLog, *it);
+        CasadiOptions::profilingLog  << (time_stop-time_start)*1e6 << " ns | "
+                                     << (time_stop-time_zero)*1e3 << " ms | "
+                                     << this << ":" <<getOption("name") << ":"
+                                     << alg_counter <<"|";
+        if (it->op == OP_CALL) {
+          Function f = it->data->getFunction();
+          CasadiOptions::profilingLog << f.get() << ":" << f.getOption("name");
         }
-
+        CasadiOptions::profilingLog << "|";
+        print(CasadiOptions::profilingLog, *it);
       }
     }
 
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_stop = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_zero);
-      } else {
-        CasadiOptions::profilingLog  << "stop " << this << ":"
-                                     <<getOption("name") << (time_stop-time_zero)*1e3
-                                     << " ms" << std::endl;
-      }
+      CasadiOptions::profilingLog  << "stop " << this << ":"
+                                   <<getOption("name") << (time_stop-time_zero)*1e3
+                                   << " ms" << std::endl;
     }
 
     casadi_log("MXFunctionInternal::evaluate():end "  << getOption("name"));
@@ -552,6 +602,84 @@ namespace casadi {
     stream << endl;
   }
 
+  size_t MXFunctionInternal::getStructuralHash() const {
+    // Sparsity of the work vector
+    size_t h = work_.size();
+    for (vector<pair<DMatrix, int> >::const_iterator it=work_.begin(); it!=work_.end(); ++it) {
+      hash_combine(h, it->first.sparsity().hash());
+    }
+
+    // Operations and their arguments, but not the values of the constants
+    stringstream ss;
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      hash_combine(h, it->op);
+      hash_combine(h, it->arg);
+      hash_combine(h, it->res);
+      switch (it->op) {
+      case OP_INPUT:
+      case OP_OUTPUT:
+      case OP_PARAMETER:
+      case OP_CONST:
+        break;
+      case OP_CALL:
+        {
+          // Structure of the called function
+          size_t h_f = it->data->getFunction()->getStructuralHash();
+          if (h_f==0) return 0;
+          hash_combine(h, h_f);
+        }
+        break;
+      case OP_SOLVE:
+        // Sparsity of the linear system
+        hash_combine(h, it->data->getFunction().input(LINSOL_A).sparsity().hash());
+        // fall through
+      default:
+        // Node-specific data such as nonzero mappings, as printed
+        ss.str("");
+        for (int i=0; i<=it->arg.size(); ++i) it->data->printPart(ss, i);
+        string str = ss.str();
+        for (string::const_iterator c=str.begin(); c!=str.end(); ++c) hash_combine(h, *c);
+      }
+    }
+    return h==0 ? 1 : h;
+  }
+
+  void MXFunctionInternal::getCallStats(Dictionary& calls) const {
+    // Combine the call nodes by called function, in order of the first call
+    vector<Function> fcn;
+    vector<EvaluationStats> stats;
+    map<const SharedObjectNode*, int> ind;
+    for (int k=0; k<call_stats_.size(); ++k) {
+      if (algorithm_[k].op!=OP_CALL) continue;
+      const Function& f = algorithm_[k].data->getFunction();
+      pair<map<const SharedObjectNode*, int>::iterator, bool> r =
+        ind.insert(make_pair(f.get(), static_cast<int>(fcn.size())));
+      if (r.second) {
+        fcn.push_back(f);
+        stats.push_back(EvaluationStats());
+      }
+      stats[r.first->second].add(call_stats_[k]);
+    }
+
+    // Distinct functions with the same name, such as unnamed ones, are numbered
+    map<string, int> n_name, i_name;
+    for (int i=0; i<fcn.size(); ++i) n_name[fcn[i].getOption("name")]++;
+
+    // Nest the calls made by the called functions
+    for (int i=0; i<fcn.size(); ++i) {
+      string name = fcn[i].getOption("name");
+      if (n_name[name]>1) {
+        name += "[" + CodeGenerator::numToString(i_name[name]++) + "]";
+      }
+      Dictionary d;
+      stats[i].write(d, "eval");
+      Dictionary nested;
+      fcn[i]->getCallStats(nested);
+      if (!nested.empty()) d["calls"] = nested;
+      calls[name] = d;
+    }
+  }
+
   void MXFunctionInternal::print(ostream &stream) const {
     FunctionInternal::print(stream);
     for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
@@ -648,6 +776,8 @@ namespace casadi {
 
   Function MXFunctionInternal::getNumericJacobian(int iind, int oind,
                                                   bool compact, bool symmetric) {
+    assertSymbolic();
+
     // Create expressions for the Jacobian
     vector<MX> ret_out;
     ret_out.reserve(1+outputv_.size());
@@ -663,7 +793,7 @@ namespace casadi {
   std::vector<MX> MXFunctionInternal::symbolicOutput(const std::vector<MX>& arg) {
     // Check if input is given
     const int checking_depth = 2;
-    bool input_given = true;
+    bool input_given = !symbolic_released_;
     for (int i=0; i<arg.size() && input_given; ++i) {
       if (!isEqual(arg[i], inputv_[i], checking_depth)) {
         input_given = false;
@@ -685,6 +815,7 @@ namespace casadi {
                                   std::vector<std::vector<MX> >& asens) {
     log("MXFunctionInternal::evalMX begin");
     assertInit();
+    assertSymbolic();
     casadi_assert_message(arg1.size()==getNumInputs(), "Wrong number of input arguments");
 
     // Resize the number of outputs
@@ -1063,6 +1194,7 @@ namespace casadi {
                                         std::vector<std::vector<SX> >& fwdSens,
                                         const std::vector<std::vector<SX> >& adjSeed,
                                         std::vector<std::vector<SX> >& adjSens) {
+    assertSymbolic();
     casadi_assert_message(fwdSens.empty(), "Not implemented");
     casadi_assert_message(adjSeed.empty(), "Not implemented");
 
@@ -1111,6 +1243,7 @@ namespace casadi {
 
   SXFunction MXFunctionInternal::expand(const std::vector<SX>& inputvsx) {
     assertInit();
+    assertSymbolic();
 
     // Create inputs with the same name and sparsity as the matrix valued symbolic inputs
     vector<SX> arg(inputv_.size());
@@ -1301,6 +1434,7 @@ namespace casadi {
 
   void MXFunctionInternal::generateLiftingFunctions(MXFunction& vdef_fcn, MXFunction& vinit_fcn) {
     assertInit();
+    assertSymbolic();
 
     vector<MX> swork(work_.size());
 
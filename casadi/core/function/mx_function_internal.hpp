@@ -68,9 +68,22 @@ namespace casadi {
     /** \brief  Print description */
     virtual void print(std::ostream &stream) const;
 
+    /** \brief Hash of the structure of the algorithm */
+    virtual std::size_t getStructuralHash() const;
+
+    /** \brief Number of elementary operations of the algorithm */
+    virtual int getAlgorithmSize() const { return algorithm_.size();}
+
     /** \brief  Initialize */
     virtual void init();
 
+    /** \brief Clear the function from its symbolic inputs and outputs, to free up memory,
+     * no symbolic evaluations are possible after this */
+    virtual void clearSymbolic();
+
+    /// Add the algorithm, work vectors and expression graph to a memory report
+    virtual void addMemoryUsage(Dictionary& mem) const;
+
     /** \brief Generate code for the declarations of the C function */
     virtual void generateDeclarations(std::ostream &stream, const std::string& type,
                                       CodeGenerator& gen) const;
@@ -107,6 +120,12 @@ namespace casadi {
     /// Free variables
     std::vector<MX> free_vars_;
 
+    /// Statistics of the calls made by each element of the algorithm, if gathered
+    std::vector<EvaluationStats> call_stats_;
+
+    /// Add the statistics of the calls to other functions, by function name
+    virtual void getCallStats(Dictionary& calls) const;
+
     /** \brief Evaluate symbolically, SXElement type*/
     virtual void evalSXsparse(const std::vector<SX>& input, std::vector<SX>& output,
                               const std::vector<std::vector<SX> >& fwdSeed,
@@ -132,7 +151,7 @@ namespace casadi {
     DMatrixPtrV mx_output_;
 
     /// Get a vector of symbolic variables with the same dimensions as the inputs
-    virtual std::vector<MX> symbolicInput() const { return inputv_;}
+    virtual std::vector<MX> symbolicInput() const { assertSymbolic(); return inputv_;}
 
     /// Get a vector of symbolic variables corresponding to the outputs
     virtual std::vector<MX> symbolicOutput(const std::vector<MX>& arg);
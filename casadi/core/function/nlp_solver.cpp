@@ -214,4 +214,20 @@ namespace casadi {
     (*this)->setOptionsFromFile(file);
   }
 
+  std::vector<DMatrix> NlpSolver::getSensitivity() {
+    return (*this)->getSensitivity(DMatrix::eye((*this)->np_));
+  }
+
+  void NlpSolver::predict(const DMatrix& p) {
+    (*this)->predict(p);
+  }
+
+  std::vector<DMatrix> NlpSolver::solveBatch(const std::vector<DMatrix>& arg) {
+    return (*this)->solveBatch(arg);
+  }
+
+  Dictionary NlpSolver::getBatchStats(int k) const {
+    return (*this)->batch_stats_.at(k);
+  }
+
 } // namespace casadi
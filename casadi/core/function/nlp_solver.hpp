@@ -275,6 +275,36 @@ namespace casadi {
 
     /// Read options from parameter xml
     void setOptionsFromFile(const std::string & file);
+
+    /** \brief First order sensitivity of the solution w.r.t. the parameters
+     *
+     * Returns [dx/dp, dlam_x/dp, dlam_g/dp] at the last solution, with the active set held
+     * fixed. The KKT system is formed from hessLag() and jacG() and factorized once.
+     * The inputs must not have changed since the last call to evaluate().
+     */
+    std::vector<DMatrix> getSensitivity();
+
+    /** \brief Tangential predictor
+     *
+     * Sets NLP_SOLVER_P to \a p and NLP_SOLVER_X0, NLP_SOLVER_LAM_X0 and NLP_SOLVER_LAM_G0 to
+     * the first-order prediction of the solution for \a p. Evaluate to correct the prediction,
+     * or use the initial guess directly if first-order accuracy suffices.
+     */
+    void predict(const DMatrix& p);
+
+    /** \brief Solve many instances of the NLP
+     *
+     * Each input is either empty (the current input is used), a single column (shared by all
+     * instances) or a matrix with one column per instance, indexed by NlpSolverInput.
+     * The outputs are returned in the same way, one column per instance. The columns of
+     * instances for which the solver raised an error are NaN, see getBatchStats.
+     * The instances are distributed over a pool of copies of this solver, one per thread
+     * (option batch_threads). The copies are created on the first call and reused.
+     */
+    std::vector<DMatrix> solveBatch(const std::vector<DMatrix>& arg);
+
+    /// Statistics of instance \a k in the last call to solveBatch
+    Dictionary getBatchStats(int k) const;
   };
 
 } // namespace casadi
@@ -28,6 +28,11 @@
 #include "sx_function.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../mx/mx_tools.hpp"
+#include <ctime>
+#include <limits>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif //WITH_OPENMP
 
 INPUTSCHEME(NlpSolverInput)
 OUTPUTSCHEME(NlpSolverOutput)
@@ -70,6 +75,13 @@ namespace casadi {
     addOption("eval_errors_fatal", OT_BOOLEAN, false,
               "When errors occur during evaluation of f,g,...,"
               "stop the iterations");
+    addOption("sensitivity_active_tol", OT_REAL, 1e-8,
+              "Tolerance for detecting active constraints when computing "
+              "parametric sensitivities");
+    addOption("sensitivity_linear_solver", OT_STRING, "csparse",
+              "Linear solver for the KKT system when computing parametric sensitivities");
+    addOption("batch_threads", OT_INTEGER, 0,
+              "Number of threads used by solveBatch (0: OpenMP default)");
 
     // Enable string notation for IO
     input_.scheme = SCHEME_NlpSolverInput;
@@ -149,7 +161,29 @@ namespace casadi {
 
     callback_step_ = getOption("iteration_callback_step");
     eval_errors_fatal_ = getOption("eval_errors_fatal");
+    sens_active_tol_ = getOption("sensitivity_active_tol");
+    sens_linear_solver_ = getOption("sensitivity_linear_solver").toString();
 
+    // The copies used by solveBatch have the options of an earlier initialization
+    batch_pool_.clear();
+  }
+
+  void NlpSolverInternal::deepCopyMembers(
+      std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    FunctionInternal::deepCopyMembers(already_copied);
+    nlp_ = deepcopy(nlp_, already_copied);
+    gradF_ = deepcopy(gradF_, already_copied);
+    jacF_ = deepcopy(jacF_, already_copied);
+    jacG_ = deepcopy(jacG_, already_copied);
+    hessLag_ = deepcopy(hessLag_, already_copied);
+    gradLag_ = deepcopy(gradLag_, already_copied);
+    jacGradLagP_ = deepcopy(jacGradLagP_, already_copied);
+    jacGP_ = deepcopy(jacGP_, already_copied);
+    batch_pool_.clear();
+
+    // The reference passed to the callback must point to the copy
+    ref_ = Function();
+    ref_.assignNodeNoCount(this);
   }
 
   void NlpSolverInternal::checkInitialBounds() {
@@ -307,6 +341,24 @@ namespace casadi {
     return gradLag;
   }
 
+  Function& NlpSolverInternal::jacGradLagP() {
+    if (jacGradLagP_.isNull()) {
+      log("Generating Jacobian of the Lagrangian gradient w.r.t. p");
+      jacGradLagP_ = gradLag().jacobian(NL_P, NL_NUM_OUT+NL_X);
+      jacGradLagP_.init(false);
+    }
+    return jacGradLagP_;
+  }
+
+  Function& NlpSolverInternal::jacGP() {
+    if (jacGP_.isNull()) {
+      log("Generating constraint Jacobian w.r.t. p");
+      jacGP_ = nlp_.jacobian(NL_P, NL_G);
+      jacGP_.init(false);
+    }
+    return jacGP_;
+  }
+
   Function& NlpSolverInternal::hessLag() {
     if (hessLag_.isNull()) {
       hessLag_ = getHessLag();
@@ -389,4 +441,221 @@ namespace casadi {
                  << typeid(*this).name());
   }
 
+  std::vector<DMatrix> NlpSolverInternal::getSensitivity(const DMatrix& dp) {
+    casadi_assert_message(dp.size1()==np_, "NlpSolver::getSensitivity: expecting "
+                          << np_ << " rows in the parameter directions, got " << dp.size1());
+    const std::vector<double>& x = output(NLP_SOLVER_X).data();
+    const std::vector<double>& g = output(NLP_SOLVER_G).data();
+    const std::vector<double>& lam_x = output(NLP_SOLVER_LAM_X).data();
+    const std::vector<double>& lam_g = output(NLP_SOLVER_LAM_G).data();
+    const std::vector<double>& lbx = input(NLP_SOLVER_LBX).data();
+    const std::vector<double>& ubx = input(NLP_SOLVER_UBX).data();
+    const std::vector<double>& lbg = input(NLP_SOLVER_LBG).data();
+    const std::vector<double>& ubg = input(NLP_SOLVER_UBG).data();
+
+    // Hessian of the Lagrangian
+    Function& hessLag = this->hessLag();
+    hessLag.setInput(output(NLP_SOLVER_X), HESSLAG_X);
+    hessLag.setInput(input(NLP_SOLVER_P), HESSLAG_P);
+    hessLag.setInput(1.0, HESSLAG_LAM_F);
+    hessLag.setInput(output(NLP_SOLVER_LAM_G), HESSLAG_LAM_G);
+    hessLag.evaluate();
+
+    // Mixed second derivatives of the Lagrangian, same inputs as the Hessian
+    Function& gradLagP = jacGradLagP();
+    gradLagP.setInput(output(NLP_SOLVER_X), NL_X);
+    gradLagP.setInput(input(NLP_SOLVER_P), NL_P);
+    gradLagP.setInput(1.0, NL_NUM_IN+NL_F);
+    gradLagP.setInput(output(NLP_SOLVER_LAM_G), NL_NUM_IN+NL_G);
+    gradLagP.evaluate();
+    DMatrix rhs_x = -mul(gradLagP.output(), dp);
+
+    // Constraint Jacobians w.r.t. x and p
+    DMatrix J = DMatrix::sparse(ng_, nx_), rhs_g = DMatrix::sparse(ng_, dp.size2());
+    if (ng_>0) {
+      Function& jacG = this->jacG();
+      jacG.setInput(output(NLP_SOLVER_X), JACG_X);
+      jacG.setInput(input(NLP_SOLVER_P), JACG_P);
+      jacG.evaluate();
+      J = jacG.output(JACG_JAC);
+
+      Function& jacGP = this->jacGP();
+      jacGP.setInput(output(NLP_SOLVER_X), NL_X);
+      jacGP.setInput(input(NLP_SOLVER_P), NL_P);
+      jacGP.evaluate();
+      rhs_g = -mul(jacGP.output(), dp);
+    }
+
+    // Active set, kept fixed
+    std::vector<int> ax, ag;
+    for (int i=0; i<nx_; ++i) {
+      if (lbx[i]==ubx[i] ||
+          (lam_x[i]>sens_active_tol_ && x[i]>=ubx[i]-sens_active_tol_) ||
+          (lam_x[i]<-sens_active_tol_ && x[i]<=lbx[i]+sens_active_tol_)) ax.push_back(i);
+    }
+    for (int i=0; i<ng_; ++i) {
+      if (lbg[i]==ubg[i] ||
+          (lam_g[i]>sens_active_tol_ && g[i]>=ubg[i]-sens_active_tol_) ||
+          (lam_g[i]<-sens_active_tol_ && g[i]<=lbg[i]+sens_active_tol_)) ag.push_back(i);
+    }
+    int nax = ax.size(), nag = ag.size();
+
+    // Selection matrix for the active bounds
+    DMatrix E = DMatrix::sparse(nax, nx_);
+    for (int k=0; k<nax; ++k) E(k, ax[k]) = 1;
+    DMatrix J_a = J(ag, ALL);
+
+    // KKT matrix
+    std::vector< std::vector<DMatrix> > K(3);
+    K[0].push_back(hessLag.output(HESSLAG_HESS));
+    K[0].push_back(J_a.T());
+    K[0].push_back(E.T());
+    K[1].push_back(J_a);
+    K[1].push_back(DMatrix::sparse(nag, nag));
+    K[1].push_back(DMatrix::sparse(nag, nax));
+    K[2].push_back(E);
+    K[2].push_back(DMatrix::sparse(nax, nag));
+    K[2].push_back(DMatrix::sparse(nax, nax));
+
+    // Right-hand sides, one per direction
+    std::vector<DMatrix> rhs;
+    rhs.push_back(dense(rhs_x));
+    rhs.push_back(dense(DMatrix(rhs_g(ag, ALL))));
+    rhs.push_back(DMatrix::zeros(nax, dp.size2()));
+
+    // Factorize once, solve for all directions
+    DMatrix sol = dense(casadi::solve(blockcat(K), vertcat(rhs), sens_linear_solver_));
+
+    // Inactive multipliers stay zero
+    std::vector<DMatrix> ret(3);
+    ret[0] = sol(range(nx_), ALL);
+    ret[1] = DMatrix::zeros(nx_, dp.size2());
+    ret[2] = DMatrix::zeros(ng_, dp.size2());
+    if (nax>0) ret[1](ax, ALL) = sol(range(nx_+nag, nx_+nag+nax), ALL);
+    if (nag>0) ret[2](ag, ALL) = sol(range(nx_, nx_+nag), ALL);
+    return ret;
+  }
+
+  std::vector<DMatrix> NlpSolverInternal::solveBatch(const std::vector<DMatrix>& arg) {
+    casadi_assert_message(arg.size()<=NLP_SOLVER_NUM_IN,
+                          "NlpSolver::solveBatch: too many inputs");
+
+    // Number of instances, inputs as dense nnz-by-n matrices
+    int n = 1;
+    std::vector<DMatrix> in(NLP_SOLVER_NUM_IN);
+    for (int i=0; i<NLP_SOLVER_NUM_IN; ++i) {
+      if (i<arg.size() && !arg[i].isEmpty()) {
+        in[i] = dense(arg[i]);
+        casadi_assert_message(in[i].size1()==input(i).size(), "NlpSolver::solveBatch: input "
+                              << i << " must have " << input(i).size() << " rows, got "
+                              << in[i].size1());
+        if (in[i].size2()!=1) {
+          casadi_assert_message(n==1 || n==in[i].size2(),
+                                "NlpSolver::solveBatch: inconsistent number of instances");
+          n = in[i].size2();
+        }
+      } else {
+        in[i] = dense(vec(input(i)));
+      }
+    }
+
+    // Allocate the pool, one copy of the solver per thread. The copies reuse the derivative
+    // functions generated during init, so the symbolic work is not repeated
+    int nthreads = getOption("batch_threads");
+#ifdef WITH_OPENMP
+    if (nthreads<=0) nthreads = omp_get_max_threads();
+#else // WITH_OPENMP
+    nthreads = 1;
+#endif // WITH_OPENMP
+#ifndef USE_CXX11
+    // Sparsity patterns and reference counts shared by the copies are only thread-safe in C++11
+    nthreads = 1;
+#endif // USE_CXX11
+    nthreads = std::max(std::min(nthreads, n), 1);
+    if (batch_pool_.size()<nthreads) {
+      NlpSolver self = shared_from_this<NlpSolver>();
+      while (batch_pool_.size()<nthreads) {
+        NlpSolver s = deepcopy(self);
+        s.setOption("expand", false);
+        s.init();
+        batch_pool_.push_back(s);
+      }
+    }
+
+    // Allocate results
+    std::vector<DMatrix> ret(NLP_SOLVER_NUM_OUT);
+    for (int i=0; i<NLP_SOLVER_NUM_OUT; ++i) ret[i] = DMatrix::zeros(output(i).size(), n);
+    batch_stats_.resize(n);
+
+    // Solve the instances
+#ifdef WITH_OPENMP
+    double time_start = omp_get_wtime();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+#else // WITH_OPENMP
+    double time_start = clock()/static_cast<double>(CLOCKS_PER_SEC);
+#endif // WITH_OPENMP
+    for (int k=0; k<n; ++k) {
+#ifdef WITH_OPENMP
+      NlpSolver& s = batch_pool_.at(omp_get_thread_num());
+#else // WITH_OPENMP
+      NlpSolver& s = batch_pool_.front();
+#endif // WITH_OPENMP
+
+      // Pass inputs
+      for (int i=0; i<NLP_SOLVER_NUM_IN; ++i) {
+        int nnz = in[i].size1();
+        std::vector<double>::const_iterator it = in[i].begin() + (in[i].size2()==1 ? 0 : k*nnz);
+        std::copy(it, it+nnz, s.input(i).begin());
+      }
+
+      // Solve, exceptions must not leave the parallel region
+      bool failed = false;
+      try {
+        s.evaluate();
+        batch_stats_[k] = s.getStats();
+      } catch(std::exception& ex) {
+        batch_stats_[k] = Dictionary();
+        batch_stats_[k]["return_status"] = std::string(ex.what());
+        failed = true;
+      }
+
+      // Get results, NaN for a failed instance
+      for (int i=0; i<NLP_SOLVER_NUM_OUT; ++i) {
+        int nnz = ret[i].size1();
+        if (failed) {
+          std::fill_n(ret[i].begin() + k*nnz, nnz, std::numeric_limits<double>::quiet_NaN());
+        } else {
+          std::copy(s.output(i).begin(), s.output(i).end(), ret[i].begin() + k*nnz);
+        }
+      }
+    }
+
+    stats_["batch_size"] = n;
+    stats_["batch_threads"] = nthreads;
+#ifdef WITH_OPENMP
+    stats_["t_batch"] = omp_get_wtime() - time_start;
+#else // WITH_OPENMP
+    stats_["t_batch"] = clock()/static_cast<double>(CLOCKS_PER_SEC) - time_start;
+#endif // WITH_OPENMP
+    return ret;
+  }
+
+  void NlpSolverInternal::predict(const DMatrix& p) {
+    casadi_assert_message(p.size()==np_, "NlpSolver::predict: expecting "
+                          << np_ << " parameters, got " << p.size());
+    DMatrix dp = vec(p) - vec(input(NLP_SOLVER_P));
+    std::vector<DMatrix> sens = getSensitivity(dp);
+
+    // Predicted primal point, projected onto the bounds
+    DMatrix x0 = output(NLP_SOLVER_X) + sens[0];
+    const std::vector<double>& lbx = input(NLP_SOLVER_LBX).data();
+    const std::vector<double>& ubx = input(NLP_SOLVER_UBX).data();
+    for (int i=0; i<nx_; ++i) x0.at(i) = std::min(std::max(x0.at(i), lbx[i]), ubx[i]);
+
+    setInput(x0, NLP_SOLVER_X0);
+    setInput(output(NLP_SOLVER_LAM_X) + sens[1], NLP_SOLVER_LAM_X0);
+    setInput(output(NLP_SOLVER_LAM_G) + sens[2], NLP_SOLVER_LAM_G0);
+    input(NLP_SOLVER_P).set(p);
+  }
+
 } // namespace casadi
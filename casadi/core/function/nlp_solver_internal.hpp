@@ -54,6 +54,9 @@ namespace casadi {
     /// Initialize
     virtual void init();
 
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
     /// Prints out a human readable report about possible constraint violations - all constraints
     void reportConstraints(std::ostream &stream=std::cout);
 
@@ -102,6 +105,12 @@ namespace casadi {
     /// Get the sparsity pattern of the Hessian of the Lagrangian
     Sparsity& spHessLag();
 
+    /// Access the Jacobian of the Lagrangian gradient w.r.t. the parameters
+    Function& jacGradLagP();
+
+    /// Access the Jacobian of the constraint function w.r.t. the parameters
+    Function& jacGP();
+
     /// Number of variables
     int nx_;
 
@@ -138,6 +147,12 @@ namespace casadi {
     // Gradient of the Lagrangian
     Function gradLag_;
 
+    // Jacobian of the Lagrangian gradient w.r.t. the parameters
+    Function jacGradLagP_;
+
+    // Jacobian of the constraints w.r.t. the parameters
+    Function jacGP_;
+
     // Sparsity pattern of the Hessian of the Lagrangian
     Sparsity spHessLag_;
 
@@ -165,6 +180,29 @@ namespace casadi {
     /// Read options from parameter xml
     virtual void setOptionsFromFile(const std::string & file);
 
+    /** \brief First order sensitivity of the last solution along parameter directions
+     * Returns dx, dlam_x and dlam_g, one column per column of dp */
+    virtual std::vector<DMatrix> getSensitivity(const DMatrix& dp);
+
+    /// Tangential predictor for new parameter values
+    virtual void predict(const DMatrix& p);
+
+    /// Tolerance for detecting active constraints in the sensitivity analysis
+    double sens_active_tol_;
+
+    /// Linear solver for the KKT system in the sensitivity analysis
+    std::string sens_linear_solver_;
+
+    /** \brief Solve a batch of instances, one per column of the inputs
+     * Empty inputs are taken from the solver, single columns are broadcast */
+    virtual std::vector<DMatrix> solveBatch(const std::vector<DMatrix>& arg);
+
+    /// Copies of this solver used by solveBatch, one per thread
+    std::vector<NlpSolver> batch_pool_;
+
+    /// Statistics of the instances in the last batch
+    std::vector<Dictionary> batch_stats_;
+
   };
 
 } // namespace casadi
@@ -46,6 +46,13 @@ class SimulatorInternal;
   The default output has n=1 and the output is the (vectorized) differential
   state for each time step.
 
+  For long simulations, the "streaming" option keeps only the outputs of the current
+  grid point in memory. The samples can be consumed as they are computed through the
+  "output_callback" option and/or written to a binary file with the "output_file" option.
+
+  With the "dense_output" option, the integrator is not forced to stop at each grid point.
+  It takes its natural steps and the outputs are evaluated from its interpolating polynomial.
+
   \author Joel Andersson
   \date 2010
 */
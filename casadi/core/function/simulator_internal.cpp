@@ -28,6 +28,7 @@
 #include "../std_vector_tools.hpp"
 #include "sx_function.hpp"
 #include "../sx/sx_tools.hpp"
+#include <fstream>
 
 INPUTSCHEME(IntegratorInput)
 
@@ -41,6 +42,22 @@ namespace casadi {
       integrator_(integrator), output_fcn_(output_fcn), grid_(grid) {
     setOption("name", "unnamed simulator");
     addOption("monitor",      OT_STRINGVECTOR, GenericType(),  "", "initial|step", true);
+    addOption("streaming",       OT_BOOLEAN,  false,
+              "Only keep the outputs at the current grid point instead of the whole trajectory. "
+              "Use together with output_callback and/or output_file.");
+    addOption("dense_output",    OT_BOOLEAN,  false,
+              "Let the integrator take its natural steps and evaluate the outputs from the "
+              "interpolating polynomial of the integrator instead of stopping at each grid "
+              "point. Requires an integrator with dense output.");
+    addOption("output_callback", OT_CALLBACK, GenericType(),
+              "Function called after each grid point. The stats 'grid_index' and 't' hold "
+              "the current grid point and, in streaming mode, the outputs hold the samples "
+              "at that point. A non-zero return value aborts the simulation.");
+    addOption("output_file",     OT_STRING,   GenericType(),
+              "Binary file to which the samples are written as they are computed. "
+              "The file starts with a header (char[8] \"CASADISM\", int version, "
+              "int number of outputs, int number of grid points, int numel of each output) "
+              "followed by one record per grid point (double t, then the outputs in order).");
 
     input_.scheme = SCHEME_IntegratorInput;
   }
@@ -98,10 +115,26 @@ namespace casadi {
       input(i) = integrator_.input(i);
     }
 
-    // Allocate outputs
+    // Dense output
+    dense_output_ = getOption("dense_output");
+    casadi_assert_message(!dense_output_ || integrator_.hasDenseOutput(),
+                          "SimulatorInternal::init: option dense_output requires "
+                          "an integrator with dense output.");
+
+    // Streaming options
+    streaming_ = getOption("streaming");
+    if (hasSetOption("output_callback")) {
+      output_callback_ = getOption("output_callback");
+    }
+    if (hasSetOption("output_file")) {
+      output_file_ = getOption("output_file").toString();
+    }
+
+    // Allocate outputs, a single column when streaming
     setNumOutputs(output_fcn_->getNumOutputs());
     for (int i=0; i<getNumOutputs(); ++i) {
-      output(i) = Matrix<double>::zeros(output_fcn_.output(i).numel(), grid_.size());
+      output(i) = Matrix<double>::zeros(output_fcn_.output(i).numel(),
+                                        streaming_ ? 1 : grid_.size());
       if (!output_fcn_.output(i).isEmpty()) {
         casadi_assert_message(output_fcn_.output(i).isVector(),
                               "SimulatorInternal::init: Output function output #" << i
@@ -155,6 +188,19 @@ namespace casadi {
     // Iterators to output data structures
     for (int i=0; i<output_its_.size(); ++i) output_its_[i] = output(i).begin();
 
+    // Open the file sink, if any
+    std::ofstream output_stream;
+    if (!output_file_.empty()) {
+      output_stream.open(output_file_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      casadi_assert_message(output_stream.good(), "SimulatorInternal::evaluate: could not open \""
+                            << output_file_ << "\" for writing.");
+      writeOutputHeader(output_stream);
+    }
+    stats_["return_status"] = "Simulation_Completed";
+
+    // Time reached by the integrator
+    double t = grid_.empty() ? 0 : grid_.front();
+
     // Advance solution in time
     for (int k=0; k<grid_.size(); ++k) {
 
@@ -166,7 +212,13 @@ namespace casadi {
       }
 
       // Integrate to the output time
-      integrator_.integrate(grid_[k]);
+      if (dense_output_) {
+        // Take natural steps past the output time, then interpolate
+        while (t<grid_[k]) t = integrator_.step(grid_.back());
+        if (grid_[k]>grid_.front()) integrator_.interpolate(grid_[k]);
+      } else {
+        integrator_.integrate(grid_[k]);
+      }
 
       if (monitored("step")) {
         std::cout << " xf  = "  << integrator_.output(INTEGRATOR_XF) << std::endl;
@@ -189,9 +241,18 @@ namespace casadi {
       // Save the outputs of the function
       for (int i=0; i<getNumOutputs(); ++i) {
         const Matrix<double> &res = output_fcn_.output(i);
+        if (streaming_) output_its_.at(i) = output(i).begin();
         copy(res.begin(), res.end(), output_its_.at(i));
         output_its_.at(i) += res.size();
       }
+
+      // Pass the samples on
+      if (!output_callback_.isNull() || output_stream.is_open()) {
+        if (!streamOutputs(k, output_stream.is_open() ? &output_stream : 0)) {
+          stats_["return_status"] = "User_Requested_Stop";
+          return;
+        }
+      }
     }
 
     // Consistency check
@@ -200,4 +261,40 @@ namespace casadi {
     }
   }
 
+  void SimulatorInternal::writeOutputHeader(std::ostream& stream) const {
+    const char magic[8] = {'C', 'A', 'S', 'A', 'D', 'I', 'S', 'M'};
+    stream.write(magic, sizeof(magic));
+    int header[3] = {1, getNumOutputs(), static_cast<int>(grid_.size())};
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (int i=0; i<getNumOutputs(); ++i) {
+      int n = output_fcn_.output(i).numel();
+      stream.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    }
+  }
+
+  bool SimulatorInternal::streamOutputs(int k, std::ostream* stream) {
+    // Write a record to the file sink
+    if (stream) {
+      stream->write(reinterpret_cast<const char*>(&grid_[k]), sizeof(double));
+      for (int i=0; i<getNumOutputs(); ++i) {
+        const vector<double>& res = output_fcn_.output(i).data();
+        if (!res.empty()) {
+          stream->write(reinterpret_cast<const char*>(getPtr(res)), res.size()*sizeof(double));
+        }
+      }
+      stream->flush();
+      casadi_assert_message(stream->good(), "SimulatorInternal::evaluate: writing to \""
+                            << output_file_ << "\" failed.");
+    }
+
+    // Call the user callback
+    if (!output_callback_.isNull()) {
+      stats_["grid_index"] = k;
+      stats_["t"] = grid_[k];
+      Function self = shared_from_this<Function>();
+      if (output_callback_(self, user_data_)) return false;
+    }
+    return true;
+  }
+
 } // namespace casadi
@@ -28,6 +28,8 @@
 
 #include "simulator.hpp"
 #include "function_internal.hpp"
+#include "../functor.hpp"
+#include <ostream>
 
 /// \cond INTERNAL
 
@@ -70,6 +72,25 @@ namespace casadi {
 
     // Iterators to current outputs
     std::vector<std::vector<double>::iterator> output_its_;
+
+    /// Evaluate the outputs from the dense output of the integrator
+    bool dense_output_;
+
+    /// Do not store the whole trajectory, only the current grid point
+    bool streaming_;
+
+    /// Callback to be invoked after each grid point
+    Callback output_callback_;
+
+    /// Binary file sink for the outputs at each grid point
+    std::string output_file_;
+
+    /// Write the header of the binary file sink
+    void writeOutputHeader(std::ostream& stream) const;
+
+    /** \brief Pass the outputs at grid point k to the callback and the file sink (if not null)
+        Returns false if the callback requested the simulation to stop */
+    bool streamOutputs(int k, std::ostream* stream);
   };
 
 } // namespace casadi
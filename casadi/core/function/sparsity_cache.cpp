@@ -0,0 +1,201 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#include "sparsity_cache.hpp"
+#include "../casadi_exception.hpp"
+#include "../std_vector_tools.hpp"
+#include <algorithm>
+#include <fstream>
+#ifdef USE_CXX11
+#include <mutex>
+#endif // USE_CXX11
+
+using namespace std;
+namespace casadi {
+
+  /// File signature
+  static const char sparsity_cache_magic[8] = {'C', 'A', 'S', 'P', 'C', 'A', 'C', 'H'};
+
+  /// Version of the file format
+  static const int sparsity_cache_version = 2;
+
+#ifdef USE_CXX11
+  /// Guards the records of all files
+  static std::mutex sparsity_cache_mtx;
+#endif // USE_CXX11
+
+  SparsityCache::File& SparsityCache::file(const string& name) {
+    static map<string, File> cache;
+    map<string, File>::iterator it = cache.find(name);
+    if (it==cache.end()) {
+      it = cache.insert(make_pair(name, File())).first;
+      it->second.rewrite = !read(name, it->second.records);
+    }
+    return it->second;
+  }
+
+  /// Whether n items of a given size can still be read from a file of a given size
+  static bool fitsInFile(istream& s, streamoff file_size, long long n, size_t item_size) {
+    streamoff left = file_size - s.tellg();
+    return n>=0 && n<=left/static_cast<streamoff>(item_size);
+  }
+
+  bool SparsityCache::read(const string& name, Records& r) {
+    ifstream s(name.c_str(), ios::binary);
+    if (!s.good()) return true; // Not yet created
+
+    // Counts read from the file are checked against its size before allocating memory
+    s.seekg(0, ios::end);
+    streamoff file_size = s.tellg();
+    s.seekg(0, ios::beg);
+
+    // Check the header
+    char magic[sizeof(sparsity_cache_magic)];
+    int version;
+    s.read(magic, sizeof(magic));
+    s.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (s.gcount()==0 && s.eof()) return true; // Empty
+    if (!s.good() || !equal(magic, magic+sizeof(magic), sparsity_cache_magic)
+        || version!=sparsity_cache_version) {
+      casadi_warning("SparsityCache: \"" << name << "\" is not a sparsity cache "
+                     "of the current version, it will be overwritten.");
+      return false;
+    }
+
+    // Read records until the end of the file
+    vector<int> colind, row;
+    vector<unsigned long long> fp;
+    while (true) {
+      int nfp, nsp;
+      s.read(reinterpret_cast<char*>(&nfp), sizeof(nfp));
+      if (s.gcount()==0 && s.eof()) return true;
+      bool ok = s.good() && nfp>0 && fitsInFile(s, file_size, nfp, sizeof(unsigned long long));
+      if (ok) {
+        fp.resize(nfp);
+        s.read(reinterpret_cast<char*>(getPtr(fp)), nfp*sizeof(unsigned long long));
+        s.read(reinterpret_cast<char*>(&nsp), sizeof(nsp));
+        ok = s.good() && fitsInFile(s, file_size, nsp, 3*sizeof(int));
+      }
+      Record rec;
+      rec.sp.resize(ok ? nsp : 0);
+      vector<Sparsity>& sp = rec.sp;
+      for (int k=0; k<sp.size() && ok; ++k) {
+        int dim[3]; // nrow (-1 if null), ncol, nnz
+        s.read(reinterpret_cast<char*>(dim), sizeof(dim));
+        ok = s.good() && dim[1]>=0 && dim[2]>=0;
+        if (!ok || dim[0]<0) continue;
+        ok = fitsInFile(s, file_size, dim[1]+1LL+dim[2], sizeof(int));
+        if (!ok) continue;
+        colind.resize(dim[1]+1);
+        row.resize(dim[2]);
+        s.read(reinterpret_cast<char*>(getPtr(colind)), colind.size()*sizeof(int));
+        s.read(reinterpret_cast<char*>(getPtr(row)), row.size()*sizeof(int));
+        ok = s.good() && colind.front()==0 && colind.back()==dim[2];
+        for (int i=0; i<dim[1] && ok; ++i) ok = colind[i]<=colind[i+1];
+        for (int el=0; el<dim[2] && ok; ++el) ok = row[el]>=0 && row[el]<dim[0];
+        if (ok) sp[k] = Sparsity(dim[0], dim[1], colind, row);
+      }
+      if (!ok) {
+        casadi_warning("SparsityCache: \"" << name << "\" is damaged, the records from "
+                       "the first damaged one on are ignored and the file will be rewritten.");
+        return false;
+      }
+      rec.fp.assign(fp.begin(), fp.end());
+      r[key(rec.fp)] = rec;
+    }
+  }
+
+  void SparsityCache::write(ostream& s, const Record& r) {
+    vector<unsigned long long> fp(r.fp.begin(), r.fp.end());
+    int nfp = fp.size();
+    int nsp = r.sp.size();
+    s.write(reinterpret_cast<const char*>(&nfp), sizeof(nfp));
+    s.write(reinterpret_cast<const char*>(getPtr(fp)), nfp*sizeof(unsigned long long));
+    s.write(reinterpret_cast<const char*>(&nsp), sizeof(nsp));
+    for (vector<Sparsity>::const_iterator it=r.sp.begin(); it!=r.sp.end(); ++it) {
+      int dim[3] = {-1, 0, 0};
+      if (!it->isNull()) {
+        dim[0] = it->size1();
+        dim[1] = it->size2();
+        dim[2] = it->size();
+      }
+      s.write(reinterpret_cast<const char*>(dim), sizeof(dim));
+      if (it->isNull()) continue;
+      s.write(reinterpret_cast<const char*>(getPtr(it->colind())), (dim[1]+1)*sizeof(int));
+      s.write(reinterpret_cast<const char*>(getPtr(it->row())), dim[2]*sizeof(int));
+    }
+  }
+
+  size_t SparsityCache::key(const Fingerprint& fp) {
+    size_t ret = 0;
+    for (Fingerprint::const_iterator it=fp.begin(); it!=fp.end(); ++it) hash_combine(ret, *it);
+    return ret;
+  }
+
+  bool SparsityCache::lookup(const string& name, const Fingerprint& fp, vector<Sparsity>& sp) {
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(sparsity_cache_mtx);
+#endif // USE_CXX11
+    Records& r = file(name).records;
+    Records::const_iterator it = r.find(key(fp));
+    if (it==r.end() || it->second.fp!=fp) return false;
+    sp = it->second.sp;
+    return true;
+  }
+
+  void SparsityCache::store(const string& name, const Fingerprint& fp,
+                            const vector<Sparsity>& sp) {
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(sparsity_cache_mtx);
+#endif // USE_CXX11
+    File& f = file(name);
+    Record& rec = f.records[key(fp)];
+    rec.fp = fp;
+    rec.sp = sp;
+
+    // Append the record, or write all records if the file has to be rewritten
+    ofstream s(name.c_str(), ios::binary | (f.rewrite ? ios::trunc : ios::app));
+    if (!s.good()) {
+      casadi_warning("SparsityCache: cannot write to \"" << name << "\".");
+      return;
+    }
+    s.seekp(0, ios::end);
+    if (s.tellp()==streampos(0)) {
+      s.write(sparsity_cache_magic, sizeof(sparsity_cache_magic));
+      s.write(reinterpret_cast<const char*>(&sparsity_cache_version),
+              sizeof(sparsity_cache_version));
+    }
+    if (f.rewrite) {
+      for (Records::const_iterator it=f.records.begin(); it!=f.records.end(); ++it) {
+        write(s, it->second);
+      }
+      f.rewrite = false;
+    } else {
+      write(s, rec);
+    }
+  }
+
+} // namespace casadi
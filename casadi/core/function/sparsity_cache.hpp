@@ -0,0 +1,93 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+#ifndef CASADI_SPARSITY_CACHE_HPP
+#define CASADI_SPARSITY_CACHE_HPP
+
+#include "../matrix/sparsity.hpp"
+#include <map>
+#include <string>
+#include <vector>
+
+/// \cond INTERNAL
+
+namespace casadi {
+
+  /** \brief Persistent cache for Jacobian sparsity patterns and seed matrices
+
+      Records are lists of sparsity patterns, identified by a fingerprint of the structure
+      of the function that produced them, and stored in a compact binary file. A record is
+      only returned if the complete fingerprint matches, not just its hash. A file is read
+      the first time it is used in the process. New records are appended to the file.
+      All operations are serialized by a lock.
+  */
+  class CASADI_EXPORT SparsityCache {
+  public:
+    /// Fingerprint of a record
+    typedef std::vector<std::size_t> Fingerprint;
+
+    /// Look up a record, returns false if there is none
+    static bool lookup(const std::string& name, const Fingerprint& fp,
+                       std::vector<Sparsity>& sp);
+
+    /// Add a record and append it to the file
+    static void store(const std::string& name, const Fingerprint& fp,
+                      const std::vector<Sparsity>& sp);
+
+  private:
+    /// A record
+    struct Record {
+      Fingerprint fp;
+      std::vector<Sparsity> sp;
+    };
+
+    /// Records of a file, by the hash of their fingerprint
+    typedef std::map<std::size_t, Record> Records;
+
+    /// Records of a file and whether the file needs to be rewritten
+    struct File {
+      Records records;
+      bool rewrite;
+    };
+
+    /// Get the records of a file, reading it if necessary
+    static File& file(const std::string& name);
+
+    /// Read the records of a file, returns false if it is damaged
+    static bool read(const std::string& name, Records& r);
+
+    /// Write a record
+    static void write(std::ostream& s, const Record& r);
+
+    /// Hash of a fingerprint
+    static std::size_t key(const Fingerprint& fp);
+  };
+
+} // namespace casadi
+
+/// \endcond
+
+#endif // CASADI_SPARSITY_CACHE_HPP
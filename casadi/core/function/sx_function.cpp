@@ -124,18 +124,22 @@ SX SXFunction::hess(int iind, int oind) {
 }
 
 const SX& SXFunction::inputExpr(int ind) const {
+  (*this)->assertSymbolic();
   return (*this)->inputv_.at(ind);
 }
 
 const SX& SXFunction::outputExpr(int ind) const {
+  (*this)->assertSymbolic();
   return (*this)->outputv_.at(ind);
 }
 
 const std::vector<SX>& SXFunction::inputExpr() const {
+  (*this)->assertSymbolic();
   return (*this)->inputv_;
 }
 
 const std::vector<SX> & SXFunction::outputExpr() const {
+  (*this)->assertSymbolic();
   return (*this)->outputv_;
 }
 
@@ -33,6 +33,10 @@
 #include "../std_vector_tools.hpp"
 #include "../sx/sx_tools.hpp"
 #include "../sx/sx_node.hpp"
+#include "../sx/symbolic_sx.hpp"
+#include "../sx/constant_sx.hpp"
+#include "../sx/unary_sx.hpp"
+#include "../sx/binary_sx.hpp"
 #include "../casadi_types.hpp"
 #include "../matrix/sparsity_internal.hpp"
 #include "../profiling.hpp"
@@ -51,6 +55,10 @@ namespace casadi {
               "compilation to a CPU or GPU using OpenCL");
     addOption("just_in_time_opencl", OT_BOOLEAN, false,
               "Just-in-time compilation for numeric evaluation using OpenCL (experimental)");
+    addOption("codegen_chunk_size", OT_INTEGER, 0,
+              "Split the generated code into functions of at most this many operations, "
+              "each of which can be compiled as a separate translation unit. "
+              "Zero (default) generates a single function.");
 
     // Check for duplicate entries among the input expressions
     bool has_duplicates = false;
@@ -101,15 +109,16 @@ namespace casadi {
   }
 
   void SXFunctionInternal::evaluate() {
+    // Record into the event buffer of this thread in binary mode
+    ProfilingScope prof(this);
+
+    // Set up timers for text profiling
+    bool profiling_text = CasadiOptions::profiling && !CasadiOptions::profilingBinary;
     double time_start=0;
     double time_stop=0;
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_start = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteEntry(CasadiOptions::profilingLog, this);
-      } else {
       CasadiOptions::profilingLog  << "start " << this << ":" <<getOption("name") << std::endl;
-      }
     }
 
     casadi_log("SXFunctionInternal::evaluate():begin  " << getOption("name"));
@@ -151,18 +160,14 @@ namespace casadi {
 
     casadi_log("SXFunctionInternal::evaluate():end " << getOption("name"));
 
-    if (CasadiOptions::profiling) {
+    if (profiling_text) {
       time_stop = getRealTime();
-      if (CasadiOptions::profilingBinary) {
-        profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
-      } else {
-        CasadiOptions::profilingLog
-          << (time_stop-time_start)*1e6 << " ns | "
-          << (time_stop-time_start)*1e3 << " ms | "
-          << this << ":" <<getOption("name")
-          << ":0||SX algorithm size: " << algorithm_.size()
-          << std::endl;
-      }
+      CasadiOptions::profilingLog
+        << (time_stop-time_start)*1e6 << " ns | "
+        << (time_stop-time_start)*1e3 << " ms | "
+        << this << ":" <<getOption("name")
+        << ":0||SX algorithm size: " << algorithm_.size()
+        << std::endl;
     }
   }
 
@@ -203,6 +208,30 @@ namespace casadi {
     return true;
   }
 
+  size_t SXFunctionInternal::getStructuralHash() const {
+    // Operations and work vector locations, but not the values of the constants
+    size_t h = algorithm_.size();
+    hash_combine(h, free_vars_.size());
+    for (vector<AlgEl>::const_iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
+      hash_combine(h, it->op);
+      hash_combine(h, it->i0);
+      switch (it->op) {
+      case OP_CONST:
+      case OP_PARAMETER:
+        break;
+      case OP_INPUT:
+      case OP_OUTPUT:
+        hash_combine(h, it->i1);
+        hash_combine(h, it->i2);
+        break;
+      default:
+        hash_combine(h, it->i1);
+        if (casadi_math<double>::ndeps(it->op)==2) hash_combine(h, it->i2);
+      }
+    }
+    return h==0 ? 1 : h;
+  }
+
   void SXFunctionInternal::print(ostream &stream) const {
     FunctionInternal::print(stream);
 
@@ -265,6 +294,12 @@ namespace casadi {
   void SXFunctionInternal::generateBody(std::ostream &stream, const std::string& type,
                                         CodeGenerator& gen) const {
 
+    // Split very large algorithms into chunks that can be compiled separately
+    if (codegen_chunk_size_>0 && algorithm_.size()>codegen_chunk_size_) {
+      generateChunks(stream, type, gen);
+      return;
+    }
+
     // Which variables have been declared
     vector<bool> declared(work_.size(), false);
 
@@ -308,7 +343,63 @@ namespace casadi {
     }
   }
 
+  void SXFunctionInternal::generateChunks(std::ostream &stream, const std::string& type,
+                                          CodeGenerator& gen) const {
+    // Pass the inputs and outputs as arrays
+    stream << "  const " << type << "* x[" << (getNumInputs()+1) << "] = {";
+    for (int i=0; i<getNumInputs(); ++i) stream << "x" << i << ", ";
+    stream << "0};" << endl;
+    stream << "  " << type << "* r[" << (getNumOutputs()+1) << "] = {";
+    for (int i=0; i<getNumOutputs(); ++i) stream << "r" << i << ", ";
+    stream << "0};" << endl;
+
+    // Explicit work array, shared by all chunks, on the stack to keep the function reentrant
+    stream << "  " << type << " w[" << std::max(work_.size(), size_t(1)) << "];" << endl;
+
+    // Signature of the chunks
+    string args = "(const " + type + "** x, " + type + "** r, " + type + "* w)";
+
+    for (int offset=0; offset<algorithm_.size(); offset+=codegen_chunk_size_) {
+      // Generate the chunk
+      stringstream body;
+      int end = std::min(offset+codegen_chunk_size_, static_cast<int>(algorithm_.size()));
+      for (vector<AlgEl>::const_iterator it = algorithm_.begin()+offset;
+           it!=algorithm_.begin()+end; ++it) {
+        body << "  ";
+        if (it->op==OP_OUTPUT) {
+          body << "if (r[" << it->i0 << "]!=0) r[" << it->i0 << "][" << it->i2 << "]="
+               << "w[" << it->i1 << "]";
+        } else {
+          body << "w[" << it->i0 << "]=";
+          if (it->op==OP_CONST) {
+            gen.printConstant(body, it->d);
+          } else if (it->op==OP_INPUT) {
+            body << "x[" << it->i1 << "][" << it->i2 << "]";
+          } else {
+            int ndep = casadi_math<double>::ndeps(it->op);
+            casadi_math<double>::printPre(it->op, body);
+            for (int c=0; c<ndep; ++c) {
+              if (c==0) {
+                body << "w[" << it->i1 << "]";
+              } else {
+                casadi_math<double>::printSep(it->op, body);
+                body << "w[" << it->i2 << "]";
+              }
+            }
+            casadi_math<double>::printPost(it->op, body);
+          }
+        }
+        body << ";" << endl;
+      }
+
+      // Call it
+      stream << "  " << gen.addChunk(getSanitizedName(), args, body.str()) << "(x, r, w);"
+             << endl;
+    }
+  }
+
   void SXFunctionInternal::init() {
+    assertSymbolic();
 
     // Call the init function of the base class
     XFunctionInternal<SXFunction, SXFunctionInternal, SX, SXNode>::init();
@@ -547,6 +638,9 @@ namespace casadi {
       }
     }
 
+    // Code generation in chunks
+    codegen_chunk_size_ = getOption("codegen_chunk_size");
+
     // Initialize just-in-time compilation for numeric evaluation using OpenCL
     just_in_time_opencl_ = getOption("just_in_time_opencl");
     if (just_in_time_opencl_) {
@@ -572,7 +666,7 @@ namespace casadi {
     }
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-
+      ProfilingLogLock lock;
       profileWriteName(CasadiOptions::profilingLog, this, getOption("name"),
                        ProfilingData_FunctionType_SXFunction, algorithm_.size());
       int alg_counter = 0;
@@ -621,12 +715,16 @@ namespace casadi {
       cout << "SXFunctionInternal::init Initialized " << getOption("name") << " ("
            << algorithm_.size() << " elementary operations)" << endl;
     }
+
+    // Release the expression graph if requested
+    if (getOption("release_symbolic")) clearSymbolic();
   }
 
   void SXFunctionInternal::evalSXsparse(const vector<SX>& arg1, vector<SX>& res1,
                                   const vector<vector<SX> >& fseed, vector<vector<SX> >& fsens,
                                   const vector<vector<SX> >& aseed, vector<vector<SX> >& asens) {
     if (verbose()) cout << "SXFunctionInternal::evalSXsparse begin" << endl;
+    assertSymbolic();
 
     // Check if arguments matches the input expressions, in which case the output is known
     // to be the output expressions
@@ -795,9 +893,52 @@ namespace casadi {
 
 
   void SXFunctionInternal::clearSymbolic() {
-    inputv_.clear();
-    outputv_.clear();
-    s_work_.clear();
+    XFunctionInternal<SXFunction, SXFunctionInternal, SX, SXNode>::clearSymbolic();
+
+    // The references to the nodes of the expression graph, free variables are kept
+    // since they prevent numerical evaluation
+    vector<SXElement>().swap(s_work_);
+    vector<SXElement>().swap(operations_);
+    vector<SXElement>().swap(constants_);
+  }
+
+  /// Memory of a node of an expression graph, constants are shared with other graphs
+  static double sxNodeMemory(const SXElement& x) {
+    if (x.isSymbolic()) return sizeof(SymbolicSX) + x.getName().capacity();
+    if (x.isConstant()) return x.isInteger() ? sizeof(IntegerSX) : sizeof(RealtypeSX);
+    return casadi_math<double>::ndeps(x.getOp())==2 ? sizeof(BinarySX) : sizeof(UnarySX);
+  }
+
+  void SXFunctionInternal::addMemoryUsage(Dictionary& mem) const {
+    XFunctionInternal<SXFunction, SXFunctionInternal, SX, SXNode>::addMemoryUsage(mem);
+    addMemory(mem, "algorithm", vectorMemory(algorithm_));
+    addMemory(mem, "work", vectorMemory(work_));
+
+    // References to the expression graph
+    double symbolic = vectorMemory(s_work_) + vectorMemory(free_vars_)
+      + vectorMemory(operations_) + vectorMemory(constants_);
+    for (int k=0; k<2; ++k) {
+      const vector<SX>& v = k==0 ? inputv_ : outputv_;
+      for (vector<SX>::const_iterator i=v.begin(); i!=v.end(); ++i) {
+        symbolic += vectorMemory(i->data());
+      }
+    }
+    addMemory(mem, "symbolic", symbolic);
+
+    // Nodes kept alive by the function, each node appears once in these lists
+    double nodes = 0;
+    for (int k=0; k<3; ++k) {
+      const vector<SXElement>& v = k==0 ? operations_ : k==1 ? constants_ : free_vars_;
+      for (vector<SXElement>::const_iterator i=v.begin(); i!=v.end(); ++i) {
+        nodes += sxNodeMemory(*i);
+      }
+    }
+    for (vector<SX>::const_iterator i=inputv_.begin(); i!=inputv_.end(); ++i) {
+      for (vector<SXElement>::const_iterator j=i->begin(); j!=i->end(); ++j) {
+        nodes += sxNodeMemory(*j);
+      }
+    }
+    addMemory(mem, "sx_nodes", nodes);
   }
 
   void SXFunctionInternal::spInit(bool fwd) {
@@ -825,9 +966,25 @@ namespace casadi {
     }
 #endif // WITH_OPENCL
 
-    // Get work array
-    bvec_t *iwork = get_bvec_t(work_);
+    // Pointers to the input and output buffers
+    vector<bvec_t*> arg(getNumInputs()), res(getNumOutputs());
+    for (int ind=0; ind<arg.size(); ++ind) arg[ind] = get_bvec_t(inputNoCheck(ind).data());
+    for (int ind=0; ind<res.size(); ++ind) res[ind] = get_bvec_t(outputNoCheck(ind).data());
 
+    // Propagate using the work array of the class
+    spEvaluateBuffered(fwd, getPtr(arg), getPtr(res), get_bvec_t(work_));
+  }
+
+  bool SXFunctionInternal::spCanEvaluateConcurrently(bool fwd) {
+#ifdef WITH_OPENCL
+    // The OpenCL kernels use buffers of the class
+    if (just_in_time_sparsity_) return false;
+#endif // WITH_OPENCL
+    return true;
+  }
+
+  void SXFunctionInternal::spEvaluateBuffered(bool fwd, bvec_t** arg, bvec_t** res,
+                                              bvec_t* iwork) {
     if (fwd) {
       // Propagate sparsity forward
       for (vector<AlgEl>::iterator it=algorithm_.begin(); it!=algorithm_.end(); ++it) {
@@ -836,9 +993,9 @@ namespace casadi {
         case OP_PARAMETER:
           iwork[it->i0] = bvec_t(0); break;
         case OP_INPUT:
-          iwork[it->i0] = reinterpret_cast<bvec_t*>(&inputNoCheck(it->i1).front())[it->i2]; break;
+          iwork[it->i0] = arg[it->i1][it->i2]; break;
         case OP_OUTPUT:
-          reinterpret_cast<bvec_t*>(&outputNoCheck(it->i0).front())[it->i2] = iwork[it->i1]; break;
+          res[it->i0][it->i2] = iwork[it->i1]; break;
         default: // Unary or binary operation
           iwork[it->i0] = iwork[it->i1] | iwork[it->i2]; break;
         }
@@ -858,11 +1015,11 @@ namespace casadi {
           iwork[it->i0] = 0;
           break;
         case OP_INPUT:
-          reinterpret_cast<bvec_t*>(&inputNoCheck(it->i1).front())[it->i2] = iwork[it->i0];
+          arg[it->i1][it->i2] = iwork[it->i0];
           iwork[it->i0] = 0;
           break;
         case OP_OUTPUT:
-          iwork[it->i1] |= reinterpret_cast<bvec_t*>(&outputNoCheck(it->i0).front())[it->i2];
+          iwork[it->i1] |= res[it->i0][it->i2];
           break;
         default: // Unary or binary operation
           seed = iwork[it->i0];
@@ -875,6 +1032,8 @@ namespace casadi {
   }
 
   Function SXFunctionInternal::getFullJacobian() {
+    assertSymbolic();
+
     // Get all the inputs
     SX arg = SX::sparse(1, 0);
     for (vector<SX>::const_iterator i=inputv_.begin(); i!=inputv_.end(); ++i) {
@@ -121,6 +121,12 @@ class CASADI_EXPORT SXFunctionInternal :
   /** \brief  Print the algorithm */
   virtual void print(std::ostream &stream) const;
 
+  /** \brief Hash of the structure of the algorithm */
+  virtual std::size_t getStructuralHash() const;
+
+  /** \brief Number of elementary operations of the algorithm */
+  virtual int getAlgorithmSize() const { return algorithm_.size();}
+
   /** \brief Hessian (forward over adjoint) via source code transformation */
   SX hess(int iind=0, int oind=0);
 
@@ -162,9 +168,18 @@ class CASADI_EXPORT SXFunctionInternal :
   virtual void generateBody(std::ostream &stream, const std::string& type,
                             CodeGenerator& gen) const;
 
+  /** \brief Generate the body as a sequence of calls to chunks operating on a work array */
+  void generateChunks(std::ostream &stream, const std::string& type, CodeGenerator& gen) const;
+
+  /// Maximum number of operations in a generated chunk, 0 for no splitting
+  int codegen_chunk_size_;
+
   /** \brief Clear the function from its symbolic representation, to free up memory,
    * no symbolic evaluations are possible after this */
-  void clearSymbolic();
+  virtual void clearSymbolic();
+
+  /// Add the algorithm, work vectors and expression graph to a memory report
+  virtual void addMemoryUsage(Dictionary& mem) const;
 
   /// Propagate a sparsity pattern through the algorithm
   virtual void spEvaluate(bool fwd);
@@ -175,6 +190,15 @@ class CASADI_EXPORT SXFunctionInternal :
   /// Reset the sparsity propagation
   virtual void spInit(bool fwd);
 
+  /// Can the sparsity be propagated concurrently with external buffers?
+  virtual bool spCanEvaluateConcurrently(bool fwd);
+
+  /// Size of the work vector for spEvaluateBuffered
+  virtual int spWorkSize() const { return work_.size();}
+
+  /// Propagate a sparsity pattern through the algorithm using external buffers
+  virtual void spEvaluateBuffered(bool fwd, bvec_t** arg, bvec_t** res, bvec_t* w);
+
   /** \brief Return Jacobian of all input elements with respect to all output elements */
   virtual Function getFullJacobian();
 
@@ -125,6 +125,17 @@ namespace casadi {
     /** \brief  Outputs of the function (needed for symbolic calculations) */
     std::vector<MatType> outputv_;
 
+    /** \brief Release the symbolic expressions to free up memory
+     * Numerical evaluation, sparsity propagation and code generation remain possible, but
+     * no new derivatives, symbolic evaluations or reinitialization */
+    virtual void clearSymbolic();
+
+    /// Raise an error if the symbolic expressions have been released
+    void assertSymbolic() const;
+
+    /// Have the symbolic expressions been released
+    bool symbolic_released_;
+
     /** \brief purge seeds from all-zeros
     *
     * If all seeds in one direction are zero, the corresponding sensitivities are set to zero
@@ -149,10 +160,15 @@ namespace casadi {
   template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
   XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::XFunctionInternal(
       const std::vector<MatType>& inputv,
-      const std::vector<MatType>& outputv) : inputv_(inputv),  outputv_(outputv) {
+      const std::vector<MatType>& outputv) : inputv_(inputv),  outputv_(outputv),
+                                             symbolic_released_(false) {
     addOption("topological_sorting", OT_STRING, "depth-first", "Topological sorting algorithm",
               "depth-first|breadth-first");
     addOption("live_variables", OT_BOOLEAN, true, "Reuse variables in the work vector");
+    addOption("release_symbolic", OT_BOOLEAN, false,
+              "Release the symbolic expressions at the end of init to free up memory. "
+              "Derivatives must be created before, the function can no longer be "
+              "differentiated, evaluated symbolically or reinitialized.");
 
     // Make sure that inputs are symbolic
     for (int i=0; i<inputv.size(); ++i) {
@@ -521,6 +537,7 @@ namespace casadi {
 
   template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
   MatType XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::grad(int iind, int oind) {
+    assertSymbolic();
     casadi_assert_message(output(oind).isScalar(),
                           "Only gradients of scalar functions allowed. Use jacobian instead.");
 
@@ -562,6 +579,7 @@ namespace casadi {
 
   template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
   MatType XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::tang(int iind, int oind) {
+    assertSymbolic();
     casadi_assert_message(input(iind).isScalar(),
                           "Only tangent of scalar input functions allowed. Use jacobian instead.");
 
@@ -595,6 +613,7 @@ namespace casadi {
                                                                           bool always_inline,
                                                                           bool never_inline) {
     using namespace std;
+    assertSymbolic();
     if (verbose()) std::cout << "XFunctionInternal::jac begin" << std::endl;
 
     // Quick return if trivially empty
@@ -661,6 +680,14 @@ namespace casadi {
       jsp_trans = jsp.transpose(mapping);
     }
 
+    // For a bidirectional partition, output nonzeros seeded in adjoint mode are
+    // recovered from the adjoint sweeps only
+    std::vector<bool> adj_out;
+    if (nfdir>0 && nadir>0) {
+      adj_out.resize(output(oind).size(), false);
+      for (int el=0; el<D2.size(); ++el) adj_out[D2.row(el)] = true;
+    }
+
     // The nonzeros of the sensitivity matrix
     std::vector<int> nzmap, nzmap2;
 
@@ -686,6 +713,15 @@ namespace casadi {
     // Sparsity of the seeds
     vector<int> seed_col, seed_row;
 
+    // With an acyclic coloring, the compressed Hessian is kept until all sweeps are done
+    bool substitute = symmetric && getOption("symmetric_coloring")=="acyclic";
+    std::vector<MatType> fsens_all;
+    std::vector<std::vector<int> > nzmap_all;
+    if (substitute) {
+      fsens_all.resize(nfdir);
+      nzmap_all.resize(nfdir);
+    }
+
     // Evaluate until everything has been determined
     for (int s=0; s<nsweep; ++s) {
       // Print progress
@@ -789,6 +825,14 @@ namespace casadi {
       // Carry out the forward sweeps
       for (int d=0; d<nfdir_batch; ++d) {
 
+        // Save the compressed Hessian for the substitution
+        if (substitute) {
+          fsens_all[offset_nfdir+d] = fsens[d][oind];
+          output(oind).sparsity().find(nzmap_all[offset_nfdir+d]);
+          fsens[d][oind].sparsity().getNZ(nzmap_all[offset_nfdir+d]);
+          continue;
+        }
+
         // If symmetric, see how many times each output appears
         if (symmetric) {
           // Initialize to zero
@@ -841,6 +885,9 @@ namespace casadi {
             // Get the output nonzero
             int r_out = jsp_trans.row(el_out);
 
+            // Skip if determined by the adjoint sweeps
+            if (!adj_out.empty() && adj_out[r_out]) continue;
+
             // Get the forward sensitivity nonzero
             int f_out = nzmap[r_out];
             if (f_out<0) continue; // Skip if structurally zero
@@ -927,6 +974,82 @@ namespace casadi {
       offset_nadir += nadir_batch;
     }
 
+    // Recover the Hessian from the compressed Hessian by substitution
+    if (substitute) {
+      if (verbose()) std::cout << "XFunctionInternal::jac substitution" << std::endl;
+
+      // Color of each input nonzero
+      std::vector<int> color(jsp.size2());
+      for (int c=0; c<nfdir; ++c) {
+        for (int el=D1.colind(c); el<D1.colind(c+1); ++el) color[D1.row(el)] = c;
+      }
+
+      // The compressed Hessian entry (v, c) is the sum of the entries (v, i) with i of color c.
+      // For each (v, c), count the entries not yet recovered and sum the ones that are
+      typedef std::pair<int, int> VC;
+      std::map<VC, int> nunknown;
+      std::map<VC, MatType> known;
+      std::vector<bool> done(jsp.size(), false);
+      for (int v=0; v<jsp.size2(); ++v) {
+        for (int el=jsp_colind[v]; el<jsp_colind[v+1]; ++el) {
+          int i = jsp_row[el];
+          if (i==v) {
+            // No neighbor shares the color of v: diagonal entries are recovered directly
+            int nz = nzmap_all[color[v]][v];
+            ret[el] = nz<0 ? MatType::zeros(1, 1) : MatType(fsens_all[color[v]][nz]);
+            done[el] = true;
+          } else {
+            nunknown[VC(v, color[i])]++;
+          }
+        }
+      }
+
+      // Peel the leaves of the two-colored trees
+      std::vector<VC> leaves;
+      for (std::map<VC, int>::const_iterator it=nunknown.begin(); it!=nunknown.end(); ++it) {
+        if (it->second==1) leaves.push_back(it->first);
+      }
+      while (!leaves.empty()) {
+        VC vc = leaves.back();
+        leaves.pop_back();
+        if (nunknown[vc]!=1) continue;
+        int v = vc.first;
+
+        // Locate the only entry (v, i) not yet recovered with i of color vc.second
+        int el;
+        for (el=jsp_colind[v]; el<jsp_colind[v+1]; ++el) {
+          int i = jsp_row[el];
+          if (!done[el] && i!=v && color[i]==vc.second) break;
+        }
+        int i = jsp_row[el];
+
+        // Subtract the entries already recovered
+        int nz = nzmap_all[vc.second][v];
+        MatType h = nz<0 ? MatType::zeros(1, 1) : MatType(fsens_all[vc.second][nz]);
+        typename std::map<VC, MatType>::iterator it = known.find(vc);
+        if (it!=known.end()) h -= it->second;
+
+        // Assign the entry and its transpose
+        ret[el] = h;
+        ret[mapping[el]] = h;
+        done[el] = done[mapping[el]] = true;
+        nunknown[vc]--;
+
+        // Update the sum for (i, color of v)
+        VC ic(i, color[v]);
+        it = known.find(ic);
+        if (it==known.end()) {
+          known.insert(std::make_pair(ic, h));
+        } else {
+          it->second += h;
+        }
+        if (--nunknown[ic]==1) leaves.push_back(ic);
+      }
+      casadi_assert_message(std::find(done.begin(), done.end(), false)==done.end(),
+                            "XFunctionInternal::jac: Hessian recovery by substitution failed, "
+                            "the coloring is not acyclic");
+    }
+
     // Return
     if (verbose()) std::cout << "XFunctionInternal::jac end" << std::endl;
     return ret.T();
@@ -1026,6 +1149,8 @@ namespace casadi {
   template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
   Function XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::getDerivative(int nfdir,
                                                                                      int nadir) {
+    assertSymbolic();
+
     // Seeds
     std::vector<std::vector<MatType> > fseed = symbolicFwdSeed(nfdir);
     std::vector<std::vector<MatType> > aseed = symbolicAdjSeed(nadir);
@@ -1070,6 +1195,21 @@ namespace casadi {
     return ret;
   }
 
+  template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
+  void XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::clearSymbolic() {
+    std::vector<MatType>().swap(inputv_);
+    std::vector<MatType>().swap(outputv_);
+    symbolic_released_ = true;
+  }
+
+  template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
+  void XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::assertSymbolic() const {
+    casadi_assert_message(!symbolic_released_,
+                          "The symbolic expressions of \"" << getOption("name")
+                          << "\" have been released with clearSymbolic or the option "
+                          "\"release_symbolic\".");
+  }
+
   template<typename PublicType, typename DerivedType, typename MatType, typename NodeType>
   void XFunctionInternal<PublicType, DerivedType, MatType, NodeType>::purgeSeeds(
     const std::vector<std::vector<MatType*> >& seed,
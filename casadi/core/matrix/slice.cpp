@@ -175,8 +175,8 @@ namespace casadi {
       }
     }
 
-    // True if reached this point
-    return true;
+    // True if all elements are covered by the nested slice
+    return it==v.end();
   }
 
   Slice::Slice(const std::vector<int>& v, Slice& outer) {
@@ -27,6 +27,9 @@
 #include "../matrix/matrix.hpp"
 #include "../std_vector_tools.hpp"
 #include <climits>
+#ifdef USE_CXX11
+#include <mutex>
+#endif // USE_CXX11
 
 using namespace std;
 
@@ -431,9 +434,33 @@ namespace casadi {
     }
   }
 
-  Sparsity::CachingMap& Sparsity::getCache() {
-    static CachingMap ret;
-    return ret;
+  /// \cond INTERNAL
+  /** \brief A shard of the cache of sparsity patterns
+   * The cache is split into shards by the hash of the pattern, each with its own lock,
+   * so that patterns can be created from several threads
+   */
+  struct SparsityCacheShard {
+    Sparsity::CachingMap cache;
+#ifdef USE_CXX11
+    std::mutex mtx;
+#endif // USE_CXX11
+    long hits, misses;
+    SparsityCacheShard() : hits(0), misses(0) {}
+  };
+  /// \endcond
+
+  /// Number of shards of the cache, a power of two
+  static const int sparsity_cache_shards = 16;
+
+  /// Get the shards of the cache
+  static SparsityCacheShard* sparsityCacheShards() {
+    static SparsityCacheShard shards[sparsity_cache_shards];
+    return shards;
+  }
+
+  /// Get the shard of the cache for a hash
+  static SparsityCacheShard& sparsityCacheShard(std::size_t h) {
+    return sparsityCacheShards()[(h ^ (h >> 16)) & (sparsity_cache_shards-1)];
   }
 
   const Sparsity& Sparsity::getScalar() {
@@ -547,6 +574,15 @@ namespace casadi {
     }
   }
 
+  bool Sparsity::bidirectionalColoring(const Sparsity& AT, Sparsity& D1, Sparsity& D2,
+                                       int adj_penalty, int cutoff) const {
+    if (AT.isNull()) {
+      return (*this)->bidirectionalColoring(T(), D1, D2, adj_penalty, cutoff);
+    } else {
+      return (*this)->bidirectionalColoring(AT, D1, D2, adj_penalty, cutoff);
+    }
+  }
+
   Sparsity Sparsity::starColoring(int ordering, int cutoff) const {
     return (*this)->starColoring(ordering, cutoff);
   }
@@ -555,6 +591,10 @@ namespace casadi {
     return (*this)->starColoring2(ordering, cutoff);
   }
 
+  Sparsity Sparsity::acyclicColoring(int ordering, int cutoff) const {
+    return (*this)->acyclicColoring(ordering, cutoff);
+  }
+
   std::vector<int> Sparsity::largestFirstOrdering() const {
     return (*this)->largestFirstOrdering();
   }
@@ -607,8 +647,12 @@ namespace casadi {
     // Hash the pattern
     std::size_t h = hash_sparsity(nrow, ncol, colind, row);
 
-    // Get a reference to the cache
-    CachingMap& cache = getCache();
+    // Get a reference to the shard of the cache and lock it
+    SparsityCacheShard& shard = sparsityCacheShard(h);
+    CachingMap& cache = shard.cache;
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // USE_CXX11
 
     // Record the current number of buckets (for garbage collection below)
 #ifdef USE_CXX11
@@ -629,17 +673,18 @@ namespace casadi {
         // Get a weak reference to the cached sparsity pattern
         WeakRef& wref = i->second;
 
-        // Check if the pattern still exists
-        if (wref.alive()) {
+        // Get an owning reference to the cached pattern, if it still exists
+        Sparsity ref = shared_cast<Sparsity>(wref.shared());
 
-          // Get an owning reference to the cached pattern
-          Sparsity ref = shared_cast<Sparsity>(wref.shared());
+        // Check if the pattern still exists
+        if (!ref.isNull()) {
 
           // Check if the pattern matches
           if (ref.isEqual(nrow, ncol, colind, row)) {
 
             // Found match!
             assignNode(ref.get());
+            shard.hits++;
             return;
 
           } else {
@@ -651,6 +696,7 @@ namespace casadi {
 
               // Create a new pattern
               assignNode(new SparsityInternal(nrow, ncol, colind, row));
+              shard.misses++;
 
               // Cache this pattern instead of the old one
               wref = *this;
@@ -669,14 +715,14 @@ namespace casadi {
           CachingMap::iterator j=i;
           j++; // Start at the next matching key
           for (; j!=eq.second; ++j) {
-            if (j->second.alive()) {
-
-              // Recover cached sparsity
-              Sparsity ref = shared_cast<Sparsity>(j->second.shared());
+            // Recover cached sparsity
+            Sparsity ref = shared_cast<Sparsity>(j->second.shared());
 
+            if (!ref.isNull()) {
               // Match found if sparsity matches
               if (ref.isEqual(nrow, ncol, colind, row)) {
                 assignNode(ref.get());
+                shard.hits++;
                 return;
               }
             }
@@ -684,6 +730,7 @@ namespace casadi {
 
           // The cached entry has been deleted, create a new one
           assignNode(new SparsityInternal(nrow, ncol, colind, row));
+          shard.misses++;
 
           // Cache this pattern
           wref = *this;
@@ -700,6 +747,7 @@ namespace casadi {
 
     // No matching sparsity pattern could be found, create a new one
     assignNode(new SparsityInternal(nrow, ncol, colind, row));
+    shard.misses++;
 
     // Cache this pattern
     //cache.insert(eq.second, std::pair<std::size_t, WeakRef>(h, ret));
@@ -724,7 +772,53 @@ namespace casadi {
   }
 
   void Sparsity::clearCache() {
-    getCache().clear();
+    for (int k=0; k<sparsity_cache_shards; ++k) {
+      SparsityCacheShard& shard = sparsityCacheShards()[k];
+#ifdef USE_CXX11
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // USE_CXX11
+      shard.cache.clear();
+      shard.hits = shard.misses = 0;
+    }
+  }
+
+  Sparsity::CacheStats Sparsity::getCacheStats() {
+    CacheStats ret = {0, 0, 0, 0, 0, 0, 0, 0};
+    for (int k=0; k<sparsity_cache_shards; ++k) {
+      SparsityCacheShard& shard = sparsityCacheShards()[k];
+#ifdef USE_CXX11
+      std::lock_guard<std::mutex> lock(shard.mtx);
+#endif // USE_CXX11
+      ret.hits += shard.hits;
+      ret.misses += shard.misses;
+      ret.entries += shard.cache.size();
+
+      // Entries and their links, bucket array
+      ret.table_bytes += shard.cache.size()
+        * (sizeof(CachingMap::value_type) + 2*sizeof(void*));
+#ifdef USE_CXX11
+      ret.table_bytes += shard.cache.bucket_count()*sizeof(void*);
+#endif // USE_CXX11
+
+      // Load of the buckets
+#ifdef USE_CXX11
+      ret.buckets += shard.cache.bucket_count();
+      for (size_t b=0; b<shard.cache.bucket_count(); ++b) {
+        long load = shard.cache.bucket_size(b);
+        ret.max_bucket_load = max(ret.max_bucket_load, load);
+      }
+#endif // USE_CXX11
+
+      // Memory of the existing patterns
+      for (CachingMap::iterator i=shard.cache.begin(); i!=shard.cache.end(); ++i) {
+        Sparsity ref = shared_cast<Sparsity>(i->second.shared());
+        if (ref.isNull()) continue;
+        ret.alive++;
+        ret.interned_bytes += sizeof(SparsityInternal)
+          + (ref.colind().capacity() + ref.row().capacity())*sizeof(int);
+      }
+    }
+    return ret;
   }
 
   Sparsity Sparsity::zz_tril(bool includeDiagonal) const {
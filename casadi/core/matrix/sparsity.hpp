@@ -210,6 +210,33 @@ namespace casadi {
 
     /** \brief Clear the cache */
     static void clearCache();
+
+#ifndef SWIG
+    /// Statistics of the cache of sparsity patterns
+    struct CacheStats {
+      /// Lookups that found an existing pattern
+      long hits;
+      /// Lookups that created a new pattern
+      long misses;
+      /// Entries in the cache, including those of deleted patterns
+      long entries;
+      /// Entries referring to existing patterns
+      long alive;
+      /// Number of hash buckets, summed over the shards
+      long buckets;
+      /// Largest number of entries in a bucket
+      long max_bucket_load;
+      /// Memory used by the existing patterns
+      long interned_bytes;
+      /// Approximate memory used by the hash tables themselves
+      long table_bytes;
+    };
+
+    /** \brief Get statistics of the cache
+     * The hit and miss counters are accumulated since the start or the last clearCache
+     */
+    static CacheStats getCacheStats();
+#endif // SWIG
     /// \endcond
 
     /** \brief Check if the dimensions and colind, row vectors are compatible.
@@ -562,9 +589,6 @@ namespace casadi {
 #ifndef SWIG
     typedef CACHING_MULTIMAP<std::size_t, WeakRef> CachingMap;
 
-    /// Cached sparsity patterns
-    static CachingMap& getCache();
-
     /// (Dense) scalar
     static const Sparsity& getScalar();
 
@@ -653,6 +677,18 @@ namespace casadi {
     Sparsity unidirectionalColoring(const Sparsity& AT=Sparsity(),
                                     int cutoff = std::numeric_limits<int>::max()) const;
 
+#ifndef SWIG
+    /** \brief Perform a bidirectional coloring, combining forward and adjoint seeds
+        The densest rows are colored for adjoint mode (D2, containing only those rows)
+        and the columns of the remaining rows for forward mode (D1). Rows listed in D2 are
+        recovered from the adjoint directions only. Returns true if a partition was found
+        with nfwd + adj_penalty*nadj less than cutoff.
+    */
+    bool bidirectionalColoring(const Sparsity& AT, Sparsity& D1, Sparsity& D2,
+                               int adj_penalty = 2,
+                               int cutoff = std::numeric_limits<int>::max()) const;
+#endif // SWIG
+
     /** \brief Perform a star coloring of a symmetric matrix:
         A greedy distance-2 coloring algorithm
         (Algorithm 4.1 in A. H. GEBREMEDHIN, F. MANNE, A. POTHEN)
@@ -667,6 +703,15 @@ namespace casadi {
     */
     Sparsity starColoring2(int ordering = 1, int cutoff = std::numeric_limits<int>::max()) const;
 
+    /** \brief Perform an acyclic coloring of a symmetric matrix:
+        A greedy distance-1 coloring in which every two-colored subgraph is a forest,
+        so that the Hessian can be recovered by substitution
+        (cf. A. H. GEBREMEDHIN, A. TARAFDAR, A. POTHEN, A. WALTHER)
+        Ordering options: None (0), largest first (1)
+    */
+    Sparsity acyclicColoring(int ordering = 1,
+                             int cutoff = std::numeric_limits<int>::max()) const;
+
     /** \brief Order the cols by decreasing degree */
     std::vector<int> largestFirstOrdering() const;
 
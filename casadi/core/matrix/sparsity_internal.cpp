@@ -1172,16 +1172,8 @@ namespace casadi {
 
 #define CS_FLIP(i) (-(i)-2)
 
-  std::vector<int> SparsityInternal::approximateMinimumDegree(int order) const {
-
-    int *Cp, *Ci, *last, *len, *nv, *next, *head, *elen, *degree, *w;
-    int *hhead, d, dk, dext, lemax = 0, e, elenk, eln, i, j, k, k1;
-    int k2, k3, jlast, ln, nzmax, mindeg = 0, nvi, nvj, nvk, mark, wnvi;
-    int ok, cnz, nel = 0, p, p1, p2, p3, p4, pj, pk, pk1, pk2, pn, q;
-
-    unsigned int h;
-
-    //-- Construct matrix C -----------------------------------------------
+  Sparsity SparsityInternal::orderingGraph(int order) const {
+    int p, p2, j;
     Sparsity AT = T() ;              // compute A'
 
     int m = nrow_;
@@ -1235,6 +1227,25 @@ namespace casadi {
     // drop diagonal entries
     C->drop(diag, 0);
 
+    return C;
+  }
+
+  std::vector<int> SparsityInternal::approximateMinimumDegree(int order) const {
+
+    int *Cp, *Ci, *last, *len, *nv, *next, *head, *elen, *degree, *w;
+    int *hhead, d, dk, dext, lemax = 0, e, elenk, eln, i, j, k, k1;
+    int k2, k3, jlast, ln, nzmax, mindeg = 0, nvi, nvj, nvk, mark, wnvi;
+    int ok, cnz, nel = 0, p, p1, p2, p3, p4, pj, pk, pk1, pk2, pn, q;
+
+    unsigned int h;
+
+    //-- Construct matrix C -----------------------------------------------
+    int n = ncol_;
+    // find dense threshold:
+    int dense = std::max(16, 10 * static_cast<int>(sqrt(static_cast<double>(n))));
+    dense = std::min(n-2, dense);
+    Sparsity C = orderingGraph(order);
+
     Cp = &C.colindRef().front();
     cnz = Cp[n] ;
 
@@ -1261,8 +1272,11 @@ namespace casadi {
       len[k] = Cp[k+1]-Cp[k];
 
     len[n] = 0;
-    nzmax = C.size();
-    Ci = &C.rowRef().front() ;
+    // add elbow room to C
+    vector<int>& C_row = C.rowRef();
+    C_row.resize(cnz + cnz/5 + 2*n);
+    nzmax = C_row.size();
+    Ci = getPtr(C_row);
     for (i=0; i<=n; ++i) {
       // degree list i is empty
       head[i] = -1;
@@ -1736,6 +1750,235 @@ namespace casadi {
     return P;
   }
 
+  /// Graph of nodes in the given order, followed by their other neighbors as a clique
+  static Sparsity ndSubgraph(const vector<int>& Cp, const vector<int>& Ci,
+                             const vector<int>& nodes, vector<int>& mark, int& last_mark,
+                             vector<int>& local) {
+    // Mark the nodes and their neighbors outside of the nodes, the boundary
+    int node_mark = ++last_mark;
+    int boundary_mark = ++last_mark;
+    int nn = nodes.size();
+    for (int k=0; k<nn; ++k) {
+      mark[nodes[k]] = node_mark;
+      local[nodes[k]] = k;
+    }
+    vector<int> boundary;
+    for (int k=0; k<nn; ++k) {
+      int v = nodes[k];
+      for (int el=Cp[v]; el<Cp[v+1]; ++el) {
+        int w = Ci[el];
+        if (mark[w]!=node_mark && mark[w]!=boundary_mark) {
+          mark[w] = boundary_mark;
+          local[w] = nn + boundary.size();
+          boundary.push_back(w);
+        }
+      }
+    }
+
+    // The boundary consists of separators that are ordered later, they end up as a clique
+    int nt = nn + boundary.size();
+    vector<int> colind(1, 0), row;
+    for (int k=0; k<nt; ++k) {
+      int v = k<nn ? nodes[k] : boundary[k-nn];
+      for (int el=Cp[v]; el<Cp[v+1]; ++el) {
+        int w = Ci[el];
+        if (mark[w]==node_mark || (k<nn && mark[w]==boundary_mark)) row.push_back(local[w]);
+      }
+      if (k>=nn) {
+        for (int j=nn; j<nt; ++j) {
+          if (j!=k) row.push_back(j);
+        }
+      }
+      sort(row.begin()+colind.back(), row.end());
+      colind.push_back(row.size());
+    }
+    return Sparsity(nt, nt, colind, row);
+  }
+
+  /// Approximate minimum degree ordering of nodes, the boundary is eliminated last
+  static vector<int> ndLeafOrdering(const vector<int>& Cp, const vector<int>& Ci,
+                                    const vector<int>& nodes, vector<int>& mark, int& last_mark,
+                                    vector<int>& local) {
+    int nn = nodes.size();
+    if (nn<=2) return nodes;
+    Sparsity sub = ndSubgraph(Cp, Ci, nodes, mark, last_mark, local);
+    vector<int> p = sub->approximateMinimumDegree(1);
+    vector<int> ret;
+    ret.reserve(nn);
+    for (int k=0; k<p.size(); ++k) {
+      if (p[k]<nn) ret.push_back(nodes[p[k]]);
+    }
+    return ret;
+  }
+
+  /// Number of nonzeros of the Cholesky factor of a symmetric pattern, not reordered
+  static double ndFill(const Sparsity& sp) {
+    Sparsity C = sp->zz_triu(true);
+    vector<int> parent = C->eliminationTree(false);
+    vector<int> post = SparsityInternal::postorder(parent, C.size2());
+    vector<int> c = C->counts(getPtr(parent), getPtr(post), 0);
+    double ret = 0;
+    for (int k=0; k<c.size(); ++k) ret += c[k];
+    return ret;
+  }
+
+  /// Nested dissection of the subgraph formed by nodes, see SparsityInternal::nestedDissection
+  static vector<int> ndOrdering(const vector<int>& Cp, const vector<int>& Ci,
+                                const vector<int>& nodes, int leaf_size, vector<int>& mark,
+                                int& last_mark, vector<int>& level, vector<int>& local) {
+    int nn = nodes.size();
+
+    // Order small subgraphs directly
+    if (nn<=leaf_size) return ndLeafOrdering(Cp, Ci, nodes, mark, last_mark, local);
+
+    // Mark the nodes of the subgraph
+    int current_mark = ++last_mark;
+    for (int k=0; k<nn; ++k) mark[nodes[k]] = current_mark;
+
+    // Nodes of the level structure, level by level, and the start of each level
+    vector<int> bfs, bfs_level;
+
+    // Find a pseudo-peripheral node by repeated breadth-first searches
+    int root = nodes.front();
+    int eccentricity = -1;
+    while (true) {
+      // Level structure rooted at root
+      for (int k=0; k<bfs.size(); ++k) level[bfs[k]] = -1;
+      bfs.clear();
+      bfs_level.clear();
+      bfs.push_back(root);
+      level[root] = 0;
+      for (int k=0; k<bfs.size(); ++k) {
+        int v = bfs[k];
+        if (level[v]==bfs_level.size()) bfs_level.push_back(k);
+        for (int el=Cp[v]; el<Cp[v+1]; ++el) {
+          int w = Ci[el];
+          if (mark[w]==current_mark && level[w]<0) {
+            level[w] = level[v]+1;
+            bfs.push_back(w);
+          }
+        }
+      }
+      bfs_level.push_back(bfs.size());
+
+      // Stop if the eccentricity no longer increases
+      int nlevel = bfs_level.size()-1;
+      if (nlevel-1<=eccentricity) break;
+      eccentricity = nlevel-1;
+
+      // Continue from a node of minimum degree in the last level
+      int min_degree = -1;
+      for (int k=bfs_level[nlevel-1]; k<bfs_level[nlevel]; ++k) {
+        int degree = Cp[bfs[k]+1]-Cp[bfs[k]];
+        if (min_degree<0 || degree<min_degree) {
+          min_degree = degree;
+          root = bfs[k];
+        }
+      }
+    }
+    int nlevel = bfs_level.size()-1;
+
+    // Not connected: order the connected components one after the other
+    if (bfs.size()<nn) {
+      vector<int> rest;
+      for (int k=0; k<nn; ++k) {
+        if (level[nodes[k]]<0) rest.push_back(nodes[k]);
+      }
+      vector<int> component;
+      component.swap(bfs);
+      for (int k=0; k<component.size(); ++k) level[component[k]] = -1;
+      vector<int> ret = ndOrdering(Cp, Ci, component, leaf_size, mark, last_mark, level, local);
+      vector<int> ret_rest = ndOrdering(Cp, Ci, rest, leaf_size, mark, last_mark, level, local);
+      ret.insert(ret.end(), ret_rest.begin(), ret_rest.end());
+      return ret;
+    }
+
+    // Too few levels for a separator
+    if (nlevel<3) {
+      for (int k=0; k<bfs.size(); ++k) level[bfs[k]] = -1;
+      return ndLeafOrdering(Cp, Ci, nodes, mark, last_mark, local);
+    }
+
+    // Separator of each level: the nodes with neighbors in the next level
+    vector<int> nsep(nlevel, 0);
+    for (int k=0; k<nn; ++k) {
+      int v = bfs[k];
+      for (int el=Cp[v]; el<Cp[v+1]; ++el) {
+        int w = Ci[el];
+        if (mark[w]==current_mark && level[w]>level[v]) {
+          nsep[level[v]]++;
+          break;
+        }
+      }
+    }
+
+    // Separator level: the smallest separator relative to the smaller part, with neither part
+    // larger than two thirds of the subgraph. Falls back to the level of the median node.
+    int sep = -1;
+    double best_ratio = 0;
+    for (int s=1; s<nlevel-1; ++s) {
+      int na = bfs_level[s+1]-nsep[s];
+      int nb = nn-bfs_level[s+1];
+      if (3*std::max(na, nb) > 2*nn) continue;
+      double ratio = nsep[s]/static_cast<double>(std::min(na, nb));
+      if (sep<0 || ratio<best_ratio) {
+        sep = s;
+        best_ratio = ratio;
+      }
+    }
+    if (sep<0) {
+      sep = 1;
+      while (sep<nlevel-2 && bfs_level[sep+1]<=nn/2) sep++;
+    }
+
+    // Parts before and after the separator
+    vector<int> part_a(bfs.begin(), bfs.begin()+bfs_level[sep]);
+    vector<int> part_b(bfs.begin()+bfs_level[sep+1], bfs.end());
+    vector<int> separator;
+
+    // Nodes of the separator level without neighbors after it join the first part
+    for (int k=bfs_level[sep]; k<bfs_level[sep+1]; ++k) {
+      int v = bfs[k];
+      bool separates = false;
+      for (int el=Cp[v]; el<Cp[v+1] && !separates; ++el) {
+        int w = Ci[el];
+        separates = mark[w]==current_mark && level[w]>sep;
+      }
+      if (separates) {
+        separator.push_back(v);
+      } else {
+        part_a.push_back(v);
+      }
+    }
+    for (int k=0; k<bfs.size(); ++k) level[bfs[k]] = -1;
+
+    // Dissect the parts and order the separator last
+    vector<int> ret = ndOrdering(Cp, Ci, part_a, leaf_size, mark, last_mark, level, local);
+    vector<int> ret_b = ndOrdering(Cp, Ci, part_b, leaf_size, mark, last_mark, level, local);
+    ret.insert(ret.end(), ret_b.begin(), ret_b.end());
+    ret.insert(ret.end(), separator.begin(), separator.end());
+
+    // Keep the dissection only if it gives less fill than ordering the subgraph directly
+    vector<int> ret_leaf = ndLeafOrdering(Cp, Ci, nodes, mark, last_mark, local);
+    double fill = ndFill(ndSubgraph(Cp, Ci, ret, mark, last_mark, local));
+    double fill_leaf = ndFill(ndSubgraph(Cp, Ci, ret_leaf, mark, last_mark, local));
+    return fill_leaf<=fill ? ret_leaf : ret;
+  }
+
+  std::vector<int> SparsityInternal::nestedDissection(int order, int leaf_size) const {
+    casadi_assert_message(leaf_size>=1, "SparsityInternal::nestedDissection: "
+                          "leaf_size must be positive, got " << leaf_size);
+    int n = ncol_;
+
+    // Graph to be dissected
+    Sparsity C = orderingGraph(order);
+
+    // Marks of the nodes, level of each node in a level structure and local indices
+    vector<int> mark(n, -1), level(n, -1), local(n, -1);
+    int last_mark = -1;
+    return ndOrdering(C.colind(), C.row(), range(n), leaf_size, mark, last_mark, level, local);
+  }
+
   int SparsityInternal::scatter(int j, std::vector<int>& w, int mark, Sparsity& C, int nz) const {
     int i, p;
     const int *Ap = &colind_.front();
@@ -1798,14 +2041,15 @@ namespace casadi {
   void SparsityInternal::prefactorize(int order, int qr, std::vector<int>& S_pinv,
                                       std::vector<int>& S_q, std::vector<int>& S_parent,
                                       std::vector<int>& S_cp, std::vector<int>& S_leftmost,
-                                      int& S_m2, double& S_lnz, double& S_unz) const {
+                                      int& S_m2, double& S_lnz, double& S_unz,
+                                      bool nested_dissection) const {
     int k;
     int n = ncol_;
     vector<int> post;
 
     // fill-reducing ordering
     if (order!=0) {
-      S_q = approximateMinimumDegree(order);
+      S_q = nested_dissection ? nestedDissection(order) : approximateMinimumDegree(order);
     }
 
     // QR symbolic analysis
@@ -3390,6 +3634,97 @@ namespace casadi {
   }
 
 
+  bool SparsityInternal::bidirectionalColoring(const Sparsity& AT, Sparsity& D1, Sparsity& D2,
+                                               int adj_penalty, int cutoff) const {
+    // Rows sorted by decreasing number of nonzeros
+    const vector<int>& AT_colind = AT.colind();
+    vector<pair<int, int> > row_nnz(nrow_);
+    for (int r=0; r<nrow_; ++r) {
+      row_nnz[r] = make_pair(-(AT_colind[r+1]-AT_colind[r]), r);
+    }
+    sort(row_nnz.begin(), row_nnz.end());
+
+    // Column of each nonzero
+    vector<int> col = getCol();
+
+    // Rows treated in adjoint mode
+    vector<bool> adj_row(nrow_, false);
+
+    // Nonzeros treated in forward and adjoint mode, respectively
+    vector<int> fwd_row, fwd_col, adj_row_nz, adj_col_nz;
+
+    // Try adjoint mode for the 1, 2, 4, ... densest rows
+    bool found = false;
+    for (int k=0, k_next=1; k_next<nrow_; k_next*=2) {
+      // Add rows to the adjoint set
+      for (; k<k_next; ++k) adj_row[row_nnz[k].second] = true;
+
+      // No gain if the rows are no longer dense
+      if (-row_nnz[k-1].first<=1) break;
+
+      // Maximum number of adjoint directions
+      int max_nadj = (cutoff-1)/adj_penalty;
+      if (max_nadj<1) break;
+
+      // Split up the nonzeros
+      fwd_row.clear();
+      fwd_col.clear();
+      adj_row_nz.clear();
+      adj_col_nz.clear();
+      for (int el=0; el<row_.size(); ++el) {
+        if (adj_row[row_[el]]) {
+          adj_row_nz.push_back(row_[el]);
+          adj_col_nz.push_back(col[el]);
+        } else {
+          fwd_row.push_back(row_[el]);
+          fwd_col.push_back(col[el]);
+        }
+      }
+
+      // Adjoint mode coloring of the dense rows
+      Sparsity A_adj = Sparsity::triplet(nrow_, ncol_, adj_row_nz, adj_col_nz);
+      Sparsity D2_all = A_adj.T().unidirectionalColoring(A_adj, max_nadj);
+      if (D2_all.isNull()) break; // More rows will not need fewer colors
+
+      // Keep only the dense rows, dropping colors that become empty
+      vector<int> D2_row, D2_col;
+      int nadj = 0;
+      for (int c=0; c<D2_all.size2(); ++c) {
+        bool empty = true;
+        for (int el=D2_all.colind(c); el<D2_all.colind(c+1); ++el) {
+          if (adj_row[D2_all.row(el)]) {
+            D2_row.push_back(D2_all.row(el));
+            D2_col.push_back(nadj);
+            empty = false;
+          }
+        }
+        if (!empty) nadj++;
+      }
+
+      // Forward mode coloring of the remaining rows
+      Sparsity D1_k;
+      int nfwd = 0;
+      if (!fwd_row.empty()) {
+        int max_nfwd = cutoff - 1 - adj_penalty*nadj;
+        if (max_nfwd<1) continue;
+        Sparsity A_fwd = Sparsity::triplet(nrow_, ncol_, fwd_row, fwd_col);
+        D1_k = A_fwd.unidirectionalColoring(A_fwd.T(), max_nfwd);
+        if (D1_k.isNull()) continue;
+        nfwd = D1_k.size2();
+      }
+
+      // Save if better
+      int cost = nfwd + adj_penalty*nadj;
+      if (cost<cutoff) {
+        D1 = D1_k;
+        D2 = Sparsity::triplet(nrow_, nadj, D2_row, D2_col);
+        cutoff = cost;
+        found = true;
+      }
+    }
+    return found;
+  }
+
   Sparsity SparsityInternal::starColoring(int ordering, int cutoff) const {
     casadi_assert_warning(ncol_==nrow_, "StarColoring requires a square matrix, but got "
                           << dimString() << ".");
@@ -3498,6 +3833,109 @@ namespace casadi {
     return Sparsity::triplet(ncol_, num_colors, range(color.size()), color);
   }
 
+  /// Find the root of a vertex in a union-find forest, with path compression
+  static int acyclicColoringRoot(map<int, int>& parent, int v) {
+    int r = v;
+    for (map<int, int>::iterator it=parent.find(r); it!=parent.end(); it=parent.find(r)) {
+      r = it->second;
+    }
+    while (v!=r) {
+      map<int, int>::iterator it=parent.find(v);
+      v = it->second;
+      it->second = r;
+    }
+    return r;
+  }
+
+  Sparsity SparsityInternal::acyclicColoring(int ordering, int cutoff) const {
+    casadi_assert_warning(ncol_==nrow_, "AcyclicColoring requires a square matrix, but got "
+                          << dimString() << ".");
+    // Reorder, if necessary
+    if (ordering!=0) {
+      casadi_assert(ordering==1);
+
+      // Ordering
+      vector<int> ord = largestFirstOrdering();
+
+      // Create a new sparsity pattern
+      Sparsity sp_permuted = pmult(ord, true, true, true);
+
+      // Acyclic coloring for the permuted matrix
+      Sparsity ret_permuted = sp_permuted.acyclicColoring(0, cutoff);
+      if (ret_permuted.isNull()) return Sparsity();
+
+      // Permute result back
+      return ret_permuted.pmult(ord, true, false, false);
+    }
+
+    // Allocate temporary vectors
+    vector<int> forbiddenColors;
+    forbiddenColors.reserve(ncol_);
+    vector<int> color(ncol_, -1);
+
+    // Two-colored subgraphs as union-find forests, indexed by pairs of colors
+    typedef map<pair<int, int>, map<int, int> > ForestMap;
+    ForestMap forest;
+
+    // Colors and roots of the colored neighbors when testing a color
+    vector<pair<int, int> > nb_roots;
+
+    for (int i=0; i<ncol_; ++i) {
+
+      // Colors of the neighbors are forbidden
+      for (int w_el=colind_[i]; w_el<colind_[i+1]; ++w_el) {
+        int w = row_[w_el];
+        if (w!=i && color[w]!=-1) forbiddenColors[color[w]] = i;
+      }
+
+      // Smallest color that does not close a two-colored cycle
+      int color_i;
+      for (color_i=0; color_i<forbiddenColors.size(); ++color_i) {
+        if (forbiddenColors[color_i]==i) continue;
+
+        // A cycle is closed if two neighbors with the same color share a two-colored tree
+        nb_roots.clear();
+        for (int w_el=colind_[i]; w_el<colind_[i+1]; ++w_el) {
+          int w = row_[w_el];
+          if (w==i || color[w]==-1) continue;
+          pair<int, int> key(min(color_i, color[w]), max(color_i, color[w]));
+          ForestMap::iterator it = forest.find(key);
+          int root = it==forest.end() ? w : acyclicColoringRoot(it->second, w);
+          nb_roots.push_back(make_pair(color[w], root));
+        }
+        sort(nb_roots.begin(), nb_roots.end());
+        if (adjacent_find(nb_roots.begin(), nb_roots.end())==nb_roots.end()) break;
+      }
+      color[i] = color_i;
+
+      // New color if reached end
+      if (color_i==forbiddenColors.size()) {
+        forbiddenColors.push_back(-1);
+
+        // Cutoff if too many colors
+        if (forbiddenColors.size()>cutoff) {
+          return Sparsity();
+        }
+      }
+
+      // Merge the two-colored trees connected by the new vertex
+      for (int w_el=colind_[i]; w_el<colind_[i+1]; ++w_el) {
+        int w = row_[w_el];
+        if (w==i || color[w]==-1) continue;
+        map<int, int>& parent = forest[make_pair(min(color_i, color[w]), max(color_i, color[w]))];
+        int r_i = acyclicColoringRoot(parent, i);
+        int r_w = acyclicColoringRoot(parent, w);
+        if (r_i!=r_w) parent[r_w] = r_i;
+      }
+    }
+
+    // Number of colors used
+    int num_colors = forbiddenColors.size();
+
+    // Return sparsity in sparse triplet format
+    return Sparsity::triplet(ncol_, num_colors, range(color.size()), color);
+  }
+
   std::vector<int> SparsityInternal::largestFirstOrdering() const {
     vector<int> degree = colind_;
     int max_degree = 0;
@@ -161,10 +161,26 @@ namespace casadi {
      */
     std::vector<int> approximateMinimumDegree(int order) const;
 
-    /// symbolic ordering and analysis for QR or LU: See cs_sqr in CSparse
+    /** Nested dissection ordering of the graph used by approximateMinimumDegree.
+     * The graph is bisected recursively by a level of a level structure rooted at a
+     * pseudo-peripheral node (cf. A. George, Nested dissection of a regular finite element
+     * mesh), the level with the smallest separator relative to the smaller part. Separators are
+     * ordered after the parts they separate, and parts with at most leaf_size nodes are ordered
+     * by approximate minimum degree, with the adjacent separators eliminated last. A subgraph
+     * is only dissected if this gives less fill than ordering it by approximate minimum degree.
+     */
+    std::vector<int> nestedDissection(int order, int leaf_size=64) const;
+
+    /// Graph of C=A+A' or C=A'*A, without diagonal entries, see approximateMinimumDegree
+    Sparsity orderingGraph(int order) const;
+
+    /** symbolic ordering and analysis for QR or LU: See cs_sqr in CSparse
+     * With nested_dissection, the columns are ordered by nestedDissection instead of
+     * approximateMinimumDegree
+     */
     void prefactorize(int order, int qr, std::vector<int>& pinv, std::vector<int>& q,
                       std::vector<int>& parent, std::vector<int>& cp, std::vector<int>& leftmost,
-                      int& m2, double& lnz, double& unz) const;
+                      int& m2, double& lnz, double& unz, bool nested_dissection=false) const;
 
     /// clear w: cs_wclear in CSparse
     static int wclear(int mark, int lemax, int *w, int n);
@@ -374,6 +390,13 @@ namespace casadi {
      */
     Sparsity unidirectionalColoring(const Sparsity& AT, int cutoff) const;
 
+    /** \brief Perform a bidirectional coloring
+     *
+     * Dense rows are colored for adjoint mode, the remaining rows for forward mode
+     */
+    bool bidirectionalColoring(const Sparsity& AT, Sparsity& D1, Sparsity& D2,
+                               int adj_penalty, int cutoff) const;
+
     /** \brief Perform a star coloring of a symmetric matrix
      *
      * A greedy distance-2 coloring algorithm
@@ -388,6 +411,13 @@ namespace casadi {
      */
     Sparsity starColoring2(int ordering, int cutoff) const;
 
+    /** \brief Perform an acyclic coloring of a symmetric matrix
+     *
+     * A greedy distance-1 coloring in which every two-colored subgraph is a forest
+     * (cf. A. H. GEBREMEDHIN, A. TARAFDAR, A. POTHEN, A. WALTHER)
+     */
+    Sparsity acyclicColoring(int ordering, int cutoff) const;
+
     /// Order the columns by decreasing degree
     std::vector<int> largestFirstOrdering() const;
 
@@ -25,6 +25,12 @@
 
 #include "profiling.hpp"
 
+#include <algorithm>
+
+#ifdef USE_CXX11
+#include <mutex>
+#endif // USE_CXX11
+
 namespace casadi {
 
 #ifdef WITH_PROFILING
@@ -126,4 +132,155 @@ double getRealTime() {
  double getRealTime() { return 0; }
 #endif
 
+  namespace {
+    /// Number of events in each per-thread buffer, a power of two
+    const unsigned long profiling_buffer_size = 1 << 14;
+
+#ifdef USE_CXX11
+    std::recursive_mutex& profilingLogMutex() {
+      static std::recursive_mutex m;
+      return m;
+    }
+
+    std::mutex& profilingRegistryMutex() {
+      static std::mutex m;
+      return m;
+    }
+#endif // USE_CXX11
+
+    /// All buffers ever created, they live until the process exits
+    std::vector<ProfilingBuffer*>& profilingRegistry() {
+      static std::vector<ProfilingBuffer*> r;
+      return r;
+    }
+  } // namespace
+
+  ProfilingLogLock::ProfilingLogLock() {
+#ifdef USE_CXX11
+    profilingLogMutex().lock();
+#endif // USE_CXX11
+  }
+
+  ProfilingLogLock::~ProfilingLogLock() {
+#ifdef USE_CXX11
+    profilingLogMutex().unlock();
+#endif // USE_CXX11
+  }
+
+  /// Hands the buffer of a thread back to the registry when the thread exits
+  class ProfilingThread {
+  public:
+    ProfilingThread() : buf(0) {}
+    ~ProfilingThread() {
+      if (buf==0) return;
+      buf->flush();
+#ifdef USE_CXX11
+      std::lock_guard<std::mutex> lock(profilingRegistryMutex());
+#endif // USE_CXX11
+      buf->owned_ = false;
+    }
+    ProfilingBuffer* buf;
+  };
+
+  ProfilingBuffer::ProfilingBuffer(int thread) :
+    depth(0), calls(0), recording(false), thread_(thread), owned_(true),
+    data_(profiling_buffer_size), head_(0), tail_(0) {
+  }
+
+  ProfilingBuffer* ProfilingBuffer::local() {
+#ifdef USE_CXX11
+    static thread_local ProfilingThread t;
+#else // USE_CXX11
+    static ProfilingThread t;
+#endif // USE_CXX11
+    if (t.buf) return t.buf;
+
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(profilingRegistryMutex());
+#endif // USE_CXX11
+    std::vector<ProfilingBuffer*>& r = profilingRegistry();
+
+    // Reuse the buffer of a thread that has exited
+    for (std::vector<ProfilingBuffer*>::iterator it=r.begin(); it!=r.end(); ++it) {
+      if (!(*it)->owned_) {
+        (*it)->owned_ = true;
+        (*it)->depth = 0;
+        return t.buf = *it;
+      }
+    }
+    r.push_back(new ProfilingBuffer(r.size()));
+    return t.buf = r.back();
+  }
+
+  void ProfilingBuffer::flushAll() {
+    ProfilingLogLock lock;
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock2(profilingRegistryMutex());
+#endif // USE_CXX11
+    std::vector<ProfilingBuffer*>& r = profilingRegistry();
+    for (std::vector<ProfilingBuffer*>::iterator it=r.begin(); it!=r.end(); ++it) {
+      (*it)->drain();
+    }
+  }
+
+  void ProfilingBuffer::flush() {
+    ProfilingLogLock lock;
+    drain();
+  }
+
+  void ProfilingBuffer::drain() {
+#ifdef USE_CXX11
+    unsigned long t = tail_.load(std::memory_order_relaxed);
+    unsigned long h = head_.load(std::memory_order_acquire);
+#else // USE_CXX11
+    unsigned long t = tail_, h = head_;
+#endif // USE_CXX11
+    if (h==t) return;
+
+    // Events are written in at most two contiguous chunks
+    std::ofstream& f = CasadiOptions::profilingLog;
+    if (f.is_open()) {
+      ProfilingData_EVENTS s;
+      s.thread = thread_;
+      s.count = h - t;
+      profileWrite(f, s);
+      unsigned long n = data_.size();
+      unsigned long first = std::min(h-t, n - (t & (n-1)));
+      f.write(reinterpret_cast<const char*>(&data_[t & (n-1)]),
+              first*sizeof(ProfilingData_EVENT));
+      f.write(reinterpret_cast<const char*>(&data_[0]),
+              (h-t-first)*sizeof(ProfilingData_EVENT));
+    }
+
+#ifdef USE_CXX11
+    tail_.store(h, std::memory_order_release);
+#else // USE_CXX11
+    tail_ = h;
+#endif // USE_CXX11
+  }
+
+  void ProfilingScope::enter(const void* thisp) {
+    buf_ = ProfilingBuffer::local();
+    if (buf_->depth++==0) {
+      buf_->recording = buf_->calls++ % CasadiOptions::profilingSampling == 0;
+    }
+    recording_ = buf_->recording;
+    if (recording_) {
+      std::memcpy(&thisp_, &thisp, sizeof(thisp));
+      start_ = getTicks();
+    }
+  }
+
+  void ProfilingScope::leave() {
+    if (recording_) {
+      ProfilingData_EVENT e;
+      e.start = start_;
+      e.stop = getTicks();
+      e.thisp = thisp_;
+      e.line_number = -1;
+      buf_->push(e);
+    }
+    buf_->depth--;
+  }
+
 } // namespace casadi
@@ -29,8 +29,22 @@
 #include <fstream>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 #include "casadi_common.hpp"
+#include "casadi_options.hpp"
+
+#ifdef USE_CXX11
+#include <atomic>
+#endif // USE_CXX11
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CASADI_PROFILING_RDTSC
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define CASADI_PROFILING_RDTSC
+#endif
 
 namespace casadi {
 /// \cond INTERNAL
@@ -51,12 +65,29 @@ namespace casadi {
  */
 CASADI_EXPORT double getRealTime();
 
+/**
+ * Returns a cheap, monotonically increasing tick count.
+ *
+ * This is the processor time stamp counter where the compiler exposes it, and
+ * getRealTime() in nanoseconds otherwise. Ticks are converted to seconds with the
+ * ProfilingData_CLOCK records that bracket a profiling session.
+ */
+inline unsigned long long getTicks() {
+#ifdef CASADI_PROFILING_RDTSC
+  return __rdtsc();
+#else // CASADI_PROFILING_RDTSC
+  return static_cast<unsigned long long>(getRealTime()*1e9);
+#endif // CASADI_PROFILING_RDTSC
+}
+
 enum ProfilingData_Type { ProfilingData_Type_TIMELINE,
                           ProfilingData_Type_SOURCE,
                           ProfilingData_Type_NAME,
                           ProfilingData_Type_ENTRY,
                           ProfilingData_Type_EXIT,
-                          ProfilingData_Type_IO };
+                          ProfilingData_Type_IO,
+                          ProfilingData_Type_CLOCK,
+                          ProfilingData_Type_EVENTS };
 
 enum ProfilingData_FunctionType { ProfilingData_FunctionType_MXFunction,
                                   ProfilingData_FunctionType_SXFunction,
@@ -66,6 +97,7 @@ struct ProfilingHeader {
   ProfilingData_Type type;
 };
 
+/// Legacy record, no longer written but still understood by profilereport
 struct ProfilingData_TIMELINE {
   double local;
   double total;
@@ -96,15 +128,37 @@ struct ProfilingData_IO {
   int ndata;
 };
 
+/// Legacy record, no longer written but still understood by profilereport
 struct ProfilingData_ENTRY {
   long thisp;
 };
 
+/// Legacy record, no longer written but still understood by profilereport
 struct ProfilingData_EXIT {
   double total;
   long thisp;
 };
 
+/// Ties the tick counter to the real time, written when profiling starts and stops
+struct ProfilingData_CLOCK {
+  unsigned long long ticks;
+  double time;
+};
+
+/// Header of a batch of events recorded by one thread, followed by count ProfilingData_EVENT
+struct ProfilingData_EVENTS {
+  int thread;
+  int count;
+};
+
+/// A timed span, either a whole call (line_number -1) or one line of an algorithm
+struct ProfilingData_EVENT {
+  unsigned long long start;
+  unsigned long long stop;
+  long thisp;
+  int line_number;
+};
+
 template<typename T>
 ProfilingData_Type ProfilingType();
 
@@ -126,6 +180,12 @@ inline ProfilingData_Type ProfilingType<ProfilingData_EXIT>()
 template<>
 inline ProfilingData_Type ProfilingType<ProfilingData_IO>()
 { return ProfilingData_Type_IO; }
+template<>
+inline ProfilingData_Type ProfilingType<ProfilingData_CLOCK>()
+{ return ProfilingData_Type_CLOCK; }
+template<>
+inline ProfilingData_Type ProfilingType<ProfilingData_EVENTS>()
+{ return ProfilingData_Type_EVENTS; }
 
 
 template<typename T>
@@ -176,32 +236,6 @@ void profileWriteName(std::ofstream &f, T *a, const std::string &name,
   }
 }
 
-template<typename T>
-void profileWriteEntry(std::ofstream &f, T *a) {
-  ProfilingData_ENTRY s;
-  s.thisp=ptrToLong(a);
-  profileWrite(f, s);
-}
-
-template<typename T>
-void profileWriteExit(std::ofstream &f, T *a, double total) {
-  ProfilingData_EXIT s;
-  s.thisp=ptrToLong(a);
-  s.total=total;
-  profileWrite(f, s);
-}
-
-template<typename T>
-void profileWriteTime(std::ofstream &f, T *a, int line_number, double local, double total) {
-  ProfilingData_TIMELINE s;
-  s.local = local;
-  s.total = total;
-  s.thisp = ptrToLong(a);
-  s.line_number = line_number;
-  profileWrite(f, s);
-}
-
-
 template<typename T, typename T2>
 void profileWriteSourceLine(std::ofstream &f, T *a, int line_number, const std::string &sourceline,
                             int opcode, T2 *dependency) {
@@ -228,6 +262,118 @@ void profileWriteSourceLine(std::ofstream &f, T *a, int line_number,
   f << sourceline;
 }
 
+/** \brief Serializes writes to CasadiOptions::profilingLog for as long as it lives
+ *
+ * Only needed for records written outside of the event buffers, e.g. names and source lines.
+ */
+class CASADI_EXPORT ProfilingLogLock {
+ public:
+  ProfilingLogLock();
+  ~ProfilingLogLock();
+ private:
+  ProfilingLogLock(const ProfilingLogLock&);
+  ProfilingLogLock& operator=(const ProfilingLogLock&);
+};
+
+/** \brief Per-thread ring buffer of profiling events
+ *
+ * The owning thread is the only producer and never takes a lock, unless the ring is full
+ * and it has to write out the pending events itself. Consumers are serialized by the
+ * profiling log lock.
+ */
+class CASADI_EXPORT ProfilingBuffer {
+ public:
+  /// Buffer of the calling thread, created and registered on first use
+  static ProfilingBuffer* local();
+
+  /// Write out the pending events of all threads, acquires the profiling log lock
+  static void flushAll();
+
+  /// Append an event
+  void push(const ProfilingData_EVENT& e) {
+#ifdef USE_CXX11
+    unsigned long h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) == data_.size()) flush();
+    data_[h & (data_.size()-1)] = e;
+    head_.store(h+1, std::memory_order_release);
+#else // USE_CXX11
+    if (head_ - tail_ == data_.size()) flush();
+    data_[head_ & (data_.size()-1)] = e;
+    head_++;
+#endif // USE_CXX11
+  }
+
+  /// Write out the pending events, acquires the profiling log lock
+  void flush();
+
+  /// Write out the pending events, the profiling log lock must be held
+  void drain();
+
+  /// Nesting depth of the profiled calls on the owning thread
+  int depth;
+
+  /// Number of outermost calls made on the owning thread, for sampling
+  unsigned long calls;
+
+  /// Whether the current outermost call is being recorded
+  bool recording;
+
+ private:
+  explicit ProfilingBuffer(int thread);
+
+  int thread_;
+  bool owned_;
+  std::vector<ProfilingData_EVENT> data_;
+#ifdef USE_CXX11
+  std::atomic<unsigned long> head_, tail_;
+#else // USE_CXX11
+  unsigned long head_, tail_;
+#endif // USE_CXX11
+
+  friend class ProfilingThread;
+};
+
+/** \brief Records a call to a function in the profiling event buffers
+ *
+ * Construct at the start of an evaluation and let it go out of scope at its end.
+ * Only every CasadiOptions::profilingSampling-th outermost call on a thread is recorded,
+ * together with everything nested inside of it.
+ */
+class CASADI_EXPORT ProfilingScope {
+ public:
+  explicit ProfilingScope(const void* thisp) : buf_(0), recording_(false) {
+    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) enter(thisp);
+  }
+
+  ~ProfilingScope() { if (buf_) leave(); }
+
+  /// Is the call being recorded
+  bool active() const { return recording_; }
+
+  /// Record that a line of the algorithm ran from start until now
+  void line(int line_number, unsigned long long start) {
+    if (!recording_) return;
+    ProfilingData_EVENT e;
+    e.start = start;
+    e.stop = getTicks();
+    e.thisp = thisp_;
+    e.line_number = line_number;
+    buf_->push(e);
+  }
+
+ private:
+  void enter(const void* thisp);
+  void leave();
+
+  ProfilingScope(const ProfilingScope&);
+  ProfilingScope& operator=(const ProfilingScope&);
+
+  ProfilingBuffer* buf_;
+  bool recording_;
+  long thisp_;
+  unsigned long long start_;
+};
+
 /// \endcond
 } // namespace casadi
 
@@ -80,6 +80,47 @@ namespace casadi {
   template<typename real_t>
   void casadi_trans(const real_t* x, const int* sp_x, real_t* y, const int* sp_y, int *tmp);
 
+  /// DENSIFY: y <- x, y dense and column-major
+  template<typename real_t>
+  void casadi_densify(const real_t* x, const int* sp_x, real_t* y);
+
+  /// NORM_INF: ||x||_inf -> return
+  template<typename real_t>
+  real_t casadi_norm_inf(int n, const real_t* x);
+
+  /// MAX_VIOL: largest violation of lb <= x <= ub, or zero -> return
+  template<typename real_t>
+  real_t casadi_max_viol(int n, const real_t* x, const real_t* lb, const real_t* ub);
+
+  /// CHOL: A <- L, lower triangular with L*L' = A, A dense n-by-n. Returns 1 if A is not positive definite
+  template<typename real_t>
+  int casadi_chol(int n, real_t* A);
+
+  /// CHOL_SOLVE: x <- inv(L*L')*x
+  template<typename real_t>
+  void casadi_chol_solve(int n, const real_t* L, real_t* x);
+
+  /// y <- C*x with C = [I; -I; A; -A], the one-sided constraints of casadi_qp_dense
+  template<typename real_t>
+  void casadi_qp_dense_c(int n, int m, const real_t* A, const real_t* x, real_t* y);
+
+  /// y <- C'*v with C = [I; -I; A; -A]
+  template<typename real_t>
+  void casadi_qp_dense_ct(int n, int m, const real_t* A, const real_t* v, real_t* y);
+
+  /// Newton step of casadi_qp_dense, given the Cholesky factor L of the reduced Hessian
+  template<typename real_t>
+  void casadi_qp_dense_step(int n, int m, const real_t* A, const real_t* L, const real_t* rd, const real_t* rp, const real_t* rc, const real_t* s, const real_t* z, real_t* dx, real_t* ds, real_t* dz, real_t* v);
+
+  /** \brief Dense QP solver: min 1/2*x'*H*x + g'*x, s.t. lbx <= x <= ubx, lba <= A*x <= uba
+   *
+   * Primal-dual interior point method with Mehrotra's predictor-corrector, H (n-by-n) and
+   * A (m-by-n) dense and column-major. x holds the initial guess on entry. The work vector w
+   * has length n*n + 2*n + 18*(n+m). Returns the number of iterations, or -1 on failure.
+   */
+  template<typename real_t>
+  int casadi_qp_dense(int n, int m, const real_t* H, const real_t* g, const real_t* A, const real_t* lbx, const real_t* ubx, const real_t* lba, const real_t* uba, real_t* x, real_t* lam_x, real_t* lam_a, int max_iter, real_t tol, real_t* w);
+
 }
 
 // Implementations
@@ -288,6 +329,206 @@ namespace casadi {
     }
   }
 
+  template<typename real_t>
+  void casadi_densify(const real_t* x, const int* sp_x, real_t* y) {
+    int nrow_x = sp_x[0];
+    int ncol_x = sp_x[1];
+    const int* colind_x = sp_x+2;
+    const int* row_x = sp_x + 2 + ncol_x+1;
+    int i, el;
+    for (i=0; i<nrow_x*ncol_x; ++i) y[i] = 0;
+    for (i=0; i<ncol_x; ++i) {
+      for (el=colind_x[i]; el<colind_x[i+1]; ++el) y[row_x[el] + i*nrow_x] = x[el];
+    }
+  }
+
+  template<typename real_t>
+  real_t casadi_norm_inf(int n, const real_t* x) {
+    real_t ret = 0;
+    int i;
+    for (i=0; i<n; ++i) {
+      if (fabs(x[i])>ret) ret = fabs(x[i]);
+    }
+    return ret;
+  }
+
+  template<typename real_t>
+  real_t casadi_max_viol(int n, const real_t* x, const real_t* lb, const real_t* ub) {
+    real_t ret = 0;
+    int i;
+    for (i=0; i<n; ++i) {
+      if (lb[i]-x[i]>ret) ret = lb[i]-x[i];
+      if (x[i]-ub[i]>ret) ret = x[i]-ub[i];
+    }
+    return ret;
+  }
+
+  template<typename real_t>
+  int casadi_chol(int n, real_t* A) {
+    real_t t, r;
+    int i, j, k;
+    for (j=0; j<n; ++j) {
+      t = A[j+j*n];
+      for (k=0; k<j; ++k) t -= A[j+k*n]*A[j+k*n];
+      if (!(t>0)) return 1;
+      t = sqrt(t);
+      A[j+j*n] = t;
+      for (i=j+1; i<n; ++i) {
+        r = A[i+j*n];
+        for (k=0; k<j; ++k) r -= A[i+k*n]*A[j+k*n];
+        A[i+j*n] = r/t;
+      }
+    }
+    return 0;
+  }
+
+  template<typename real_t>
+  void casadi_chol_solve(int n, const real_t* L, real_t* x) {
+    int i, k;
+    for (i=0; i<n; ++i) {
+      for (k=0; k<i; ++k) x[i] -= L[i+k*n]*x[k];
+      x[i] /= L[i+i*n];
+    }
+    for (i=n-1; i>=0; --i) {
+      for (k=i+1; k<n; ++k) x[i] -= L[k+i*n]*x[k];
+      x[i] /= L[i+i*n];
+    }
+  }
+
+  template<typename real_t>
+  void casadi_qp_dense_c(int n, int m, const real_t* A, const real_t* x, real_t* y) {
+    int i, j;
+    for (j=0; j<m; ++j) y[2*n+j] = 0;
+    for (i=0; i<n; ++i) {
+      y[i] = x[i];
+      y[n+i] = -x[i];
+      for (j=0; j<m; ++j) y[2*n+j] += A[j+i*m]*x[i];
+    }
+    for (j=0; j<m; ++j) y[2*n+m+j] = -y[2*n+j];
+  }
+
+  template<typename real_t>
+  void casadi_qp_dense_ct(int n, int m, const real_t* A, const real_t* v, real_t* y) {
+    int i, j;
+    for (i=0; i<n; ++i) {
+      y[i] = v[i] - v[n+i];
+      for (j=0; j<m; ++j) y[i] += A[j+i*m]*(v[2*n+j] - v[2*n+m+j]);
+    }
+  }
+
+  template<typename real_t>
+  void casadi_qp_dense_step(int n, int m, const real_t* A, const real_t* L, const real_t* rd, const real_t* rp, const real_t* rc, const real_t* s, const real_t* z, real_t* dx, real_t* ds, real_t* dz, real_t* v) {
+    int i, k, nc = 2*(n+m);
+    for (k=0; k<nc; ++k) v[k] = (rc[k] + z[k]*rp[k])/s[k];
+    casadi_qp_dense_ct(n, m, A, v, dx);
+    for (i=0; i<n; ++i) dx[i] = -rd[i] - dx[i];
+    casadi_chol_solve(n, L, dx);
+    casadi_qp_dense_c(n, m, A, dx, ds);
+    for (k=0; k<nc; ++k) {
+      ds[k] += rp[k];
+      dz[k] = -(rc[k] + z[k]*ds[k])/s[k];
+    }
+  }
+
+  template<typename real_t>
+  int casadi_qp_dense(int n, int m, const real_t* H, const real_t* g, const real_t* A, const real_t* lbx, const real_t* ubx, const real_t* lba, const real_t* uba, real_t* x, real_t* lam_x, real_t* lam_a, int max_iter, real_t tol, real_t* w) {
+    int i, j, k, iter, flag, nc = 2*(n+m), na = 0;
+    real_t mu, mu_aff, sigma, alpha, reg, pr, du, t;
+    real_t *L = w, *b = L+n*n, *s = b+nc, *z = s+nc, *ds = z+nc, *dz = ds+nc;
+    real_t *rp = dz+nc, *rc = rp+nc, *v = rc+nc, *cx = v+nc, *rd = cx+nc, *dx = rd+n;
+    /* One-sided constraints C*x >= b, rows without a finite bound are inactive */
+    for (i=0; i<n; ++i) {
+      b[i] = lbx[i];
+      b[n+i] = -ubx[i];
+      if (x[i]<lbx[i]) x[i] = lbx[i];
+      if (x[i]>ubx[i]) x[i] = ubx[i];
+    }
+    for (j=0; j<m; ++j) {
+      b[2*n+j] = lba[j];
+      b[2*n+m+j] = -uba[j];
+    }
+    /* Initial slacks of at least one, unit multipliers */
+    casadi_qp_dense_c(n, m, A, x, cx);
+    for (k=0; k<nc; ++k) {
+      if (b[k] > -HUGE_VAL) {
+        s[k] = cx[k] - b[k];
+        if (s[k]<1) s[k] = 1;
+        z[k] = 1;
+        na++;
+      } else {
+        s[k] = 1;
+        z[k] = 0;
+      }
+    }
+    for (iter=0; iter<max_iter; ++iter) {
+      /* Residuals and duality measure */
+      casadi_qp_dense_c(n, m, A, x, cx);
+      pr = mu = 0;
+      for (k=0; k<nc; ++k) {
+        rp[k] = b[k] > -HUGE_VAL ? cx[k] - b[k] - s[k] : 0;
+        if (fabs(rp[k])>pr) pr = fabs(rp[k]);
+        mu += s[k]*z[k];
+      }
+      if (na>0) mu /= na;
+      casadi_qp_dense_ct(n, m, A, z, rd);
+      du = 0;
+      for (i=0; i<n; ++i) {
+        rd[i] = g[i] - rd[i];
+        for (j=0; j<n; ++j) rd[i] += H[i+j*n]*x[j];
+        if (fabs(rd[i])>du) du = fabs(rd[i]);
+      }
+      if (pr<=tol && du<=tol && mu<=tol) break;
+      /* Factorize H + C'*diag(z/s)*C, regularized if not positive definite */
+      reg = 0;
+      do {
+        for (i=0; i<n*n; ++i) L[i] = H[i];
+        for (i=0; i<n; ++i) L[i+i*n] += reg + z[i]/s[i] + z[n+i]/s[n+i];
+        for (j=0; j<m; ++j) {
+          t = z[2*n+j]/s[2*n+j] + z[2*n+m+j]/s[2*n+m+j];
+          for (i=0; i<n; ++i) {
+            for (k=0; k<n; ++k) L[i+k*n] += t*A[j+i*m]*A[j+k*m];
+          }
+        }
+        flag = casadi_chol(n, L);
+        reg = reg==0 ? 1e-8 : 10*reg;
+      } while (flag && reg<1e10);
+      if (flag) return -1;
+      /* Affine scaling direction */
+      for (k=0; k<nc; ++k) rc[k] = s[k]*z[k];
+      casadi_qp_dense_step(n, m, A, L, rd, rp, rc, s, z, dx, ds, dz, v);
+      alpha = 1;
+      for (k=0; k<nc; ++k) {
+        if (!(b[k] > -HUGE_VAL)) continue;
+        if (ds[k]<0 && -s[k]/ds[k]<alpha) alpha = -s[k]/ds[k];
+        if (dz[k]<0 && -z[k]/dz[k]<alpha) alpha = -z[k]/dz[k];
+      }
+      mu_aff = 0;
+      for (k=0; k<nc; ++k) mu_aff += (s[k]+alpha*ds[k])*(z[k]+alpha*dz[k]);
+      if (na>0) mu_aff /= na;
+      t = mu>0 ? mu_aff/mu : 0;
+      sigma = t*t*t;
+      /* Centering-corrector direction */
+      for (k=0; k<nc; ++k) rc[k] = b[k] > -HUGE_VAL ? s[k]*z[k] + ds[k]*dz[k] - sigma*mu : 0;
+      casadi_qp_dense_step(n, m, A, L, rd, rp, rc, s, z, dx, ds, dz, v);
+      alpha = 1;
+      for (k=0; k<nc; ++k) {
+        if (!(b[k] > -HUGE_VAL)) continue;
+        if (ds[k]<0 && -0.99*s[k]/ds[k]<alpha) alpha = -0.99*s[k]/ds[k];
+        if (dz[k]<0 && -0.99*z[k]/dz[k]<alpha) alpha = -0.99*z[k]/dz[k];
+      }
+      for (i=0; i<n; ++i) x[i] += alpha*dx[i];
+      for (k=0; k<nc; ++k) {
+        if (!(b[k] > -HUGE_VAL)) continue;
+        s[k] += alpha*ds[k];
+        z[k] += alpha*dz[k];
+      }
+    }
+    /* Multipliers, positive for active upper bounds */
+    for (i=0; i<n; ++i) lam_x[i] = z[n+i] - z[i];
+    for (j=0; j<m; ++j) lam_a[j] = z[2*n+m+j] - z[2*n+j];
+    return iter<max_iter ? iter : -1;
+  }
+
 }
 
 /// \endcond
@@ -30,6 +30,9 @@
 #include "casadi_exception.hpp"
 #include <map>
 #include <vector>
+#ifdef USE_CXX11
+#include <atomic>
+#endif // USE_CXX11
 
 namespace casadi {
 
@@ -195,6 +198,7 @@ namespace casadi {
   /// Internal class for the reference counting framework, see comments on the public class.
   class CASADI_EXPORT SharedObjectNode {
     friend class SharedObject;
+    friend class WeakRef;
   public:
 
     /// Default constructor
@@ -261,7 +265,11 @@ namespace casadi {
 
   private:
     /// Number of references pointing to the object
+#ifdef USE_CXX11
+    std::atomic<unsigned int> count;
+#else // USE_CXX11
     unsigned int count;
+#endif // USE_CXX11
 
     /// Weak pointer (non-owning) object for the object
     WeakRef* weak_ref_;
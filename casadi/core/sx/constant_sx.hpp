@@ -123,6 +123,9 @@ class CASADI_EXPORT RealtypeSX : public ConstantSX {
       }
     }
 
+    /// Number of constants currently allocated
+    inline static size_t numCached() { return cached_constants_.size();}
+
     ///@{
     /** \brief  Get the value */
     virtual double getValue() const { return value;}
@@ -179,6 +182,9 @@ class CASADI_EXPORT IntegerSX : public ConstantSX {
       }
     }
 
+    /// Number of constants currently allocated
+    inline static size_t numCached() { return cached_constants_.size();}
+
     ///@{
     /** \brief  evaluate function */
     virtual double getValue() const {  return value; }
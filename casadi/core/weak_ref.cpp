@@ -24,24 +24,56 @@
 
 
 #include "weak_ref.hpp"
+#ifdef USE_CXX11
+#include <mutex>
+#endif // USE_CXX11
 
 using namespace std;
 
 namespace casadi {
 
+#ifdef USE_CXX11
+  /** \brief Lock that serializes access to a weak reference with the deletion of the object
+   * The locks are shared between weak references, selected by address
+   */
+  static std::mutex& weakRefMutex(const void* w) {
+    static std::mutex m[32];
+    return m[(reinterpret_cast<size_t>(w) >> 4) % 32];
+  }
+#endif // USE_CXX11
+
   WeakRef::WeakRef(int dummy) {
     casadi_assert(dummy==0);
   }
 
   bool WeakRef::alive() const {
-    return !isNull() && (*this)->raw_ != 0;
+    if (isNull()) return false;
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(weakRefMutex(get()));
+#endif // USE_CXX11
+    // An object with no references left is being deleted
+    const SharedObjectNode* raw = (*this)->raw_;
+    return raw!=0 && raw->count!=0;
   }
 
   SharedObject WeakRef::shared() {
     SharedObject ret;
-    if (alive()) {
-      ret.assignNode((*this)->raw_);
-    }
+    if (isNull()) return ret;
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(weakRefMutex(get()));
+#endif // USE_CXX11
+    SharedObjectNode* raw = (*this)->raw_;
+    if (raw==0) return ret;
+
+    // Take a reference, unless the object is being deleted
+#ifdef USE_CXX11
+    unsigned int c = raw->count;
+    while (c!=0 && !raw->count.compare_exchange_weak(c, c+1)) {}
+#else // USE_CXX11
+    unsigned int c = raw->count;
+    if (c!=0) raw->count++;
+#endif // USE_CXX11
+    if (c!=0) ret.assignNodeNoCount(raw);
     return ret;
   }
 
@@ -62,6 +94,9 @@ namespace casadi {
   }
 
   void WeakRef::kill() {
+#ifdef USE_CXX11
+    std::lock_guard<std::mutex> lock(weakRefMutex(get()));
+#endif // USE_CXX11
     (*this)->raw_ = 0;
   }
 
@@ -25,6 +25,7 @@
 
 #include "csparse_cholesky_internal.hpp"
 #include "casadi/core/matrix/matrix_tools.hpp"
+#include "casadi/core/matrix/sparsity_internal.hpp"
 
 /// \cond INTERNAL
 
@@ -51,6 +52,10 @@ namespace casadi {
     L_ = 0;
     S_ = 0;
 
+    addOption("ordering", OT_STRING, "natural", "Fill-reducing symmetric ordering",
+              "natural: no reordering|amd: approximate minimum degree of A+A'|"
+              "nested_dissection: nested dissection of A+A'");
+
     casadi_assert_message(sparsity.isSymmetric(),
                           "CSparseCholeskyInternal: supplied sparsity must be symmetric, got "
                           << sparsity.dimString() << ".");
@@ -88,9 +93,27 @@ namespace casadi {
     }
 
     // ordering and symbolic analysis
-    int order = 0; // ordering?
+    string ordering = getOption("ordering");
     if (S_) cs_sfree(S_);
-    S_ = cs_schol(order, &AT_) ;
+    if (ordering=="nested_dissection") {
+      // As cs_schol, with the nested dissection of A+A' as the ordering
+      int n = AT_.n;
+      vector<int> p = input().sparsity()->nestedDissection(1);
+      S_ = static_cast<css*>(cs_calloc(1, sizeof(css)));
+      S_->pinv = cs_pinv(getPtr(p), n);
+      cs* C = cs_symperm(&AT_, S_->pinv, 0);
+      S_->parent = cs_etree(C, 0);
+      int* post = cs_post(S_->parent, n);
+      int* c = cs_counts(C, S_->parent, post, 0);
+      cs_free(post);
+      cs_spfree(C);
+      S_->cp = static_cast<int*>(cs_malloc(n+1, sizeof(int)));
+      S_->unz = S_->lnz = cs_cumsum(S_->cp, c, n);
+      cs_free(c);
+    } else {
+      int order = ordering=="amd" ? 1 : 0;
+      S_ = cs_schol(order, &AT_) ;
+    }
   }
 
 
@@ -120,6 +143,7 @@ namespace casadi {
       Li[p] = k ;
     }
     Lp[n] = S_->cp[n] ;
+    if (S_->pinv) cs_spfree(const_cast<cs*>(C));
     Sparsity ret(n, n, row, colind); // BUG?
 
     return transpose? ret.T() : ret;
@@ -200,18 +224,12 @@ namespace casadi {
     casadi_assert(L_!=0);
 
     double *t = &temp_.front();
+    // The linear system is symmetric, so transpose makes no difference
     for (int k=0; k<nrhs; ++k) {
-      if (transpose) {
-        cs_pvec(S_->q, x, t, AT_.n) ;   // t = P1\b
-        cs_ltsolve(L_->L, t) ;               // t = L\t
-        cs_lsolve(L_->L, t) ;              // t = U\t
-        cs_pvec(L_->pinv, t, x, AT_.n) ;      // x = P2\t
-      } else {
-        cs_ipvec(L_->pinv, x, t, AT_.n) ;   // t = P1\b
-        cs_lsolve(L_->L, t) ;               // t = L\t
-        cs_ltsolve(L_->L, t) ;              // t = U\t
-        cs_ipvec(S_->q, t, x, AT_.n) ;      // x = P2\t
-      }
+      cs_ipvec(S_->pinv, x, t, AT_.n) ;   // t = P*b
+      cs_lsolve(L_->L, t) ;               // t = L\t
+      cs_ltsolve(L_->L, t) ;              // t = L'\t
+      cs_pvec(S_->pinv, t, x, AT_.n) ;    // x = P'*t
       x += ncol();
     }
   }
@@ -223,10 +241,10 @@ namespace casadi {
     double *t = getPtr(temp_);
 
     for (int k=0; k<nrhs; ++k) {
-      cs_ipvec(L_->pinv, x, t, AT_.n) ;   // t = P1\b
+      cs_ipvec(S_->pinv, x, t, AT_.n) ;   // t = P1\b
       if (transpose) cs_lsolve(L_->L, t) ; // t = L\t
       if (!transpose) cs_ltsolve(L_->L, t) ; // t = U\t
-      cs_ipvec(S_->q, t, x, AT_.n) ;      // x = P2\t
+      cs_pvec(S_->pinv, t, x, AT_.n) ;      // x = P2\t
       x += ncol();
     }
   }
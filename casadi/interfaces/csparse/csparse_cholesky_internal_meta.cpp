@@ -33,10 +33,16 @@
 "\n"
 ">List of available options\n"
 "\n"
-"+----+------+---------+-------------+\n"
-"| Id | Type | Default | Description |\n"
-"+====+======+=========+=============+\n"
-"+----+------+---------+-------------+\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| ordering        | OT_STRING       | \"natural\"       | Fill-reducing   |\n"
+"|                 |                 |                 | symmetric       |\n"
+"|                 |                 |                 | ordering        |\n"
+"|                 |                 |                 | (natural|amd|ne |\n"
+"|                 |                 |                 | sted_dissection |\n"
+"|                 |                 |                 | )               |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "\n"
 "\n"
 "\n"
@@ -27,6 +27,7 @@
 #include "casadi/core/matrix/matrix_tools.hpp"
 #include "casadi/core/profiling.hpp"
 #include "casadi/core/casadi_options.hpp"
+#include "casadi/core/matrix/sparsity_internal.hpp"
 
 using namespace std;
 namespace casadi {
@@ -50,6 +51,9 @@ namespace casadi {
       : LinearSolverInternal(sparsity, nrhs) {
     N_ = 0;
     S_ = 0;
+    addOption("ordering", OT_STRING, "natural", "Fill-reducing column ordering",
+              "natural: no reordering|amd: approximate minimum degree of A+A'|"
+              "nested_dissection: nested dissection of A+A'");
   }
 
   CsparseInterface::CsparseInterface(const CsparseInterface& linsol)
@@ -80,10 +84,14 @@ namespace casadi {
     // Temporary
     temp_.resize(A_.n);
 
+    // Fill-reducing ordering
+    ordering_ = getOption("ordering").toString();
+
     // Has the routine been called once
     called_once_ = false;
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      ProfilingLogLock lock;
       profileWriteName(CasadiOptions::profilingLog, this, "CSparse",
                        ProfilingData_FunctionType_Other, 2);
 
@@ -93,20 +101,24 @@ namespace casadi {
   }
 
   void CsparseInterface::prepare() {
-    double time_start=0;
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_start = getRealTime(); // Start timer
-      profileWriteEntry(CasadiOptions::profilingLog, this);
-    }
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = prof.active() ? getTicks() : 0;
     if (!called_once_) {
       if (verbose()) {
         cout << "CsparseInterface::prepare: symbolic factorization" << endl;
       }
 
       // ordering and symbolic analysis
-      int order = 0; // ordering?
+      int order = ordering_=="amd" ? 1 : 0;
       if (S_) cs_sfree(S_);
       S_ = cs_sqr(order, &A_, 0) ;
+
+      // Replace the natural column ordering by a nested dissection of A+A'
+      if (ordering_=="nested_dissection") {
+        vector<int> q = input().sparsity()->nestedDissection(1);
+        S_->q = static_cast<int*>(cs_malloc(A_.n, sizeof(int)));
+        copy(q.begin(), q.end(), S_->q);
+      }
     }
 
     prepared_ = false;
@@ -161,21 +173,12 @@ namespace casadi {
 
     prepared_ = true;
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      double time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 0,
-                       time_stop-time_start,
-                       time_stop-time_start);
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
-    }
+    prof.line(0, ticks_start);
   }
 
   void CsparseInterface::solve(double* x, int nrhs, bool transpose) {
-    double time_start=0;
-    if (CasadiOptions::profiling&& CasadiOptions::profilingBinary) {
-      time_start = getRealTime(); // Start timer
-      profileWriteEntry(CasadiOptions::profilingLog, this);
-    }
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = prof.active() ? getTicks() : 0;
 
 
     casadi_assert(prepared_);
@@ -199,13 +202,7 @@ namespace casadi {
       x += ncol();
     }
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      double time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 1,
-                       time_stop-time_start,
-                       time_stop-time_start);
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
-    }
+    prof.line(1, ticks_start);
   }
 
 
@@ -74,6 +74,9 @@ namespace casadi {
     // Has the solve function been called once
     bool called_once_;
 
+    // Fill-reducing ordering
+    std::string ordering_;
+
     // The linear system CSparse form (CCS)
     cs A_;
 
@@ -33,10 +33,15 @@
 "\n"
 ">List of available options\n"
 "\n"
-"+----+------+---------+-------------+\n"
-"| Id | Type | Default | Description |\n"
-"+====+======+=========+=============+\n"
-"+----+------+---------+-------------+\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"|       Id        |      Type       |     Default     |   Description   |\n"
+"+=================+=================+=================+=================+\n"
+"| ordering        | OT_STRING       | \"natural\"       | Fill-reducing   |\n"
+"|                 |                 |                 | column ordering |\n"
+"|                 |                 |                 | (natural|amd|ne |\n"
+"|                 |                 |                 | sted_dissection |\n"
+"|                 |                 |                 | )               |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "\n"
 "\n"
 "\n"
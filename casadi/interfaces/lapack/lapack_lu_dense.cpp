@@ -85,6 +85,7 @@ namespace casadi {
     allow_equilibration_failure_ = getOption("allow_equilibration_failure").toInt();
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      ProfilingLogLock lock;
       profileWriteName(CasadiOptions::profilingLog, this, "LapackLUDense",
                        ProfilingData_FunctionType_Other, 2);
 
@@ -94,11 +95,8 @@ namespace casadi {
   }
 
   void LapackLuDense::prepare() {
-    double time_start=0;
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_start = getRealTime(); // Start timer
-      profileWriteEntry(CasadiOptions::profilingLog, this);
-    }
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = prof.active() ? getTicks() : 0;
     prepared_ = false;
 
     // Get the elements of the matrix, dense format
@@ -145,20 +143,12 @@ namespace casadi {
     // Success if reached this point
     prepared_ = true;
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      double time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 0, time_stop-time_start,
-                       time_stop-time_start);
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
-    }
+    prof.line(0, ticks_start);
   }
 
   void LapackLuDense::solve(double* x, int nrhs, bool transpose) {
-    double time_start=0;
-    if (CasadiOptions::profiling&& CasadiOptions::profilingBinary) {
-      time_start = getRealTime(); // Start timer
-      profileWriteEntry(CasadiOptions::profilingLog, this);
-    }
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = prof.active() ? getTicks() : 0;
 
     // Scale the right hand side
     if (transpose) {
@@ -181,12 +171,7 @@ namespace casadi {
       rowScaling(x, nrhs);
     }
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      double time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 1,
-                       time_stop-time_start, time_stop-time_start);
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_start);
-    }
+    prof.line(1, ticks_start);
   }
 
   void LapackLuDense::colScaling(double* x, int nrhs) {
@@ -64,6 +64,10 @@ namespace casadi {
     addOption("CPUtime",                OT_REAL,        GenericType(),
               "The maximum allowed CPU time in seconds for the whole initialisation"
               " (and the actually required one on output). Disabled if unset.");
+    addOption("share_working_set",      OT_BOOLEAN,     false,
+              "Start the first solve from the working set of the most recent solve "
+              "of any qpOASES instance with the same sparsity pattern. Working sets are "
+              "kept for the 16 sparsity patterns solved most recently.");
 
     // Temporary object
     qpOASES::Options ops;
@@ -160,6 +164,9 @@ namespace casadi {
     } else {
       max_cputime_ = -1;
     }
+    share_working_set_ = getOption("share_working_set");
+    working_set_key_ = st_[QP_STRUCT_H].hash();
+    hash_combine(working_set_key_, st_[QP_STRUCT_A].hash());
 
     // Create data for H if not dense
     if (!input(QP_SOLVER_H).sparsity().isDense()) h_data_.resize(n_*n_);
@@ -170,6 +177,10 @@ namespace casadi {
     // Dual solution vector
     dual_.resize(n_+nc_);
 
+    // Data of the previous solve
+    h_prev_.resize(n_*n_);
+    x_prev_.resize(n_);
+
     // Create qpOASES instance
     if (qp_) delete qp_;
     if (ALLOW_QPROBLEMB && nc_==0) {
@@ -262,28 +273,78 @@ namespace casadi {
     const double* lbA = getPtr(input(QP_SOLVER_LBA));
     const double* ubA = getPtr(input(QP_SOLVER_UBA));
 
+    // Working set of another instance with the same sparsity
+    WorkingSet shared_ws;
+    const WorkingSet* ws = 0;
+    if (!called_once_ && share_working_set_) {
+#ifdef WITH_OPENMP
+#pragma omp critical(qpoases_working_set)
+#endif // WITH_OPENMP
+      {
+        const WorkingSet* found = sharedWorkingSet(false);
+        if (found) {
+          shared_ws = *found;
+          ws = &shared_ws;
+        }
+      }
+    }
+
     int flag;
-    if (!called_once_) {
-      if (ALLOW_QPROBLEMB && nc_==0) {
-        flag = static_cast<qpOASES::QProblemB*>(qp_)->init(h, g, lb, ub, nWSR, cputime_ptr);
+    if (ALLOW_QPROBLEMB && nc_==0) {
+      qpOASES::QProblemB* qp = static_cast<qpOASES::QProblemB*>(qp_);
+      if (!called_once_) {
+        flag = qp->init(h, g, lb, ub, nWSR, cputime_ptr, 0, 0, ws ? &ws->bounds : 0);
+      } else if (std::equal(h_prev_.begin(), h_prev_.end(), h)) {
+        // Same Hessian: parametric hot start
+        flag = qp->hotstart(g, lb, ub, nWSR, cputime_ptr);
       } else {
-        flag = static_cast<qpOASES::SQProblem*>(qp_)->init(h, g, a, lb, ub, lbA, ubA,
-                                                           nWSR, cputime_ptr);
+        // New Hessian: restart from the previous solution and working set
+        qpOASES::Bounds bounds;
+        qp->getBounds(bounds);
+        qp->reset();
+        flag = qp->init(h, g, lb, ub, nWSR, cputime_ptr, getPtr(x_prev_), 0, &bounds);
+      }
+      if (called_once_ && flag!=qpOASES::SUCCESSFUL_RETURN
+          && flag!=qpOASES::RET_MAX_NWSR_REACHED) {
+        // Fall back to a cold start
+        if (verbose()) cout << "qpOASES: warm start failed, falling back to a cold start" << endl;
+        nWSR = max_nWSR_;
+        cputime = max_cputime_;
+        qp->reset();
+        flag = qp->init(h, g, lb, ub, nWSR, cputime_ptr);
       }
-      called_once_ = true;
     } else {
-      if (ALLOW_QPROBLEMB && nc_==0) {
-        static_cast<qpOASES::QProblemB*>(qp_)->reset();
-        flag = static_cast<qpOASES::QProblemB*>(qp_)->init(h, g, lb, ub, nWSR, cputime_ptr);
-        //flag = static_cast<qpOASES::QProblemB*>(qp_)->hotstart(g, lb, ub, nWSR, cputime_ptr);
+      qpOASES::SQProblem* qp = static_cast<qpOASES::SQProblem*>(qp_);
+      if (!called_once_) {
+        flag = qp->init(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr, 0, 0,
+                        ws ? &ws->bounds : 0, ws ? &ws->constraints : 0);
       } else {
-        flag = static_cast<qpOASES::SQProblem*>(qp_)->hotstart(h, g, a, lb, ub, lbA, ubA,
-                                                               nWSR, cputime_ptr);
+        flag = qp->hotstart(h, g, a, lb, ub, lbA, ubA, nWSR, cputime_ptr);
       }
     }
+    called_once_ = true;
     if (flag!=qpOASES::SUCCESSFUL_RETURN && flag!=qpOASES::RET_MAX_NWSR_REACHED) {
       throw CasadiException("qpOASES failed: " + getErrorMessage(flag));
     }
+    stats_["nWSR"] = nWSR;
+
+    // Remember the Hessian and the solution for the next call
+    std::copy(h, h+h_prev_.size(), h_prev_.begin());
+    qp_->getPrimalSolution(getPtr(x_prev_));
+
+    // Publish the working set
+    if (share_working_set_) {
+#ifdef WITH_OPENMP
+#pragma omp critical(qpoases_working_set)
+#endif // WITH_OPENMP
+      {
+        WorkingSet* ws = sharedWorkingSet(true);
+        qp_->getBounds(ws->bounds);
+        if (!(ALLOW_QPROBLEMB && nc_==0)) {
+          static_cast<qpOASES::SQProblem*>(qp_)->getConstraints(ws->constraints);
+        }
+      }
+    }
 
     // Get optimal cost
     output(QP_SOLVER_COST).set(qp_->getObjVal());
@@ -299,6 +360,46 @@ namespace casadi {
     transform(dual_.begin()+n_, dual_.end(),     output(QP_SOLVER_LAM_A).begin(), negate<double>());
   }
 
+  QpoasesInterface::SharedWorkingSets& QpoasesInterface::sharedWorkingSets() {
+    static SharedWorkingSets shared;
+    return shared;
+  }
+
+  /// Number of sparsity patterns for which a working set is kept
+  static const int max_shared_working_sets = 16;
+
+  QpoasesInterface::WorkingSet* QpoasesInterface::sharedWorkingSet(bool create) const {
+    SharedWorkingSets& shared = sharedWorkingSets();
+    map<size_t, WorkingSetList::iterator>::iterator it = shared.index.find(working_set_key_);
+    if (it!=shared.index.end()) {
+      WorkingSetList::iterator ws = it->second;
+      if (ws->h.isEqual(st_[QP_STRUCT_H]) && ws->a.isEqual(st_[QP_STRUCT_A])) {
+        // Mark as the most recently used
+        shared.lru.splice(shared.lru.begin(), shared.lru, ws);
+        return &*ws;
+      }
+
+      // Hash collision, the other pattern gives up its entry
+      if (!create) return 0;
+      shared.lru.erase(ws);
+      shared.index.erase(it);
+    }
+    if (!create) return 0;
+
+    // Drop the least recently used working set if there are too many
+    if (shared.lru.size()>=max_shared_working_sets) {
+      shared.index.erase(shared.lru.back().key);
+      shared.lru.pop_back();
+    }
+    shared.lru.push_front(WorkingSet());
+    WorkingSet& ws = shared.lru.front();
+    ws.key = working_set_key_;
+    ws.h = st_[QP_STRUCT_H];
+    ws.a = st_[QP_STRUCT_A];
+    shared.index[ws.key] = shared.lru.begin();
+    return &ws;
+  }
+
   std::string QpoasesInterface::getErrorMessage(int flag) {
     switch (flag) {
     case qpOASES::SUCCESSFUL_RETURN:
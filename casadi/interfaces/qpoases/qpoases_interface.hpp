@@ -29,6 +29,8 @@
 #include "casadi/core/function/qp_solver_internal.hpp"
 #include <casadi/interfaces/qpoases/casadi_qpsolver_qpoases_export.h>
 #include <qpOASES.hpp>
+#include <list>
+#include <map>
 
 /** \defgroup plugin_QpSolver_qpoases
 Interface to QPOases Solver for quadratic programming
@@ -104,16 +106,52 @@ public:
     /// Has qpOASES been called once?
     bool called_once_;
 
+    /// Start from the working set of other instances with the same sparsity
+    bool share_working_set_;
+
     /// Dense data for H and A
     std::vector<double> h_data_;
     std::vector<double> a_data_;
 
+    /// Hessian of the previous solve, to decide between hot and warm starts
+    std::vector<double> h_prev_;
+
+    /// Primal solution of the previous solve
+    std::vector<double> x_prev_;
+
     /// Temporary vector holding the dual solution
     std::vector<double> dual_;
 
     /// Get qpOASES error message
     static std::string getErrorMessage(int flag);
 
+    /// Working set of the most recent solve for a given sparsity pattern
+    struct WorkingSet {
+      std::size_t key;
+      Sparsity h, a;
+      qpOASES::Bounds bounds;
+      qpOASES::Constraints constraints;
+    };
+
+    /// Working sets shared between instances, most recently used first
+    typedef std::list<WorkingSet> WorkingSetList;
+
+    /// Working sets shared between instances, see the option share_working_set
+    struct SharedWorkingSets {
+      WorkingSetList lru;
+      std::map<std::size_t, WorkingSetList::iterator> index;
+    };
+    static SharedWorkingSets& sharedWorkingSets();
+
+    /// Combined hash of the sparsity patterns of H and A, the key of the shared working set
+    std::size_t working_set_key_;
+
+    /** \brief Shared working set for the sparsity patterns of this instance
+     * If there is none, one is created if create is set and 0 returned otherwise. Must be
+     * called in the critical section qpoases_working_set.
+     */
+    WorkingSet* sharedWorkingSet(bool create) const;
+
 };
 
 } // namespace casadi
@@ -213,6 +213,17 @@
 "|                 |                 |                 | QP solution,    |\n"
 "|                 |                 |                 | see Section 5.7 |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| share_working_s | OT_BOOLEAN      | false           | Start the first |\n"
+"| et              |                 |                 | solve from the  |\n"
+"|                 |                 |                 | working set of  |\n"
+"|                 |                 |                 | the most recent |\n"
+"|                 |                 |                 | solve of any    |\n"
+"|                 |                 |                 | qpOASES         |\n"
+"|                 |                 |                 | instance with   |\n"
+"|                 |                 |                 | the same        |\n"
+"|                 |                 |                 | sparsity        |\n"
+"|                 |                 |                 | pattern.        |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| terminationTole | OT_REAL         | 0.000           | Relative        |\n"
 "| rance           |                 |                 | termination     |\n"
 "|                 |                 |                 | tolerance to    |\n"
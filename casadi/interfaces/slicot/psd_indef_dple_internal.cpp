@@ -197,6 +197,7 @@ namespace casadi {
     }
 
     if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
+      ProfilingLogLock lock;
       profileWriteName(CasadiOptions::profilingLog, this, "PsdIndefSolver",
                        ProfilingData_FunctionType_Other, 4);
 
@@ -266,16 +267,11 @@ namespace casadi {
     double time_total_start = clock();
 
     // Set up timers for profiling
-    double time_zero=0;
-    double time_start=0;
-    double time_stop=0;
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_zero = getRealTime();
-      profileWriteEntry(CasadiOptions::profilingLog, this);
-    }
+    ProfilingScope prof(this);
+    unsigned long long ticks_start = 0;
 
-    if (CasadiOptions::profiling) {
-      time_start = getRealTime(); // Start timer
+    if (prof.active()) {
+      ticks_start = getTicks(); // Start timer
     }
 
     // Transpose operation (after #554)
@@ -291,14 +287,10 @@ namespace casadi {
     slicot_periodic_schur(n_, K_, X_, T_, Z_, dwork_, eig_real_, eig_imag_, psd_num_zero_);
     t_psd_+=(clock()-time_psd_start)/CLOCKS_PER_SEC;
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 0, time_stop-time_start,
-                       time_stop-time_zero);
-    }
+    prof.line(0, ticks_start);
 
-    if (CasadiOptions::profiling) {
-      time_start = getRealTime(); // Start timer
+    if (prof.active()) {
+      ticks_start = getTicks(); // Start timer
     }
 
     if (error_unstable_) {
@@ -385,17 +377,13 @@ namespace casadi {
       }
     }
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_stop = getRealTime(); // Stop timer
-      profileWriteTime(CasadiOptions::profilingLog, this, 1, time_stop-time_start,
-                       time_stop-time_zero);
-    }
+    prof.line(1, ticks_start);
 
     if (!transp_) {
       for (int d=0;d<nrhs_;++d) {
 
-        if (CasadiOptions::profiling) {
-          time_start = getRealTime(); // Start timer
+        if (prof.active()) {
+          ticks_start = getTicks(); // Start timer
         }
 
         // ********** START ***************
@@ -601,19 +589,15 @@ namespace casadi {
                        &outputD(d).data()[k*n_*n_]);
         }
 
-        if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-          time_stop = getRealTime(); // Stop timer
-          profileWriteTime(CasadiOptions::profilingLog, this, 2, time_stop-time_start,
-                           time_stop-time_zero);
-        }
+        prof.line(2, ticks_start);
 
       }
     } else { // Transposed
 
       for (int d=0;d<nrhs_;++d) {
 
-        if (CasadiOptions::profiling) {
-          time_start = getRealTime(); // Start timer
+        if (prof.active()) {
+          ticks_start = getTicks(); // Start timer
         }
 
         DMatrix &P_bar = inputD(1+d);
@@ -844,20 +828,11 @@ namespace casadi {
 
         //std::fill(P_bar.data().begin(), P_bar.data().end(), 0);
 
-       if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-          time_stop = getRealTime(); // Stop timer
-          profileWriteTime(CasadiOptions::profilingLog, this, 3, time_stop-time_start,
-                           time_stop-time_zero);
-       }
+        prof.line(3, ticks_start);
 
       }
     }
 
-    if (CasadiOptions::profiling && CasadiOptions::profilingBinary) {
-      time_stop = getRealTime();
-      profileWriteExit(CasadiOptions::profilingLog, this, time_stop-time_zero);
-    }
-
     t_total_ += (clock()-time_total_start)/CLOCKS_PER_SEC;
 
     if (gather_stats_) {
@@ -534,6 +534,38 @@ namespace casadi {
     casadi_log("CvodesInterface::integrate(" << t_out << ") end");
   }
 
+  double CvodesInterface::step(double t_out) {
+    // Taping for the backward problem requires integration in normal mode
+    if (nrx_>0) return IntegratorInternal::step(t_out);
+
+    casadi_assert_message(t_out<=tf_ || !stop_at_end_, "CvodesInterface::step("
+                          << t_out << "):"
+                          " Cannot integrate past a time later than tf (" << tf_ << ") "
+                          "unless stop_at_end is set to False.");
+
+    // Take one step in the direction of t_out
+    int flag = CVode(mem_, t_out, x_, &t_, CV_ONE_STEP);
+    if (flag!=CV_SUCCESS && flag!=CV_TSTOP_RETURN) cvodes_error("CVode", flag);
+
+    if (nq_>0) {
+      double tret;
+      flag = CVodeGetQuad(mem_, &tret, q_);
+      if (flag!=CV_SUCCESS) cvodes_error("CVodeGetQuad", flag);
+    }
+    return t_;
+  }
+
+  void CvodesInterface::interpolate(double t) {
+    // Evaluate the interpolating polynomial of the last step
+    int flag = CVodeGetDky(mem_, t, 0, x_);
+    if (flag!=CV_SUCCESS) cvodes_error("CVodeGetDky", flag);
+
+    if (nq_>0) {
+      flag = CVodeGetQuadDky(mem_, t, 0, q_);
+      if (flag!=CV_SUCCESS) cvodes_error("CVodeGetQuadDky", flag);
+    }
+  }
+
   void CvodesInterface::resetB() {
     casadi_log("CvodesInterface::resetB begin");
 
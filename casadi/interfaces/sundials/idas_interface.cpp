@@ -993,6 +993,46 @@ namespace casadi {
     casadi_log("IdasInterface::integrate(" << t_out << ") end");
   }
 
+  double IdasInterface::step(double t_out) {
+    // Taping for the backward problem requires integration in normal mode
+    if (nrx_>0) return IntegratorInternal::step(t_out);
+
+    casadi_assert_message(t_out<=tf_ || !stop_at_end_, "IdasInterface::step(" << t_out << "): "
+                          "Cannot integrate past a time later than tf (" << tf_ << ") "
+                          "unless stop_at_end is set to False.");
+
+    // Take one step in the direction of t_out
+    int flag = IDASolve(mem_, t_out, &t_, xz_, xzdot_, IDA_ONE_STEP);
+    if (flag != IDA_SUCCESS && flag != IDA_TSTOP_RETURN) idas_error("IDASolve", flag);
+
+    // Get quadrature states
+    if (nq_>0) {
+      double tret;
+      flag = IDAGetQuad(mem_, &tret, q_);
+      if (flag != IDA_SUCCESS) idas_error("IDAGetQuad", flag);
+    }
+
+    // Save the state and algebraic variable
+    copy(NV_DATA_S(xz_), NV_DATA_S(xz_)+nx_, output(INTEGRATOR_XF).begin());
+    copy(NV_DATA_S(xz_)+nx_, NV_DATA_S(xz_)+nx_+nz_, output(INTEGRATOR_ZF).begin());
+    return t_;
+  }
+
+  void IdasInterface::interpolate(double t) {
+    // Evaluate the interpolating polynomial of the last step
+    int flag = IDAGetDky(mem_, t, 0, xz_);
+    if (flag != IDA_SUCCESS) idas_error("IDAGetDky", flag);
+
+    if (nq_>0) {
+      flag = IDAGetQuadDky(mem_, t, 0, q_);
+      if (flag != IDA_SUCCESS) idas_error("IDAGetQuadDky", flag);
+    }
+
+    // Save the interpolated state and algebraic variable
+    copy(NV_DATA_S(xz_), NV_DATA_S(xz_)+nx_, output(INTEGRATOR_XF).begin());
+    copy(NV_DATA_S(xz_)+nx_, NV_DATA_S(xz_)+nx_+nz_, output(INTEGRATOR_ZF).begin());
+  }
+
   void IdasInterface::resetB() {
     log("IdasInterface::resetB", "begin");
 
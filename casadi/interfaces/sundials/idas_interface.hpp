@@ -112,6 +112,15 @@ namespace casadi {
     /** \brief  Integrate forward until a specified time point */
     virtual void integrate(double t_out);
 
+    /** \brief  Take one internal step towards a time point, returns the time reached */
+    virtual double step(double t_out);
+
+    /** \brief  Is the dense output of the last step available? */
+    virtual bool hasDenseOutput() const { return nrx_==0;}
+
+    /** \brief  Interpolate the forward solution within the last step */
+    virtual void interpolate(double t);
+
     /** \brief  Integrate backward until a specified time point */
     virtual void integrateB(double t_out);
 
@@ -0,0 +1,446 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "admm_qp.hpp"
+
+#include <cmath>
+#include <iomanip>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_QPSOLVER_ADMM_EXPORT
+  casadi_register_qpsolver_admm(QpSolverInternal::Plugin* plugin) {
+    plugin->creator = AdmmQp::creator;
+    plugin->name = "admm";
+    plugin->doc = AdmmQp::meta_doc.c_str();
+    plugin->version = 22;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_QPSOLVER_ADMM_EXPORT casadi_load_qpsolver_admm() {
+    QpSolverInternal::registerPlugin(casadi_register_qpsolver_admm);
+  }
+
+  AdmmQp::AdmmQp(const std::vector<Sparsity> &st) : QpSolverInternal(st) {
+    addOption("rho",                    OT_REAL,       0.1,
+              "Initial penalty parameter");
+    addOption("sigma",                  OT_REAL,       1e-6,
+              "Regularization of the primal block of the KKT matrix");
+    addOption("alpha",                  OT_REAL,       1.6,
+              "Over-relaxation parameter, in (0, 2)");
+    addOption("max_iter",               OT_INTEGER,    4000,
+              "Maximum number of iterations. The current iterate is returned when reached, "
+              "which gives a fixed iteration budget for real-time use");
+    addOption("eps_abs",                OT_REAL,       1e-6,
+              "Absolute tolerance on the primal and dual residuals");
+    addOption("eps_rel",                OT_REAL,       1e-6,
+              "Relative tolerance on the primal and dual residuals");
+    addOption("eps_prim_inf",           OT_REAL,       1e-5,
+              "Tolerance of the primal infeasibility certificate");
+    addOption("eps_dual_inf",           OT_REAL,       1e-5,
+              "Tolerance of the dual infeasibility certificate");
+    addOption("adaptive_rho",           OT_BOOLEAN,    true,
+              "Adapt rho to balance the primal and dual residuals");
+    addOption("adaptive_rho_interval",  OT_INTEGER,    25,
+              "Number of iterations between the updates of rho");
+    addOption("adaptive_rho_tolerance", OT_REAL,       5.,
+              "Only change rho, and refactorize, if it changes by more than this factor");
+    addOption("warm_start",             OT_BOOLEAN,    true,
+              "Start from the primal and dual solution of the previous call");
+    addOption("linear_solver",          OT_STRING,     "csparse",
+              "Linear solver for the KKT system");
+    addOption("linear_solver_options",  OT_DICTIONARY, GenericType(),
+              "Options to be passed to the linear solver");
+  }
+
+  AdmmQp::~AdmmQp() {
+  }
+
+  void AdmmQp::deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    QpSolverInternal::deepCopyMembers(already_copied);
+    linsol_ = deepcopy(linsol_, already_copied);
+  }
+
+  void AdmmQp::init() {
+    // Initialize the base classes
+    QpSolverInternal::init();
+
+    // Read options
+    rho0_ = getOption("rho");
+    sigma_ = getOption("sigma");
+    alpha_ = getOption("alpha");
+    max_iter_ = getOption("max_iter");
+    eps_abs_ = getOption("eps_abs");
+    eps_rel_ = getOption("eps_rel");
+    eps_prim_inf_ = getOption("eps_prim_inf");
+    eps_dual_inf_ = getOption("eps_dual_inf");
+    adaptive_rho_ = getOption("adaptive_rho");
+    adaptive_rho_interval_ = getOption("adaptive_rho_interval");
+    adaptive_rho_tolerance_ = getOption("adaptive_rho_tolerance");
+    warm_start_ = getOption("warm_start");
+    casadi_assert_message(rho0_>0 && sigma_>0, "AdmmQp: rho and sigma must be positive");
+    casadi_assert_message(alpha_>0 && alpha_<2, "AdmmQp: alpha must be in (0, 2)");
+    casadi_assert_message(adaptive_rho_interval_>0 && adaptive_rho_tolerance_>=1,
+                          "AdmmQp: invalid settings for the adaptation of rho");
+
+    // The simple bounds are treated as constraint rows
+    m_ = nc_ + n_;
+
+    // Sparsity of the KKT matrix [H + sigma*I, [A; I]'; [A; I], -diag(1/rho)]
+    const Sparsity& spH = st_[QP_STRUCT_H];
+    const Sparsity& spA = st_[QP_STRUCT_A];
+    vector<int> kkt_row, kkt_col;
+    for (int c=0; c<n_; ++c) {
+      for (int el=spH.colind(c); el<spH.colind(c+1); ++el) {
+        int r = spH.row(el);
+        if (r<c) continue;
+        kkt_row.push_back(r);
+        kkt_col.push_back(c);
+        kkt_row.push_back(c);
+        kkt_col.push_back(r);
+      }
+      for (int el=spA.colind(c); el<spA.colind(c+1); ++el) {
+        int r = spA.row(el);
+        kkt_row.push_back(n_+r);
+        kkt_col.push_back(c);
+        kkt_row.push_back(c);
+        kkt_col.push_back(n_+r);
+      }
+      kkt_row.push_back(n_+nc_+c);
+      kkt_col.push_back(c);
+      kkt_row.push_back(c);
+      kkt_col.push_back(n_+nc_+c);
+    }
+    for (int i=0; i<n_+m_; ++i) {
+      kkt_row.push_back(i);
+      kkt_col.push_back(i);
+    }
+    Sparsity spKKT = Sparsity::triplet(n_+m_, n_+m_, kkt_row, kkt_col);
+
+    // Locate the entries in the KKT matrix
+    kkt_h_.clear();
+    kkt_ht_.clear();
+    for (int c=0; c<n_; ++c) {
+      for (int el=spH.colind(c); el<spH.colind(c+1); ++el) {
+        int r = spH.row(el);
+        kkt_h_.push_back(r<c ? -1 : spKKT.getNZ(r, c));
+        kkt_ht_.push_back(r<=c ? -1 : spKKT.getNZ(c, r));
+      }
+    }
+    kkt_a_.resize(spA.size());
+    kkt_at_.resize(spA.size());
+    for (int c=0; c<n_; ++c) {
+      for (int el=spA.colind(c); el<spA.colind(c+1); ++el) {
+        kkt_a_[el] = spKKT.getNZ(n_+spA.row(el), c);
+        kkt_at_[el] = spKKT.getNZ(c, n_+spA.row(el));
+      }
+    }
+    kkt_b_.resize(n_);
+    kkt_bt_.resize(n_);
+    for (int i=0; i<n_; ++i) {
+      kkt_b_[i] = spKKT.getNZ(n_+nc_+i, i);
+      kkt_bt_[i] = spKKT.getNZ(i, n_+nc_+i);
+    }
+    kkt_diag_.resize(n_+m_);
+    for (int i=0; i<n_+m_; ++i) kkt_diag_[i] = spKKT.getNZ(i, i);
+    kkt_.resize(spKKT.size());
+    kkt_fact_.clear();
+
+    // Allocate the linear solver
+    std::string linear_solver_name = getOption("linear_solver");
+    linsol_ = LinearSolver(linear_solver_name, spKKT, 1);
+    if (hasSetOption("linear_solver_options")) {
+      const Dictionary& linear_solver_options = getOption("linear_solver_options");
+      linsol_.setOption(linear_solver_options);
+    }
+    linsol_.init();
+
+    // Allocate work vectors
+    rho_vec_.resize(m_);
+    x_.resize(n_);
+    z_.resize(m_);
+    y_.resize(m_);
+    rhs_.resize(n_+m_);
+    x_prev_.resize(n_);
+    y_prev_.resize(m_);
+    Ax_.resize(m_);
+    Px_.resize(n_);
+    ATy_.resize(n_);
+    dx_.resize(n_);
+    dy_.resize(m_);
+    w_.resize(std::max(n_, m_));
+    has_solution_ = false;
+    rho_ = rho0_;
+  }
+
+  void AdmmQp::updateRho(const std::vector<double>& l, const std::vector<double>& u) {
+    for (int i=0; i<m_; ++i) {
+      if (isinf(l[i]) && isinf(u[i])) {
+        // Free row
+        rho_vec_[i] = 1e-6;
+      } else if (l[i]==u[i]) {
+        // Equality row
+        rho_vec_[i] = 1e3*rho_;
+      } else {
+        rho_vec_[i] = rho_;
+      }
+    }
+  }
+
+  void AdmmQp::factorize() {
+    const vector<double>& h = input(QP_SOLVER_H).data();
+    const vector<double>& a = input(QP_SOLVER_A).data();
+
+    // Assemble the KKT matrix
+    fill(kkt_.begin(), kkt_.end(), 0);
+    for (int el=0; el<h.size(); ++el) {
+      if (kkt_h_[el]>=0) kkt_[kkt_h_[el]] += h[el];
+      if (kkt_ht_[el]>=0) kkt_[kkt_ht_[el]] += h[el];
+    }
+    for (int el=0; el<a.size(); ++el) {
+      kkt_[kkt_a_[el]] += a[el];
+      kkt_[kkt_at_[el]] += a[el];
+    }
+    for (int i=0; i<n_; ++i) {
+      kkt_[kkt_b_[i]] += 1;
+      kkt_[kkt_bt_[i]] += 1;
+      kkt_[kkt_diag_[i]] += sigma_;
+    }
+    for (int i=0; i<m_; ++i) kkt_[kkt_diag_[n_+i]] -= 1/rho_vec_[i];
+
+    // Factorize, unless unchanged since the last factorization
+    if (kkt_==kkt_fact_) return;
+    linsol_.input(LINSOL_A).set(kkt_);
+    linsol_.prepare();
+    kkt_fact_ = kkt_;
+    n_fact_++;
+  }
+
+  void AdmmQp::multA(const double* v, double* w) const {
+    const Sparsity& spA = st_[QP_STRUCT_A];
+    const vector<double>& a = input(QP_SOLVER_A).data();
+    fill(w, w+nc_, 0);
+    for (int c=0; c<n_; ++c) {
+      for (int el=spA.colind(c); el<spA.colind(c+1); ++el) {
+        w[spA.row(el)] += a[el]*v[c];
+      }
+    }
+    copy(v, v+n_, w+nc_);
+  }
+
+  void AdmmQp::multAT(const double* v, double* w) const {
+    const Sparsity& spA = st_[QP_STRUCT_A];
+    const vector<double>& a = input(QP_SOLVER_A).data();
+    for (int c=0; c<n_; ++c) {
+      w[c] = v[nc_+c];
+      for (int el=spA.colind(c); el<spA.colind(c+1); ++el) {
+        w[c] += a[el]*v[spA.row(el)];
+      }
+    }
+  }
+
+  void AdmmQp::multH(const double* v, double* w) const {
+    const Sparsity& spH = st_[QP_STRUCT_H];
+    const vector<double>& h = input(QP_SOLVER_H).data();
+    fill(w, w+n_, 0);
+    for (int c=0; c<n_; ++c) {
+      for (int el=spH.colind(c); el<spH.colind(c+1); ++el) {
+        int r = spH.row(el);
+        if (r<c) continue;
+        w[r] += h[el]*v[c];
+        if (r!=c) w[c] += h[el]*v[r];
+      }
+    }
+  }
+
+  void AdmmQp::evaluate() {
+    if (inputs_check_) checkInputs();
+
+    const vector<double>& g = input(QP_SOLVER_G).data();
+    const vector<double>& lba = input(QP_SOLVER_LBA).data();
+    const vector<double>& uba = input(QP_SOLVER_UBA).data();
+    const vector<double>& lbx = input(QP_SOLVER_LBX).data();
+    const vector<double>& ubx = input(QP_SOLVER_UBX).data();
+
+    // Bounds on the constraint rows [A; I]*x
+    vector<double> l(m_), u(m_);
+    copy(lba.begin(), lba.end(), l.begin());
+    copy(lbx.begin(), lbx.end(), l.begin()+nc_);
+    copy(uba.begin(), uba.end(), u.begin());
+    copy(ubx.begin(), ubx.end(), u.begin()+nc_);
+
+    // Initial guess
+    if (!warm_start_ || !has_solution_) {
+      const vector<double>& x0 = input(QP_SOLVER_X0).data();
+      const vector<double>& lam_x0 = input(QP_SOLVER_LAM_X0).data();
+      copy(x0.begin(), x0.end(), x_.begin());
+      fill(y_.begin(), y_.begin()+nc_, 0);
+      copy(lam_x0.begin(), lam_x0.end(), y_.begin()+nc_);
+      rho_ = rho0_;
+    }
+    multA(getPtr(x_), getPtr(z_));
+    for (int i=0; i<m_; ++i) z_[i] = std::min(std::max(z_[i], l[i]), u[i]);
+
+    // Factorize the KKT matrix
+    n_fact_ = 0;
+    updateRho(l, u);
+    factorize();
+
+    int iter;
+    std::string return_status = "Maximum_Iterations_Exceeded";
+    for (iter=1; iter<=max_iter_; ++iter) {
+      copy(x_.begin(), x_.end(), x_prev_.begin());
+      copy(y_.begin(), y_.end(), y_prev_.begin());
+
+      // Solve the KKT system
+      for (int i=0; i<n_; ++i) rhs_[i] = sigma_*x_[i] - g[i];
+      for (int i=0; i<m_; ++i) rhs_[n_+i] = z_[i] - y_[i]/rho_vec_[i];
+      linsol_.solve(getPtr(rhs_), 1, false);
+
+      // Relaxed primal update
+      for (int i=0; i<n_; ++i) x_[i] = alpha_*rhs_[i] + (1-alpha_)*x_prev_[i];
+
+      // Projection and dual update
+      for (int i=0; i<m_; ++i) {
+        double zt = z_[i] + (rhs_[n_+i] - y_[i])/rho_vec_[i];
+        double zh = alpha_*zt + (1-alpha_)*z_[i];
+        z_[i] = std::min(std::max(zh + y_[i]/rho_vec_[i], l[i]), u[i]);
+        y_[i] += rho_vec_[i]*(zh - z_[i]);
+      }
+
+      // Residuals
+      multA(getPtr(x_), getPtr(Ax_));
+      multH(getPtr(x_), getPtr(Px_));
+      multAT(getPtr(y_), getPtr(ATy_));
+      double r_prim = 0, r_dual = 0, nrm_Ax = 0, nrm_z = 0, nrm_Px = 0, nrm_ATy = 0, nrm_g = 0;
+      for (int i=0; i<m_; ++i) {
+        r_prim = std::max(r_prim, fabs(Ax_[i]-z_[i]));
+        nrm_Ax = std::max(nrm_Ax, fabs(Ax_[i]));
+        nrm_z = std::max(nrm_z, fabs(z_[i]));
+      }
+      for (int i=0; i<n_; ++i) {
+        r_dual = std::max(r_dual, fabs(Px_[i]+g[i]+ATy_[i]));
+        nrm_Px = std::max(nrm_Px, fabs(Px_[i]));
+        nrm_ATy = std::max(nrm_ATy, fabs(ATy_[i]));
+        nrm_g = std::max(nrm_g, fabs(g[i]));
+      }
+      double eps_prim = eps_abs_ + eps_rel_*std::max(nrm_Ax, nrm_z);
+      double eps_dual = eps_abs_ + eps_rel_*std::max(nrm_Px, std::max(nrm_ATy, nrm_g));
+      if (verbose()) {
+        cout << "AdmmQp: iter " << setw(5) << iter << ", r_prim " << setw(12) << r_prim
+             << ", r_dual " << setw(12) << r_dual << ", rho " << rho_ << endl;
+      }
+      if (r_prim<=eps_prim && r_dual<=eps_dual) {
+        return_status = "Solve_Succeeded";
+        break;
+      }
+
+      // Primal infeasibility: A'*dy = 0 and u'*max(dy, 0) + l'*min(dy, 0) < 0
+      for (int i=0; i<m_; ++i) dy_[i] = y_[i]-y_prev_[i];
+      double nrm_dy = 0;
+      for (int i=0; i<m_; ++i) nrm_dy = std::max(nrm_dy, fabs(dy_[i]));
+      if (nrm_dy>0) {
+        double eps = eps_prim_inf_*nrm_dy;
+        multAT(getPtr(dy_), getPtr(w_));
+        bool certificate = true;
+        for (int i=0; i<n_ && certificate; ++i) certificate = fabs(w_[i])<=eps;
+        double s = 0;
+        for (int i=0; i<m_ && certificate; ++i) {
+          if (dy_[i]>eps) {
+            certificate = !isinf(u[i]);
+            s += u[i]*dy_[i];
+          } else if (dy_[i]<-eps) {
+            certificate = !isinf(l[i]);
+            s += l[i]*dy_[i];
+          }
+        }
+        if (certificate && s<-eps) {
+          return_status = "Infeasible_Problem_Detected";
+          break;
+        }
+      }
+
+      // Dual infeasibility: H*dx = 0, g'*dx < 0 and A*dx within the recession cone
+      for (int i=0; i<n_; ++i) dx_[i] = x_[i]-x_prev_[i];
+      double nrm_dx = 0;
+      for (int i=0; i<n_; ++i) nrm_dx = std::max(nrm_dx, fabs(dx_[i]));
+      if (nrm_dx>0) {
+        double eps = eps_dual_inf_*nrm_dx;
+        double gdx = 0;
+        for (int i=0; i<n_; ++i) gdx += g[i]*dx_[i];
+        bool certificate = gdx<-eps;
+        multH(getPtr(dx_), getPtr(w_));
+        for (int i=0; i<n_ && certificate; ++i) certificate = fabs(w_[i])<=eps;
+        multA(getPtr(dx_), getPtr(w_));
+        for (int i=0; i<m_ && certificate; ++i) {
+          certificate = (isinf(u[i]) || w_[i]<=eps) && (isinf(l[i]) || w_[i]>=-eps);
+        }
+        if (certificate) {
+          return_status = "Dual_Infeasible";
+          break;
+        }
+      }
+
+      // Balance the primal and dual residuals
+      if (adaptive_rho_ && iter%adaptive_rho_interval_==0) {
+        double p = r_prim/(std::max(nrm_Ax, nrm_z) + 1e-10);
+        double d = r_dual/(std::max(nrm_Px, std::max(nrm_ATy, nrm_g)) + 1e-10);
+        double rho_new = rho_*sqrt(p/(d + 1e-10));
+        rho_new = std::min(std::max(rho_new, 1e-6), 1e6);
+        if (rho_new>rho_*adaptive_rho_tolerance_ || rho_new<rho_/adaptive_rho_tolerance_) {
+          rho_ = rho_new;
+          updateRho(l, u);
+          factorize();
+        }
+      }
+    }
+    if (iter>max_iter_) iter = max_iter_;
+    has_solution_ = return_status=="Solve_Succeeded";
+
+    // Get the solution
+    output(QP_SOLVER_X).set(x_);
+    copy(y_.begin(), y_.begin()+nc_, output(QP_SOLVER_LAM_A).begin());
+    copy(y_.begin()+nc_, y_.end(), output(QP_SOLVER_LAM_X).begin());
+    multH(getPtr(x_), getPtr(Px_));
+    double cost = 0;
+    for (int i=0; i<n_; ++i) cost += x_[i]*(0.5*Px_[i] + g[i]);
+    output(QP_SOLVER_COST).set(cost);
+
+    stats_["iter_count"] = iter;
+    stats_["return_status"] = return_status;
+    stats_["n_factorizations"] = n_fact_;
+    stats_["rho"] = rho_;
+
+    if (return_status=="Infeasible_Problem_Detected") {
+      casadi_error("AdmmQp: the QP is primal infeasible");
+    } else if (return_status=="Dual_Infeasible") {
+      casadi_error("AdmmQp: the QP is dual infeasible (unbounded)");
+    }
+  }
+
+} // namespace casadi
@@ -0,0 +1,144 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_ADMM_QP_HPP
+#define CASADI_ADMM_QP_HPP
+
+#include "casadi/core/function/qp_solver_internal.hpp"
+#include "casadi/core/function/linear_solver.hpp"
+
+#include <casadi/solvers/casadi_qpsolver_admm_export.h>
+
+
+/** \defgroup plugin_QpSolver_admm
+   First-order QP solver based on the alternating direction method of multipliers (ADMM).
+
+   The simple bounds are treated as additional constraint rows. Each iteration solves
+   a quasi-definite KKT system whose sparsity is fixed at initialization. The factorization
+   is reused across iterations and calls and is only recomputed when the QP data change
+   or the penalty parameter rho is adapted by more than a given factor.
+   Primal and dual infeasibility are detected from the differences of successive iterates.
+*/
+
+/** \pluginsection{QpSolver,admm} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{QpSolver,admm}
+
+   @copydoc QpSolver_doc
+   @copydoc plugin_QpSolver_admm
+
+   \date 2015
+  */
+  class CASADI_QPSOLVER_ADMM_EXPORT AdmmQp : public QpSolverInternal {
+  public:
+    /** \brief  Create a new Solver */
+    explicit AdmmQp(const std::vector<Sparsity> &st);
+
+    /** \brief  Clone */
+    virtual AdmmQp* clone() const { return new AdmmQp(*this);}
+
+    /** \brief  Create a new QP Solver */
+    static QpSolverInternal* creator(const QPStructure& st)
+    { return new AdmmQp(st);}
+
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    /** \brief  Destructor */
+    virtual ~AdmmQp();
+
+    /** \brief  Initialize */
+    virtual void init();
+
+    /** \brief  Solve the QP */
+    virtual void evaluate();
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+
+    /// Penalty parameter of each constraint row
+    void updateRho(const std::vector<double>& l, const std::vector<double>& u);
+
+    /// Assemble the KKT matrix and factorize it if it changed
+    void factorize();
+
+    /// w = [A; I]*v
+    void multA(const double* v, double* w) const;
+
+    /// w = [A; I]'*v
+    void multAT(const double* v, double* w) const;
+
+    /// w = H*v, H symmetric given by its lower triangle
+    void multH(const double* v, double* w) const;
+
+    /// Linear solver for the KKT system
+    LinearSolver linsol_;
+
+    /// Positions in the KKT matrix of the entries of H (lower, upper) and of A (lower, upper)
+    std::vector<int> kkt_h_, kkt_ht_, kkt_a_, kkt_at_;
+
+    /// Positions in the KKT matrix of the identity blocks for the simple bounds
+    std::vector<int> kkt_b_, kkt_bt_;
+
+    /// Positions of the diagonal entries of the KKT matrix
+    std::vector<int> kkt_diag_;
+
+    /// KKT nonzeros, and the ones of the last factorization
+    std::vector<double> kkt_, kkt_fact_;
+
+    /// Number of constraint rows, nc_ + n_
+    int m_;
+
+    /// Penalty parameters: scalar and per row
+    double rho_;
+    std::vector<double> rho_vec_;
+
+    /// Iterates
+    std::vector<double> x_, z_, y_;
+
+    /// Has a previous solution that can be used for warm starting
+    bool has_solution_;
+
+    /// Work vectors
+    std::vector<double> rhs_, x_prev_, y_prev_, Ax_, Px_, ATy_, dx_, dy_, w_;
+
+    /// Number of factorizations in the current call
+    int n_fact_;
+
+    /// Solver options
+    double rho0_, sigma_, alpha_, eps_abs_, eps_rel_, eps_prim_inf_, eps_dual_inf_;
+    double adaptive_rho_tolerance_;
+    int max_iter_, adaptive_rho_interval_;
+    bool adaptive_rho_, warm_start_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_ADMM_QP_HPP
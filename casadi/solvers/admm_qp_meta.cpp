@@ -0,0 +1,139 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "admm_qp.hpp"
+      #include <string>
+
+      const std::string casadi::AdmmQp::meta_doc=
+      "\n"
+"First-order QP solver based on the alternating direction method of\n"
+"multipliers (ADMM).\n"
+"\n"
+"The simple bounds are treated as additional constraint rows. Each iteration\n"
+"solves a quasi-definite KKT system whose sparsity is fixed at\n"
+"initialization. The factorization is reused across iterations and calls and\n"
+"is only recomputed when the QP data change or the penalty parameter rho is\n"
+"adapted by more than a given factor. Primal and dual infeasibility are\n"
+"detected from the differences of successive iterates.\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"|       Id        |     Type      | Default  |   Description   |\n"
+"+=================+===============+==========+=================+\n"
+"| adaptive_rho    | OT_BOOLEAN    | true     | Adapt rho to    |\n"
+"|                 |               |          | balance the     |\n"
+"|                 |               |          | primal and dual |\n"
+"|                 |               |          | residuals       |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| adaptive_rho_in | OT_INTEGER    | 25       | Number of       |\n"
+"| terval          |               |          | iterations      |\n"
+"|                 |               |          | between the     |\n"
+"|                 |               |          | updates of rho  |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| adaptive_rho_to | OT_REAL       | 5        | Only change     |\n"
+"| lerance         |               |          | rho, and        |\n"
+"|                 |               |          | refactorize, if |\n"
+"|                 |               |          | it changes by   |\n"
+"|                 |               |          | more than this  |\n"
+"|                 |               |          | factor          |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| alpha           | OT_REAL       | 1.6      | Over-relaxation |\n"
+"|                 |               |          | parameter, in   |\n"
+"|                 |               |          | (0, 2)          |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| eps_abs         | OT_REAL       | 1e-6     | Absolute        |\n"
+"|                 |               |          | tolerance on    |\n"
+"|                 |               |          | the primal and  |\n"
+"|                 |               |          | dual residuals  |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| eps_dual_inf    | OT_REAL       | 1e-5     | Tolerance of    |\n"
+"|                 |               |          | the dual        |\n"
+"|                 |               |          | infeasibility   |\n"
+"|                 |               |          | certificate     |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| eps_prim_inf    | OT_REAL       | 1e-5     | Tolerance of    |\n"
+"|                 |               |          | the primal      |\n"
+"|                 |               |          | infeasibility   |\n"
+"|                 |               |          | certificate     |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| eps_rel         | OT_REAL       | 1e-6     | Relative        |\n"
+"|                 |               |          | tolerance on    |\n"
+"|                 |               |          | the primal and  |\n"
+"|                 |               |          | dual residuals  |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| linear_solver   | OT_STRING     | \"csparse\" | Linear solver   |\n"
+"|                 |               |          | for the KKT     |\n"
+"|                 |               |          | system          |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| linear_solver_o | OT_DICTIONARY | GenericTy| Options to be   |\n"
+"| ptions          |               | pe()     | passed to the   |\n"
+"|                 |               |          | linear solver   |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| max_iter        | OT_INTEGER    | 4000     | Maximum number  |\n"
+"|                 |               |          | of iterations.  |\n"
+"|                 |               |          | The current     |\n"
+"|                 |               |          | iterate is      |\n"
+"|                 |               |          | returned when   |\n"
+"|                 |               |          | reached, which  |\n"
+"|                 |               |          | gives a fixed   |\n"
+"|                 |               |          | iteration       |\n"
+"|                 |               |          | budget for      |\n"
+"|                 |               |          | real-time use   |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| rho             | OT_REAL       | 0.1      | Initial penalty |\n"
+"|                 |               |          | parameter       |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| sigma           | OT_REAL       | 1e-6     | Regularization  |\n"
+"|                 |               |          | of the primal   |\n"
+"|                 |               |          | block of the    |\n"
+"|                 |               |          | KKT matrix      |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| warm_start      | OT_BOOLEAN    | true     | Start from the  |\n"
+"|                 |               |          | primal and dual |\n"
+"|                 |               |          | solution of the |\n"
+"|                 |               |          | previous call   |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+------------------+\n"
+"|        Id        |\n"
+"+==================+\n"
+"| iter_count       |\n"
+"+------------------+\n"
+"| n_factorizations |\n"
+"+------------------+\n"
+"| return_status    |\n"
+"+------------------+\n"
+"| rho              |\n"
+"+------------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -0,0 +1,203 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "cyclic_indef_dple_internal.hpp"
+#include <cassert>
+#include "../core/std_vector_tools.hpp"
+#include "../core/matrix/matrix_tools.hpp"
+#include "../core/mx/mx_tools.hpp"
+#include "../core/function/mx_function.hpp"
+
+INPUTSCHEME(DPLEInput)
+OUTPUTSCHEME(DPLEOutput)
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_DPLESOLVER_CYCLIC_EXPORT
+  casadi_register_dplesolver_cyclic(DpleInternal::Plugin* plugin) {
+    plugin->creator = CyclicIndefDpleInternal::creator;
+    plugin->name = "cyclic";
+    plugin->doc = CyclicIndefDpleInternal::meta_doc.c_str();
+    plugin->version = 22;
+    plugin->adaptorHasPlugin = DleSolver::hasPlugin;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_DPLESOLVER_CYCLIC_EXPORT casadi_load_dplesolver_cyclic() {
+    DpleInternal::registerPlugin(casadi_register_dplesolver_cyclic);
+  }
+
+  CyclicIndefDpleInternal::CyclicIndefDpleInternal(
+      const DpleStructure& st) : DpleInternal(st) {
+
+    // set default options
+    setOption("name", "unnamed_cyclic_indef_dple_solver"); // name of the function
+
+    addOption("parallelization", OT_STRING, "serial",
+              "Evaluation of the independent compositions in each stage",
+              "expand|serial|openmp");
+
+    Adaptor::addOptions();
+
+  }
+
+  CyclicIndefDpleInternal::~CyclicIndefDpleInternal() {
+
+  }
+
+  void CyclicIndefDpleInternal::init() {
+    // Initialize the base classes
+    DpleInternal::init();
+
+    casadi_assert_message(!pos_def_,
+      "pos_def option set to True: Solver only handles the indefinite case.");
+    casadi_assert_message(const_dim_,
+      "const_dim option set to False: Solver only handles the True case.");
+
+    n_ = A_[0].size1();
+
+    MX As = MX::sym("A", horzcat(A_));
+    MX Vs = MX::sym("V", horzcat(V_));
+
+    // The maps from P_k to P_{k+1}
+    std::vector< MX > Phi = horzsplit(As, n_);
+    std::vector< MX > W = horzsplit(Vs, n_);
+    for (int k=0;k<K_;++k) {
+      W[k] = (W[k]+W[k].T())/2;
+      Phi[k].makeDense();
+      W[k].makeDense();
+    }
+
+    // Composition of two maps
+    MX A1 = MX::sym("A1", n_, n_), V1 = MX::sym("V1", n_, n_);
+    MX A2 = MX::sym("A2", n_, n_), V2 = MX::sym("V2", n_, n_);
+    std::vector<MX> compose_in(4), compose_out(2);
+    compose_in[0] = A2;
+    compose_in[1] = V2;
+    compose_in[2] = A1;
+    compose_in[3] = V1;
+    compose_out[0] = mul(A2, A1);
+    compose_out[1] = mul(mul(A2, V1), A2.T()) + V2;
+    MXFunction compose(compose_in, compose_out);
+    compose.setOption("name", "dple_compose");
+    compose.init();
+
+    // Parallel prefix scan: afterwards, (Phi[k], W[k]) maps P_0 to P_{k+1}
+    for (int d=1;d<K_;d*=2) {
+      std::vector< std::vector<MX> > arg;
+      for (int k=d;k<K_;++k) {
+        std::vector<MX> arg_k(4);
+        arg_k[0] = Phi[k];
+        arg_k[1] = W[k];
+        arg_k[2] = Phi[k-d];
+        arg_k[3] = W[k-d];
+        arg.push_back(arg_k);
+      }
+      std::vector< std::vector<MX> > res = callStage(compose, arg);
+      for (int k=d;k<K_;++k) {
+        Phi[k] = res[k-d][0];
+        W[k] = res[k-d][1];
+      }
+    }
+
+    // Create an dlesolver instance for the full period
+    solver_ = DleSolver(getOption(solvername()),
+                        dleStruct("a", Phi[K_-1].sparsity(), "v", W[K_-1].sparsity()));
+    solver_.setOption(getOption(optionsname()));
+    solver_.init();
+
+    std::vector<MX> Ps(K_);
+    Ps[0] = solver_.call(dleIn("a", Phi[K_-1], "v", W[K_-1]))[DLE_P];
+
+    // Propagate the solution to the other periods
+    if (K_>1) {
+      MX P = MX::sym("P", n_, n_);
+      std::vector<MX> apply_in(3);
+      apply_in[0] = A2;
+      apply_in[1] = V2;
+      apply_in[2] = P;
+      MXFunction apply(apply_in, mul(mul(A2, P), A2.T()) + V2);
+      apply.setOption("name", "dple_apply");
+      apply.init();
+
+      std::vector< std::vector<MX> > arg;
+      for (int k=0;k<K_-1;++k) {
+        std::vector<MX> arg_k(3);
+        arg_k[0] = Phi[k];
+        arg_k[1] = W[k];
+        arg_k[2] = Ps[0];
+        arg.push_back(arg_k);
+      }
+      std::vector< std::vector<MX> > res = callStage(apply, arg);
+      for (int k=0;k<K_-1;++k) {
+        Ps[k+1] = res[k][0];
+      }
+    }
+
+    f_ = MXFunction(dpleIn("a", As, "v", Vs), dpleOut("p", horzcat(Ps)));
+    f_.init();
+
+    Wrapper::checkDimensions();
+
+  }
+
+  std::vector<std::vector<MX> > CyclicIndefDpleInternal::callStage(
+      Function& f, const std::vector<std::vector<MX> >& arg) {
+    // A single call needs no parallelization
+    if (arg.size()==1) {
+      return std::vector<std::vector<MX> >(1, f.call(arg[0]));
+    }
+
+    Dictionary paropt;
+    paropt["parallelization"] = getOption("parallelization");
+    return f.callParallel(arg, paropt);
+  }
+
+  void CyclicIndefDpleInternal::evaluate() {
+    Wrapper::evaluate();
+  }
+
+  Function CyclicIndefDpleInternal::getDerivative(int nfwd, int nadj) {
+    return f_.derivative(nfwd, nadj);
+  }
+
+
+  void CyclicIndefDpleInternal::deepCopyMembers(
+      std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    DpleInternal::deepCopyMembers(already_copied);
+  }
+
+  CyclicIndefDpleInternal* CyclicIndefDpleInternal::clone() const {
+    // Return a deep copy
+    CyclicIndefDpleInternal* node = new CyclicIndefDpleInternal(st_);
+    node->setOption(dictionary());
+    return node;
+  }
+
+
+} // namespace casadi
@@ -0,0 +1,145 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_CYCLIC_INDEF_DPLE_INTERNAL_HPP
+#define CASADI_CYCLIC_INDEF_DPLE_INTERNAL_HPP
+
+#include "../core/function/dple_internal.hpp"
+#include "../core/function/dle_internal.hpp"
+#include <casadi/solvers/casadi_dplesolver_cyclic_export.h>
+
+/** \defgroup plugin_DpleSolver_cyclic
+ Solving the Discrete Periodic Lyapunov Equations with a parallel cyclic
+ reduction of the period to a single Discrete Lyapunov Equation
+
+*/
+/** \pluginsection{DpleSolver,cyclic} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{DpleSolver,cyclic}
+
+    Like the condensing approach, the discrete periodic Lyapunov equations are
+    reduced to one small and dense discrete Lyapunov equation. The reduction is
+    not done sequentially over the K periods, but in log2(K) stages of mutually
+    independent compositions.
+
+    Each equation is an affine map from P_k to P_{k+1}:
+
+    \verbatim
+      P_{k+1} = A_k P_k A_k^T + V_k
+    \endverbatim
+
+    Two such maps compose to a map of the same form:
+
+    \verbatim
+      (A2, V2) o (A1, V1) = (A2 A1, A2 V1 A2^T + V2)
+    \endverbatim
+
+    A parallel prefix scan over the maps yields, for every k, the map
+    (Phi_k, W_k) from P_0 to P_{k+1}. In stage j = 0, 1, ..., each map k >= 2^j is
+    composed with map k-2^j. The full period map gives a single DLE:
+
+    \verbatim
+      P_0 = Phi_{K-1} P_0 Phi_{K-1}^T + W_{K-1}
+    \endverbatim
+
+    The remaining outputs are then obtained independently of each other:
+
+    \verbatim
+      P_{k+1} = Phi_k P_0 Phi_k^T + W_k
+    \endverbatim
+
+    The compositions of a stage are evaluated with Function::callParallel, so
+    the derivatives of the solver have the same parallel structure.
+
+   @copydoc DPLE_doc
+   @copydoc plugin_DpleSolver_cyclic
+
+  */
+  class CASADI_DPLESOLVER_CYCLIC_EXPORT CyclicIndefDpleInternal : public DpleInternal,
+    public Adaptor<CyclicIndefDpleInternal, DleInternal>,
+    public Wrapper<CyclicIndefDpleInternal> {
+  public:
+    /** \brief  Constructor
+     * \param st \structargument{Dple}
+     */
+    CyclicIndefDpleInternal(const DpleStructure& st);
+
+    /** \brief  Destructor */
+    virtual ~CyclicIndefDpleInternal();
+
+    /** \brief  Clone */
+    virtual CyclicIndefDpleInternal* clone() const;
+
+    /** \brief  Deep copy data members */
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    /** \brief  Create a new solver */
+    virtual CyclicIndefDpleInternal* create(const DpleStructure& st) const {
+        return new CyclicIndefDpleInternal(st);}
+
+    /** \brief  Create a new DPLE Solver */
+    static DpleInternal* creator(const DpleStructure& st) {
+        return new CyclicIndefDpleInternal(st);}
+
+    /** \brief  Print solver statistics */
+    virtual void printStats(std::ostream &stream) const {}
+
+    /** \brief  evaluate */
+    virtual void evaluate();
+
+    /** \brief  Initialize */
+    virtual void init();
+
+    /** \brief  Obtain solver name from Adaptor */
+    virtual std::string getAdaptorSolverName() const { return solvername(); }
+
+    /** \brief Generate a function that calculates \a nfwd forward derivatives
+     and \a nadj adjoint derivatives
+    */
+    virtual Function getDerivative(int nfwd, int nadj);
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+    /// Solve with
+    DleSolver solver_;
+
+  private:
+
+    /// Evaluate the independent calls of a stage
+    std::vector<std::vector<MX> > callStage(Function& f,
+                                            const std::vector<std::vector<MX> >& arg);
+
+    /// State space dimension
+    int n_;
+
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_CYCLIC_INDEF_DPLE_INTERNAL_HPP
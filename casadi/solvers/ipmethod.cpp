@@ -0,0 +1,776 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "ipmethod.hpp"
+#include "casadi/core/std_vector_tools.hpp"
+#include "casadi/core/matrix/matrix_tools.hpp"
+#include "casadi/core/mx/mx_tools.hpp"
+#include "casadi/core/function/mx_function.hpp"
+#include "casadi/core/function/sx_function.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_NLPSOLVER_IPMETHOD_EXPORT
+      casadi_register_nlpsolver_ipmethod(NlpSolverInternal::Plugin* plugin) {
+    plugin->creator = Ipmethod::creator;
+    plugin->name = "ipmethod";
+    plugin->doc = Ipmethod::meta_doc.c_str();
+    plugin->version = 22;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_NLPSOLVER_IPMETHOD_EXPORT casadi_load_nlpsolver_ipmethod() {
+    NlpSolverInternal::registerPlugin(casadi_register_nlpsolver_ipmethod);
+  }
+
+  Ipmethod::Ipmethod(const Function& nlp) : NlpSolverInternal(nlp) {
+    addOption("max_iter",              OT_INTEGER,    100,
+              "Maximum number of interior point iterations");
+    addOption("max_iter_ls",           OT_INTEGER,    20,
+              "Maximum number of linesearch iterations");
+    addOption("tol",                   OT_REAL,       1e-8,
+              "Tolerance on the scaled primal infeasibility, dual infeasibility "
+              "and complementarity");
+    addOption("mu_init",               OT_REAL,       0.1,
+              "Initial barrier parameter");
+    addOption("bound_push",            OT_REAL,       1e-2,
+              "Minimal relative distance of the initial point to the bounds");
+    addOption("bound_relax_factor",    OT_REAL,       1e-8,
+              "Relative relaxation of the bounds, which gives fixed variables "
+              "and tight inequalities a nonempty interior");
+    addOption("linear_solver",         OT_STRING,     "csparse",
+              "The linear solver to be used for the KKT system");
+    addOption("linear_solver_options", OT_DICTIONARY, GenericType(),
+              "Options to be passed to the linear solver");
+    addOption("print_header",          OT_BOOLEAN,    true,
+              "Print the header with problem statistics");
+  }
+
+  Ipmethod::~Ipmethod() {
+  }
+
+  void Ipmethod::deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied) {
+    NlpSolverInternal::deepCopyMembers(already_copied);
+    kkt_fcn_ = deepcopy(kkt_fcn_, already_copied);
+    linsol_ = deepcopy(linsol_, already_copied);
+  }
+
+  void Ipmethod::init() {
+    // Call the init method of the base class
+    NlpSolverInternal::init();
+
+    // Read options
+    max_iter_ = getOption("max_iter");
+    max_iter_ls_ = getOption("max_iter_ls");
+    tol_ = getOption("tol");
+    mu_init_ = getOption("mu_init");
+    bound_push_ = getOption("bound_push");
+    bound_relax_factor_ = getOption("bound_relax_factor");
+    print_header_ = getOption("print_header");
+
+    // Symbolic arguments of the KKT function
+    vector<MX> kkt_in(KKT_NUM_IN);
+    kkt_in[KKT_X] = MX::sym("x", nx_);
+    kkt_in[KKT_P] = MX::sym("p", nlp_.input(NL_P).sparsity());
+    kkt_in[KKT_LAM_G] = MX::sym("lam_g", ng_);
+    kkt_in[KKT_SIGMA_X] = MX::sym("sigma_x", nx_);
+    kkt_in[KKT_D_G] = MX::sym("d_g", ng_);
+
+    // Hessian of the Lagrangian, its gradient, objective and constraints
+    vector<MX> arg(HESSLAG_NUM_IN);
+    arg[HESSLAG_X] = kkt_in[KKT_X];
+    arg[HESSLAG_P] = kkt_in[KKT_P];
+    arg[HESSLAG_LAM_F] = 1;
+    arg[HESSLAG_LAM_G] = kkt_in[KKT_LAM_G];
+    vector<MX> res = hessLag().call(arg);
+    MX H = res[HESSLAG_HESS] + diag(kkt_in[KKT_SIGMA_X]);
+
+    // Assemble the KKT function
+    vector<MX> kkt_out(KKT_NUM_OUT);
+    kkt_out[KKT_GRAD_LAG] = vec(res[HESSLAG_GRAD_X]);
+    kkt_out[KKT_F] = res[HESSLAG_F];
+    kkt_out[KKT_G] = vec(res[HESSLAG_G]);
+    if (ng_>0) {
+      arg.resize(JACG_NUM_IN);
+      arg[JACG_X] = kkt_in[KKT_X];
+      arg[JACG_P] = kkt_in[KKT_P];
+      MX J = jacG().call(arg).at(JACG_JAC);
+      kkt_out[KKT_JAC] = J;
+      kkt_out[KKT_K] = blockcat(H, J.T(), J, -diag(kkt_in[KKT_D_G]));
+    } else {
+      kkt_out[KKT_JAC] = MX(Sparsity::sparse(0, nx_));
+      kkt_out[KKT_K] = H;
+    }
+    MXFunction kkt_fcn(kkt_in, kkt_out);
+    kkt_fcn.setOption("name", "kkt");
+    kkt_fcn.init();
+
+    // Expand when the NLP is given in scalar operations
+    if (is_a<SXFunction>(nlp_)) {
+      kkt_fcn_ = SXFunction(kkt_fcn);
+      kkt_fcn_.setOption("name", "kkt");
+      kkt_fcn_.init();
+    } else {
+      kkt_fcn_ = kkt_fcn;
+    }
+
+    // The barrier terms guarantee a structurally nonzero diagonal
+    const Sparsity& spK = kkt_fcn_.output(KKT_K).sparsity();
+    kkt_diag_.resize(nx_+ng_);
+    for (int i=0; i<nx_+ng_; ++i) {
+      kkt_diag_[i] = spK.getNZ(i, i);
+      casadi_assert(kkt_diag_[i]>=0);
+    }
+
+    // Allocate a linear solver
+    std::string linear_solver_name = getOption("linear_solver");
+    linsol_ = LinearSolver(linear_solver_name, spK, 1);
+    if (hasSetOption("linear_solver_options")) {
+      const Dictionary& linear_solver_options = getOption("linear_solver_options");
+      linsol_.setOption(linear_solver_options);
+    }
+    linsol_.init();
+
+    // Allocate work vectors
+    kkt_.resize(spK.size());
+    row_type_.resize(ng_);
+    lbx_.resize(nx_);
+    ubx_.resize(nx_);
+    lbs_.resize(ng_);
+    ubs_.resize(ng_);
+    x_.resize(nx_);
+    x_trial_.resize(nx_);
+    s_.resize(ng_);
+    s_trial_.resize(ng_);
+    lam_g_.resize(ng_);
+    zl_.resize(nx_);
+    zu_.resize(nx_);
+    vl_.resize(ng_);
+    vu_.resize(ng_);
+    g_.resize(ng_);
+    g_trial_.resize(ng_);
+    grad_lag_.resize(nx_);
+    sigma_x_.resize(nx_);
+    d_g_.resize(ng_);
+    rhs_.resize(nx_+ng_);
+    dx_.resize(nx_);
+    ds_.resize(ng_);
+    dlam_.resize(ng_);
+    dzl_.resize(nx_);
+    dzu_.resize(nx_);
+    dvl_.resize(ng_);
+    dvu_.resize(ng_);
+    jdx_.resize(ng_);
+    r_x_.resize(nx_);
+    r_s_.resize(ng_);
+
+    // Print problem statistics
+    if (print_header_) {
+      cout << "-------------------------------------------" << endl;
+      cout << "This is casadi::Ipmethod." << endl;
+      cout << "Using linear solver \"" << linear_solver_name << "\"" << endl;
+      cout << "Number of variables:                       " << setw(9) << nx_ << endl;
+      cout << "Number of constraints:                     " << setw(9) << ng_ << endl;
+      cout << "Number of nonzeros in the KKT matrix:      " << setw(9) << spK.size() << endl;
+      cout << endl;
+    }
+  }
+
+  void Ipmethod::evaluate() {
+    if (inputs_check_) checkInputs();
+    checkInitialBounds();
+
+    if (gather_stats_) {
+      Dictionary iterations;
+      iterations["inf_pr"] = std::vector<double>();
+      iterations["inf_du"] = std::vector<double>();
+      iterations["mu"] = std::vector<double>();
+      iterations["d_norm"] = std::vector<double>();
+      iterations["alpha_pr"] = std::vector<double>();
+      iterations["ls_trials"] = std::vector<double>();
+      iterations["obj"] = std::vector<double>();
+      stats_["iterations"] = iterations;
+    }
+
+    // Get problem data
+    const vector<double>& x_init = input(NLP_SOLVER_X0).data();
+    const vector<double>& lam_g_init = input(NLP_SOLVER_LAM_G0).data();
+    const vector<double>& lbx = input(NLP_SOLVER_LBX).data();
+    const vector<double>& ubx = input(NLP_SOLVER_UBX).data();
+    const vector<double>& lbg = input(NLP_SOLVER_LBG).data();
+    const vector<double>& ubg = input(NLP_SOLVER_UBG).data();
+    const double inf = numeric_limits<double>::infinity();
+
+    // Relax the bounds on x
+    for (int i=0; i<nx_; ++i) {
+      lbx_[i] = lbx[i] - bound_relax_factor_*std::max(1., fabs(lbx[i]));
+      ubx_[i] = ubx[i] + bound_relax_factor_*std::max(1., fabs(ubx[i]));
+    }
+
+    // Classify the constraints, inequalities get a slack with relaxed bounds
+    for (int j=0; j<ng_; ++j) {
+      if (lbg[j]==ubg[j]) {
+        row_type_[j] = ROW_EQ;
+      } else if (lbg[j]==-inf && ubg[j]==inf) {
+        row_type_[j] = ROW_FREE;
+      } else {
+        row_type_[j] = ROW_INEQ;
+      }
+      if (row_type_[j]==ROW_INEQ) {
+        lbs_[j] = lbg[j] - bound_relax_factor_*std::max(1., fabs(lbg[j]));
+        ubs_[j] = ubg[j] + bound_relax_factor_*std::max(1., fabs(ubg[j]));
+      } else {
+        lbs_[j] = -inf;
+        ubs_[j] = inf;
+      }
+    }
+
+    // Move the initial guess into the interior
+    copy(x_init.begin(), x_init.end(), x_.begin());
+    pushIntoInterior(x_, lbx_, ubx_);
+    eval_fg(x_, f_, g_);
+    copy(g_.begin(), g_.end(), s_.begin());
+    pushIntoInterior(s_, lbs_, ubs_);
+
+    // Initial multipliers
+    for (int j=0; j<ng_; ++j) {
+      lam_g_[j] = row_type_[j]==ROW_FREE ? 0 : lam_g_init[j];
+      vl_[j] = row_type_[j]==ROW_INEQ && lbs_[j]>-inf ? 1 : 0;
+      vu_[j] = row_type_[j]==ROW_INEQ && ubs_[j]<inf ? 1 : 0;
+      ds_[j] = 0;
+    }
+    int n_bounds = 0;
+    for (int i=0; i<nx_; ++i) {
+      zl_[i] = lbx_[i]>-inf ? 1 : 0;
+      zu_[i] = ubx_[i]<inf ? 1 : 0;
+      n_bounds += (lbx_[i]>-inf) + (ubx_[i]<inf);
+    }
+    for (int j=0; j<ng_; ++j) {
+      n_bounds += (lbs_[j]>-inf) + (ubs_[j]<inf);
+    }
+
+    // Barrier parameter, merit penalty and last regularization
+    double mu = mu_init_;
+    double nu = 0;
+    double reg_last = 0;
+
+    // Iteration information
+    int iter = 0;
+    int ls_iter = 0;
+    double d_norm = 0, reg = 0, alpha_pr = 0;
+
+    // MAIN OPTIMIZATION LOOP
+    while (true) {
+      // Barrier Hessian terms, an effectively infinite value removes free constraints
+      for (int i=0; i<nx_; ++i) {
+        sigma_x_[i] = 0;
+        if (lbx_[i]>-inf) sigma_x_[i] += zl_[i]/(x_[i]-lbx_[i]);
+        if (ubx_[i]<inf) sigma_x_[i] += zu_[i]/(ubx_[i]-x_[i]);
+      }
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_EQ) {
+          d_g_[j] = 0;
+        } else if (row_type_[j]==ROW_FREE) {
+          d_g_[j] = 1e20;
+        } else {
+          double sigma_s = 0;
+          if (lbs_[j]>-inf) sigma_s += vl_[j]/(s_[j]-lbs_[j]);
+          if (ubs_[j]<inf) sigma_s += vu_[j]/(ubs_[j]-s_[j]);
+          d_g_[j] = 1/sigma_s;
+        }
+      }
+
+      // KKT matrix and residuals in the current iterate
+      eval_kkt();
+
+      // Dual infeasibility
+      double du_inf = 0;
+      for (int i=0; i<nx_; ++i) {
+        r_x_[i] = grad_lag_[i] - zl_[i] + zu_[i];
+        du_inf = std::max(du_inf, fabs(r_x_[i]));
+      }
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_INEQ) {
+          r_s_[j] = -lam_g_[j] - vl_[j] + vu_[j];
+          du_inf = std::max(du_inf, fabs(r_s_[j]));
+        }
+      }
+
+      // Primal infeasibility
+      double pr_inf = 0;
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_EQ) {
+          pr_inf = std::max(pr_inf, fabs(g_[j]-lbg[j]));
+        } else if (row_type_[j]==ROW_INEQ) {
+          pr_inf = std::max(pr_inf, fabs(g_[j]-s_[j]));
+        }
+      }
+
+      // Scaling of the optimality error, as large multipliers indicate a degenerate problem
+      const double s_max = 100;
+      double sum_lam = 0, sum_z = 0;
+      for (int j=0; j<ng_; ++j) {
+        sum_lam += fabs(lam_g_[j]);
+        sum_z += vl_[j] + vu_[j];
+      }
+      for (int i=0; i<nx_; ++i) sum_z += zl_[i] + zu_[i];
+      double s_d = std::max(s_max, (sum_lam+sum_z)/std::max(1, ng_+n_bounds))/s_max;
+      double s_c = std::max(s_max, sum_z/std::max(1, n_bounds))/s_max;
+
+      // Optimality error of the barrier problem
+      double compl_0 = complementarity(0), compl_mu = complementarity(mu);
+      double err_0 = std::max(std::max(du_inf/s_d, pr_inf), compl_0/s_c);
+
+      // Decrease the barrier parameter once the barrier problem is solved accurately enough
+      while (mu > tol_/10) {
+        double err_mu = std::max(std::max(du_inf/s_d, pr_inf), compl_mu/s_c);
+        if (err_mu > 10*mu) break;
+        mu = std::max(tol_/10, std::min(0.2*mu, std::pow(mu, 1.5)));
+        compl_mu = complementarity(mu);
+        nu = 0;
+      }
+
+      // Print header occasionally
+      if (iter % 10 == 0) printIteration(cout);
+
+      // Printing information about the actual iterate
+      printIteration(cout, iter, f_, pr_inf, du_inf, mu, d_norm, reg, alpha_pr, ls_iter);
+
+      if (gather_stats_) {
+        Dictionary & iterations = stats_["iterations"];
+        static_cast<std::vector<double> &>(iterations["inf_pr"]).push_back(pr_inf);
+        static_cast<std::vector<double> &>(iterations["inf_du"]).push_back(du_inf);
+        static_cast<std::vector<double> &>(iterations["mu"]).push_back(mu);
+        static_cast<std::vector<double> &>(iterations["d_norm"]).push_back(d_norm);
+        static_cast<std::vector<double> &>(iterations["alpha_pr"]).push_back(alpha_pr);
+        static_cast<std::vector<double> &>(iterations["ls_trials"]).push_back(ls_iter);
+        static_cast<std::vector<double> &>(iterations["obj"]).push_back(f_);
+      }
+
+      // Call callback function if present
+      if (!callback_.isNull()) {
+        if (!output(NLP_SOLVER_F).isEmpty()) output(NLP_SOLVER_F).set(f_);
+        if (!output(NLP_SOLVER_X).isEmpty()) output(NLP_SOLVER_X).set(x_);
+        if (!output(NLP_SOLVER_LAM_G).isEmpty()) output(NLP_SOLVER_LAM_G).set(lam_g_);
+        if (!output(NLP_SOLVER_LAM_X).isEmpty()) setLamX();
+        if (!output(NLP_SOLVER_G).isEmpty()) output(NLP_SOLVER_G).set(g_);
+
+        Dictionary iteration;
+        iteration["iter"] = iter;
+        iteration["inf_pr"] = pr_inf;
+        iteration["inf_du"] = du_inf;
+        iteration["mu"] = mu;
+        iteration["d_norm"] = d_norm;
+        iteration["ls_trials"] = ls_iter;
+        iteration["obj"] = f_;
+        stats_["iteration"] = iteration;
+
+        if (callback_(ref_, user_data_)) {
+          cout << endl;
+          cout << "casadi::Ipmethod: aborted by callback..." << endl;
+          stats_["return_status"] = "User_Requested_Stop";
+          break;
+        }
+      }
+
+      // Checking convergence criteria
+      if (err_0 <= tol_) {
+        cout << endl;
+        cout << "casadi::Ipmethod: Convergence achieved after " << iter << " iterations." << endl;
+        stats_["return_status"] = "Solve_Succeeded";
+        break;
+      }
+
+      if (iter >= max_iter_) {
+        cout << endl;
+        cout << "casadi::Ipmethod: Maximum number of iterations reached." << endl;
+        stats_["return_status"] = "Maximum_Iterations_Exceeded";
+        break;
+      }
+
+      // Start a new iteration
+      iter++;
+
+      // Right-hand side of the reduced KKT system, with the slacks eliminated
+      for (int i=0; i<nx_; ++i) {
+        double r = grad_lag_[i];
+        if (lbx_[i]>-inf) r -= mu/(x_[i]-lbx_[i]);
+        if (ubx_[i]<inf) r += mu/(ubx_[i]-x_[i]);
+        r_x_[i] = r;
+        rhs_[i] = -r;
+      }
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_EQ) {
+          rhs_[nx_+j] = lbg[j] - g_[j];
+        } else if (row_type_[j]==ROW_FREE) {
+          rhs_[nx_+j] = 0;
+        } else {
+          double r = -lam_g_[j];
+          if (lbs_[j]>-inf) r -= mu/(s_[j]-lbs_[j]);
+          if (ubs_[j]<inf) r += mu/(ubs_[j]-s_[j]);
+          r_s_[j] = r;
+          rhs_[nx_+j] = s_[j] - g_[j] - d_g_[j]*r;
+        }
+      }
+
+      // Factorize and solve, regularizing until the step has sufficient curvature
+      double delta_w = 0, delta_c = 0;
+      bool step_ok = false;
+      while (true) {
+        vector<double>& K = linsol_.input(LINSOL_A).data();
+        copy(kkt_.begin(), kkt_.end(), K.begin());
+        for (int i=0; i<nx_; ++i) K[kkt_diag_[i]] += delta_w;
+        for (int j=0; j<ng_; ++j) K[kkt_diag_[nx_+j]] -= delta_c;
+
+        bool singular = false;
+        try {
+          linsol_.prepare();
+        } catch(exception& ex) {
+          log("Ipmethod::evaluate", string("Factorization failed: ") + ex.what());
+          singular = true;
+        }
+        if (!singular) {
+          vector<double>& sol = linsol_.input(LINSOL_B).data();
+          copy(rhs_.begin(), rhs_.end(), sol.begin());
+          linsol_.solve(getPtr(sol), 1, false);
+          for (int k=0; k<sol.size(); ++k) {
+            if (isinf(sol[k])) singular = true;
+          }
+          copy(sol.begin(), sol.begin()+nx_, dx_.begin());
+          copy(sol.begin()+nx_, sol.end(), dlam_.begin());
+        }
+
+        // Accept if d'*W*d >= kappa*d'*d, using W*dx = -r_x - J'*dlam
+        if (!singular) {
+          fill(jdx_.begin(), jdx_.end(), 0);
+          if (ng_>0) DMatrix::mul_no_alloc(kkt_fcn_.output(KKT_JAC), dx_, jdx_);
+          double curv = 0, dd = 0;
+          for (int i=0; i<nx_; ++i) {
+            curv -= dx_[i]*r_x_[i];
+            dd += dx_[i]*dx_[i];
+          }
+          for (int j=0; j<ng_; ++j) {
+            curv -= jdx_[j]*dlam_[j];
+            if (row_type_[j]==ROW_INEQ) {
+              ds_[j] = d_g_[j]*(dlam_[j] - r_s_[j]);
+              curv += ds_[j]*ds_[j]/d_g_[j];
+              dd += ds_[j]*ds_[j];
+            }
+          }
+          if (curv >= 1e-8*dd) {
+            step_ok = true;
+            break;
+          }
+        } else if (delta_c==0 && ng_>0) {
+          // Possibly rank-deficient constraint Jacobian
+          delta_c = 1e-8*std::pow(mu, 0.25);
+          continue;
+        }
+
+        // Increase the regularization of the Hessian block
+        if (delta_w==0) {
+          delta_w = reg_last==0 ? 1e-4 : std::max(1e-20, reg_last/3);
+        } else {
+          delta_w *= reg_last==0 ? 100 : 8;
+        }
+        if (delta_w>1e40) break;
+      }
+      if (!step_ok) {
+        cout << endl;
+        cout << "casadi::Ipmethod: The KKT system could not be regularized." << endl;
+        stats_["return_status"] = "Error_In_Step_Computation";
+        break;
+      }
+      reg = delta_w;
+      if (delta_w>0) reg_last = delta_w;
+
+      // Steps in the bound multipliers
+      for (int i=0; i<nx_; ++i) {
+        dzl_[i] = dzu_[i] = 0;
+        if (lbx_[i]>-inf) {
+          double gap = x_[i]-lbx_[i];
+          dzl_[i] = (mu - zl_[i]*(gap + dx_[i]))/gap;
+        }
+        if (ubx_[i]<inf) {
+          double gap = ubx_[i]-x_[i];
+          dzu_[i] = (mu - zu_[i]*(gap - dx_[i]))/gap;
+        }
+      }
+      for (int j=0; j<ng_; ++j) {
+        dvl_[j] = dvu_[j] = 0;
+        if (row_type_[j]!=ROW_INEQ) continue;
+        if (lbs_[j]>-inf) {
+          double gap = s_[j]-lbs_[j];
+          dvl_[j] = (mu - vl_[j]*(gap + ds_[j]))/gap;
+        }
+        if (ubs_[j]<inf) {
+          double gap = ubs_[j]-s_[j];
+          dvu_[j] = (mu - vu_[j]*(gap - ds_[j]))/gap;
+        }
+      }
+
+      // Fraction to the boundary rule
+      double tau = std::max(0.99, 1-mu);
+      double alpha_max = std::min(maxStep(x_, dx_, lbx_, ubx_, tau),
+                                  maxStep(s_, ds_, lbs_, ubs_, tau));
+      double alpha_du = std::min(std::min(maxStep(zl_, dzl_, tau), maxStep(zu_, dzu_, tau)),
+                                 std::min(maxStep(vl_, dvl_, tau), maxStep(vu_, dvu_, tau)));
+
+      // Penalty parameter of the merit function, large enough for a descent direction
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]!=ROW_FREE) nu = std::max(nu, 1.1*fabs(lam_g_[j]+dlam_[j]));
+      }
+
+      // Directional derivative of the merit function
+      double merit_0 = merit(x_, s_, f_, g_, mu, nu);
+      double dmerit = 0;
+      for (int i=0; i<nx_; ++i) {
+        dmerit += r_x_[i]*dx_[i];
+      }
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_FREE) continue;
+        dmerit -= lam_g_[j]*jdx_[j];
+        if (row_type_[j]==ROW_INEQ) {
+          if (lbs_[j]>-inf) dmerit -= mu*ds_[j]/(s_[j]-lbs_[j]);
+          if (ubs_[j]<inf) dmerit += mu*ds_[j]/(ubs_[j]-s_[j]);
+          dmerit -= nu*fabs(g_[j]-s_[j]);
+        } else {
+          dmerit -= nu*fabs(g_[j]-lbg[j]);
+        }
+      }
+
+      // Backtracking line search
+      double alpha = alpha_max, f_trial = 0, merit_trial = inf;
+      for (ls_iter=1; ; ++ls_iter) {
+        for (int i=0; i<nx_; ++i) x_trial_[i] = x_[i] + alpha*dx_[i];
+        for (int j=0; j<ng_; ++j) s_trial_[j] = s_[j] + alpha*ds_[j];
+        try {
+          eval_fg(x_trial_, f_trial, g_trial_);
+          merit_trial = merit(x_trial_, s_trial_, f_trial, g_trial_, mu, nu);
+        } catch(exception& ex) {
+          log("Ipmethod::evaluate", string("Evaluation failed: ") + ex.what());
+          merit_trial = inf;
+        }
+        if (merit_trial <= merit_0 + 1e-4*alpha*dmerit) break;
+        if (ls_iter >= max_iter_ls_) break;
+        alpha *= 0.5;
+      }
+      if (isinf(merit_trial)) {
+        cout << endl;
+        cout << "casadi::Ipmethod: Invalid number in the line search." << endl;
+        stats_["return_status"] = "Invalid_Number_Detected";
+        break;
+      }
+
+      // Take the step
+      copy(x_trial_.begin(), x_trial_.end(), x_.begin());
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]==ROW_INEQ) s_[j] = s_trial_[j];
+        if (row_type_[j]!=ROW_FREE) lam_g_[j] += alpha*dlam_[j];
+      }
+      for (int i=0; i<nx_; ++i) {
+        zl_[i] += alpha_du*dzl_[i];
+        zu_[i] += alpha_du*dzu_[i];
+      }
+      for (int j=0; j<ng_; ++j) {
+        vl_[j] += alpha_du*dvl_[j];
+        vu_[j] += alpha_du*dvu_[j];
+      }
+
+      // Keep the bound multipliers close to the central path
+      const double kappa_sigma = 1e10;
+      for (int i=0; i<nx_; ++i) {
+        if (lbx_[i]>-inf) zl_[i] = safeguard(zl_[i], x_[i]-lbx_[i], mu, kappa_sigma);
+        if (ubx_[i]<inf) zu_[i] = safeguard(zu_[i], ubx_[i]-x_[i], mu, kappa_sigma);
+      }
+      for (int j=0; j<ng_; ++j) {
+        if (row_type_[j]!=ROW_INEQ) continue;
+        if (lbs_[j]>-inf) vl_[j] = safeguard(vl_[j], s_[j]-lbs_[j], mu, kappa_sigma);
+        if (ubs_[j]<inf) vu_[j] = safeguard(vu_[j], ubs_[j]-s_[j], mu, kappa_sigma);
+      }
+
+      d_norm = norm_inf(dx_);
+      alpha_pr = alpha;
+    }
+
+    // Save results to outputs
+    output(NLP_SOLVER_F).set(f_);
+    output(NLP_SOLVER_X).set(x_);
+    output(NLP_SOLVER_LAM_G).set(lam_g_);
+    setLamX();
+    output(NLP_SOLVER_G).set(g_);
+
+    stats_["iter_count"] = iter;
+  }
+
+  void Ipmethod::setLamX() {
+    vector<double>& lam_x = output(NLP_SOLVER_LAM_X).data();
+    for (int i=0; i<nx_; ++i) lam_x[i] = zu_[i] - zl_[i];
+  }
+
+  void Ipmethod::eval_kkt() {
+    kkt_fcn_.setInput(x_, KKT_X);
+    kkt_fcn_.setInput(input(NLP_SOLVER_P), KKT_P);
+    kkt_fcn_.setInput(lam_g_, KKT_LAM_G);
+    kkt_fcn_.setInput(sigma_x_, KKT_SIGMA_X);
+    kkt_fcn_.setInput(d_g_, KKT_D_G);
+    kkt_fcn_.evaluate();
+    kkt_fcn_.getOutput(kkt_, KKT_K);
+    kkt_fcn_.getOutput(grad_lag_, KKT_GRAD_LAG);
+    kkt_fcn_.getOutput(f_, KKT_F);
+    kkt_fcn_.getOutput(g_, KKT_G);
+  }
+
+  void Ipmethod::eval_fg(const std::vector<double>& x, double& f, std::vector<double>& g) {
+    nlp_.setInput(x, NL_X);
+    nlp_.setInput(input(NLP_SOLVER_P), NL_P);
+    nlp_.evaluate();
+    nlp_.getOutput(f, NL_F);
+    nlp_.getOutput(g, NL_G);
+  }
+
+  void Ipmethod::pushIntoInterior(std::vector<double>& v, const std::vector<double>& lb,
+                                  const std::vector<double>& ub) const {
+    const double inf = numeric_limits<double>::infinity();
+    for (int k=0; k<v.size(); ++k) {
+      double pl = bound_push_*std::max(1., fabs(lb[k]));
+      double pu = bound_push_*std::max(1., fabs(ub[k]));
+      if (lb[k]>-inf && ub[k]<inf) {
+        pl = std::min(pl, bound_push_*(ub[k]-lb[k]));
+        pu = std::min(pu, bound_push_*(ub[k]-lb[k]));
+      }
+      if (lb[k]>-inf) v[k] = std::max(v[k], lb[k]+pl);
+      if (ub[k]<inf) v[k] = std::min(v[k], ub[k]-pu);
+    }
+  }
+
+  double Ipmethod::complementarity(double mu) const {
+    const double inf = numeric_limits<double>::infinity();
+    double ret = 0;
+    for (int i=0; i<nx_; ++i) {
+      if (lbx_[i]>-inf) ret = std::max(ret, fabs((x_[i]-lbx_[i])*zl_[i] - mu));
+      if (ubx_[i]<inf) ret = std::max(ret, fabs((ubx_[i]-x_[i])*zu_[i] - mu));
+    }
+    for (int j=0; j<ng_; ++j) {
+      if (row_type_[j]!=ROW_INEQ) continue;
+      if (lbs_[j]>-inf) ret = std::max(ret, fabs((s_[j]-lbs_[j])*vl_[j] - mu));
+      if (ubs_[j]<inf) ret = std::max(ret, fabs((ubs_[j]-s_[j])*vu_[j] - mu));
+    }
+    return ret;
+  }
+
+  double Ipmethod::merit(const std::vector<double>& x, const std::vector<double>& s,
+                         double f, const std::vector<double>& g, double mu, double nu) const {
+    const double inf = numeric_limits<double>::infinity();
+    const vector<double>& lbg = input(NLP_SOLVER_LBG).data();
+    double ret = f;
+    for (int i=0; i<nx_; ++i) {
+      if (lbx_[i]>-inf) ret -= mu*std::log(x[i]-lbx_[i]);
+      if (ubx_[i]<inf) ret -= mu*std::log(ubx_[i]-x[i]);
+    }
+    for (int j=0; j<ng_; ++j) {
+      if (row_type_[j]==ROW_EQ) {
+        ret += nu*fabs(g[j]-lbg[j]);
+      } else if (row_type_[j]==ROW_INEQ) {
+        if (lbs_[j]>-inf) ret -= mu*std::log(s[j]-lbs_[j]);
+        if (ubs_[j]<inf) ret -= mu*std::log(ubs_[j]-s[j]);
+        ret += nu*fabs(g[j]-s[j]);
+      }
+    }
+    return isnan(ret) ? inf : ret;
+  }
+
+  double Ipmethod::safeguard(double z, double gap, double mu, double kappa) {
+    return std::max(std::min(z, kappa*mu/gap), mu/(kappa*gap));
+  }
+
+  double Ipmethod::maxStep(const std::vector<double>& v, const std::vector<double>& dv,
+                           const std::vector<double>& lb, const std::vector<double>& ub,
+                           double tau) {
+    double alpha = 1;
+    for (int k=0; k<v.size(); ++k) {
+      if (dv[k]<0 && lb[k]>-numeric_limits<double>::infinity()) {
+        alpha = std::min(alpha, -tau*(v[k]-lb[k])/dv[k]);
+      } else if (dv[k]>0 && ub[k]<numeric_limits<double>::infinity()) {
+        alpha = std::min(alpha, tau*(ub[k]-v[k])/dv[k]);
+      }
+    }
+    return alpha;
+  }
+
+  double Ipmethod::maxStep(const std::vector<double>& v, const std::vector<double>& dv,
+                           double tau) {
+    double alpha = 1;
+    for (int k=0; k<v.size(); ++k) {
+      if (dv[k]<0) alpha = std::min(alpha, -tau*v[k]/dv[k]);
+    }
+    return alpha;
+  }
+
+  void Ipmethod::printIteration(std::ostream &stream) {
+    stream << setw(4)  << "iter";
+    stream << setw(15) << "objective";
+    stream << setw(10) << "inf_pr";
+    stream << setw(10) << "inf_du";
+    stream << setw(7) << "lg(mu)";
+    stream << setw(10) << "||d||";
+    stream << setw(7) << "lg(rg)";
+    stream << setw(10) << "alpha_pr";
+    stream << setw(3) << "ls";
+    stream << endl;
+  }
+
+  void Ipmethod::printIteration(std::ostream &stream, int iter, double obj,
+                                double pr_inf, double du_inf, double mu,
+                                double d_norm, double rg, double alpha_pr, int ls_trials) {
+    stream << setw(4) << iter;
+    stream << scientific;
+    stream << setw(15) << setprecision(6) << obj;
+    stream << setw(10) << setprecision(2) << pr_inf;
+    stream << setw(10) << setprecision(2) << du_inf;
+    stream << fixed;
+    stream << setw(7) << setprecision(1) << log10(mu);
+    stream << scientific;
+    stream << setw(10) << setprecision(2) << d_norm;
+    stream << fixed;
+    if (rg>0) {
+      stream << setw(7) << setprecision(1) << log10(rg);
+    } else {
+      stream << setw(7) << "-";
+    }
+    stream << scientific;
+    stream << setw(10) << setprecision(2) << alpha_pr;
+    stream << setw(3) << ls_trials;
+    stream << endl;
+  }
+
+} // namespace casadi
@@ -0,0 +1,173 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_IPMETHOD_HPP
+#define CASADI_IPMETHOD_HPP
+
+#include "casadi/core/function/nlp_solver_internal.hpp"
+#include "casadi/core/function/linear_solver.hpp"
+
+#include <casadi/solvers/casadi_nlpsolver_ipmethod_export.h>
+
+/** \defgroup plugin_NlpSolver_ipmethod
+ A primal-dual interior point method.
+
+ Inequality constraints are reformulated with slack variables and all bounds are
+ handled with a logarithmic barrier. The slacks and the bound multipliers are
+ eliminated from the Newton system, leaving a symmetric KKT matrix in (x, lam_g)
+ whose sparsity is determined once at initialization. A single function,
+ generated from the Hessian of the Lagrangian and the constraint Jacobian,
+ evaluates the KKT matrix and the residuals in each iteration; it is factorized
+ with a LinearSolver plugin.
+
+ The step is globalized with a backtracking line search on an l1 merit function.
+ Since the linear solvers do not report the inertia, the Hessian block is
+ regularized until the step has sufficient curvature.
+*/
+
+/** \pluginsection{NlpSolver,ipmethod} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief  \pluginbrief{NlpSolver,ipmethod}
+  *  @copydoc NLPSolver_doc
+  *  @copydoc plugin_NlpSolver_ipmethod
+  */
+  class CASADI_NLPSOLVER_IPMETHOD_EXPORT Ipmethod : public NlpSolverInternal {
+  public:
+    explicit Ipmethod(const Function& nlp);
+    virtual ~Ipmethod();
+    virtual Ipmethod* clone() const { return new Ipmethod(*this);}
+
+    /** \brief  Create a new NLP Solver */
+    static NlpSolverInternal* creator(const Function& nlp)
+    { return new Ipmethod(nlp);}
+
+    /// Deep copy data members
+    virtual void deepCopyMembers(std::map<SharedObjectNode*, SharedObject>& already_copied);
+
+    virtual void init();
+    virtual void evaluate();
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+
+    /// Inputs of the KKT function
+    enum KktInput { KKT_X, KKT_P, KKT_LAM_G, KKT_SIGMA_X, KKT_D_G, KKT_NUM_IN};
+
+    /// Outputs of the KKT function
+    enum KktOutput { KKT_K, KKT_JAC, KKT_GRAD_LAG, KKT_F, KKT_G, KKT_NUM_OUT};
+
+    /// Classification of the constraint rows
+    enum RowType { ROW_EQ, ROW_INEQ, ROW_FREE};
+
+    /// Evaluate the KKT function in the current iterate
+    void eval_kkt();
+
+    /// Evaluate objective and constraints in a trial point
+    void eval_fg(const std::vector<double>& x, double& f, std::vector<double>& g);
+
+    /// Set the multipliers of the simple bounds output
+    void setLamX();
+
+    /// Move a point strictly inside its bounds
+    void pushIntoInterior(std::vector<double>& v, const std::vector<double>& lb,
+                          const std::vector<double>& ub) const;
+
+    /// Largest deviation of the complementarity products from mu
+    double complementarity(double mu) const;
+
+    /// Barrier merit function with l1 penalty nu, given f and g in (x, s)
+    double merit(const std::vector<double>& x, const std::vector<double>& s,
+                 double f, const std::vector<double>& g, double mu, double nu) const;
+
+    /// Project a bound multiplier onto [mu/(kappa*gap), kappa*mu/gap]
+    static double safeguard(double z, double gap, double mu, double kappa);
+
+    /// Largest step in (0, 1] such that v + alpha*dv stays a fraction tau away from the bound
+    static double maxStep(const std::vector<double>& v, const std::vector<double>& dv,
+                          const std::vector<double>& lb, const std::vector<double>& ub,
+                          double tau);
+
+    /// Largest step in (0, 1] such that v + alpha*dv stays a fraction tau away from zero
+    static double maxStep(const std::vector<double>& v, const std::vector<double>& dv,
+                          double tau);
+
+    /// Print iteration header
+    void printIteration(std::ostream &stream);
+
+    /// Print iteration
+    void printIteration(std::ostream &stream, int iter, double obj, double pr_inf, double du_inf,
+                        double mu, double d_norm, double reg, double alpha_pr, int ls_trials);
+
+    /// KKT matrix, constraint Jacobian, Lagrangian gradient, objective and constraints
+    Function kkt_fcn_;
+
+    /// Linear solver for the KKT system
+    LinearSolver linsol_;
+
+    /// Positions of the diagonal entries of the KKT matrix
+    std::vector<int> kkt_diag_;
+
+    /// Type of each constraint row
+    std::vector<RowType> row_type_;
+
+    /// Relaxed bounds on x and on the slacks
+    std::vector<double> lbx_, ubx_, lbs_, ubs_;
+
+    /// Primal iterates and trial point
+    std::vector<double> x_, s_, x_trial_, s_trial_;
+
+    /// Multipliers: constraints, lower and upper bounds on x and on the slacks
+    std::vector<double> lam_g_, zl_, zu_, vl_, vu_;
+
+    /// Function values in the current iterate
+    double f_;
+    std::vector<double> g_, g_trial_, grad_lag_;
+
+    /// Barrier Hessian terms
+    std::vector<double> sigma_x_, d_g_;
+
+    /// Reduced right-hand side and step
+    std::vector<double> rhs_, dx_, ds_, dlam_, dzl_, dzu_, dvl_, dvu_, jdx_;
+
+    /// Barrier residuals
+    std::vector<double> r_x_, r_s_;
+
+    /// KKT matrix nonzeros without regularization
+    std::vector<double> kkt_;
+
+    /// Solver options
+    int max_iter_, max_iter_ls_;
+    double tol_, mu_init_, bound_push_, bound_relax_factor_;
+    bool print_header_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_IPMETHOD_HPP
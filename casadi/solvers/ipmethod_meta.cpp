@@ -0,0 +1,122 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "ipmethod.hpp"
+      #include <string>
+
+      const std::string casadi::Ipmethod::meta_doc=
+      "\n"
+"A primal-dual interior point method.\n"
+"\n"
+"Inequality constraints are reformulated with slack variables and all bounds\n"
+"are handled with a logarithmic barrier. The slacks and the bound\n"
+"multipliers are eliminated from the Newton system, leaving a symmetric KKT\n"
+"matrix in (x, lam_g) whose sparsity is determined once at initialization. A\n"
+"single function, generated from the Hessian of the Lagrangian and the\n"
+"constraint Jacobian, evaluates the KKT matrix and the residuals in each\n"
+"iteration; it is factorized with a LinearSolver plugin.\n"
+"\n"
+"The step is globalized with a backtracking line search on an l1 merit\n"
+"function. Since the linear solvers do not report the inertia, the Hessian\n"
+"block is regularized until the step has sufficient curvature.\n"
+"\n"
+"\n"
+">List of available options\n"
+"\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"|        Id       |      Type     | Default  |   Description   |\n"
+"+=================+===============+==========+=================+\n"
+"| bound_push      | OT_REAL       | 0.010    | Minimal         |\n"
+"|                 |               |          | relative        |\n"
+"|                 |               |          | distance of the |\n"
+"|                 |               |          | initial point   |\n"
+"|                 |               |          | to the bounds   |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| bound_relax_fac | OT_REAL       | 0.000    | Relative        |\n"
+"| tor             |               |          | relaxation of   |\n"
+"|                 |               |          | the bounds,     |\n"
+"|                 |               |          | which gives     |\n"
+"|                 |               |          | fixed variables |\n"
+"|                 |               |          | and tight       |\n"
+"|                 |               |          | inequalities a  |\n"
+"|                 |               |          | nonempty        |\n"
+"|                 |               |          | interior        |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| linear_solver   | OT_STRING     | \"csparse | The linear      |\n"
+"|                 |               | \"        | solver to be    |\n"
+"|                 |               |          | used for the    |\n"
+"|                 |               |          | KKT system      |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| linear_solver_o | OT_DICTIONARY | GenericT | Options to be   |\n"
+"| ptions          |               | ype()    | passed to the   |\n"
+"|                 |               |          | linear solver   |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| max_iter        | OT_INTEGER    | 100      | Maximum number  |\n"
+"|                 |               |          | of interior     |\n"
+"|                 |               |          | point           |\n"
+"|                 |               |          | iterations      |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| max_iter_ls     | OT_INTEGER    | 20       | Maximum number  |\n"
+"|                 |               |          | of linesearch   |\n"
+"|                 |               |          | iterations      |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| mu_init         | OT_REAL       | 0.100    | Initial barrier |\n"
+"|                 |               |          | parameter       |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| print_header    | OT_BOOLEAN    | true     | Print the       |\n"
+"|                 |               |          | header with     |\n"
+"|                 |               |          | problem         |\n"
+"|                 |               |          | statistics      |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"| tol             | OT_REAL       | 0.000    | Tolerance on    |\n"
+"|                 |               |          | the scaled      |\n"
+"|                 |               |          | primal          |\n"
+"|                 |               |          | infeasibility,  |\n"
+"|                 |               |          | dual            |\n"
+"|                 |               |          | infeasibility   |\n"
+"|                 |               |          | and             |\n"
+"|                 |               |          | complementarity |\n"
+"+-----------------+---------------+----------+-----------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|       Id      |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| iteration     |\n"
+"+---------------+\n"
+"| iterations    |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
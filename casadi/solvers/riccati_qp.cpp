@@ -0,0 +1,771 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "riccati_qp.hpp"
+
+#include <cmath>
+#include <limits>
+#include <iomanip>
+
+using namespace std;
+namespace casadi {
+
+  extern "C"
+  int CASADI_QPSOLVER_RICCATI_EXPORT
+  casadi_register_qpsolver_riccati(QpSolverInternal::Plugin* plugin) {
+    plugin->creator = RiccatiQp::creator;
+    plugin->name = "riccati";
+    plugin->doc = RiccatiQp::meta_doc.c_str();
+    plugin->version = 22;
+    return 0;
+  }
+
+  extern "C"
+  void CASADI_QPSOLVER_RICCATI_EXPORT casadi_load_qpsolver_riccati() {
+    QpSolverInternal::registerPlugin(casadi_register_qpsolver_riccati);
+  }
+
+  RiccatiQp::RiccatiQp(const std::vector<Sparsity> &st) : QpSolverInternal(st) {
+    addOption("nx",       OT_INTEGERVECTOR, GenericType(),
+              "Number of states of each stage, length N+1 [required]");
+    addOption("nu",       OT_INTEGERVECTOR, GenericType(),
+              "Number of controls of each stage, length N [required]");
+    addOption("max_iter", OT_INTEGER,       100,
+              "Maximum number of interior point iterations");
+    addOption("tol",      OT_REAL,          1e-8,
+              "Tolerance on the residuals and the complementarity measure");
+  }
+
+  RiccatiQp::~RiccatiQp() {
+  }
+
+  void RiccatiQp::init() {
+    // Initialize the base classes
+    QpSolverInternal::init();
+
+    // Read options
+    casadi_assert_message(hasSetOption("nx") && hasSetOption("nu"),
+                          "RiccatiQp: the options \"nx\" and \"nu\" must be set");
+    nx_ = getOption("nx");
+    nu_ = getOption("nu");
+    max_iter_ = getOption("max_iter");
+    tol_ = getOption("tol");
+    N_ = nu_.size();
+    casadi_assert_message(nx_.size()==N_+1,
+                          "RiccatiQp: \"nx\" must have one entry more than \"nu\", got "
+                          << nx_.size() << " and " << nu_.size());
+
+    // Stage-wise ordering of the variables
+    offset_.resize(N_+2);
+    offset_[0] = 0;
+    for (int k=0; k<=N_; ++k) {
+      casadi_assert_message(nx_[k]>=0 && (k==N_ || nu_[k]>=0), "RiccatiQp: negative dimension");
+      offset_[k+1] = offset_[k] + nx_[k] + (k<N_ ? nu_[k] : 0);
+    }
+    casadi_assert_message(offset_[N_+1]==n_,
+                          "RiccatiQp: stage dimensions add up to " << offset_[N_+1]
+                          << ", but the QP has " << n_ << " variables");
+    var_stage_.resize(n_);
+    for (int k=0; k<=N_; ++k) {
+      for (int j=offset_[k]; j<offset_[k+1]; ++j) var_stage_[j] = k;
+    }
+
+    // Map the lower triangle of H to the stage blocks
+    const Sparsity& spH = st_[QP_STRUCT_H];
+    const vector<int>& H_colind = spH.colind();
+    const vector<int>& H_row = spH.row();
+    h_nz_.clear();
+    h_stage_.clear();
+    h_row_.clear();
+    h_col_.clear();
+    for (int c=0; c<n_; ++c) {
+      for (int el=H_colind[c]; el<H_colind[c+1]; ++el) {
+        int r = H_row[el];
+        if (r<c) continue;
+        int k = var_stage_[c];
+        casadi_assert_message(var_stage_[r]==k,
+                              "RiccatiQp: H couples variables " << r << " and " << c
+                              << " of different stages");
+        h_nz_.push_back(el);
+        h_stage_.push_back(k);
+        h_row_.push_back(r-offset_[k]);
+        h_col_.push_back(c-offset_[k]);
+      }
+    }
+
+    // Nonzeros of A by row
+    const Sparsity& spA = st_[QP_STRUCT_A];
+    const vector<int>& A_colind = spA.colind();
+    const vector<int>& A_row = spA.row();
+    a_row_.clear();
+    a_row_.resize(nc_);
+    for (int c=0; c<n_; ++c) {
+      for (int el=A_colind[c]; el<A_colind[c+1]; ++el) {
+        a_row_[A_row[el]].push_back(make_pair(c, el));
+      }
+    }
+
+    // Classify the constraints
+    dyn_rows_.clear();
+    dyn_rows_.resize(N_);
+    path_rows_.clear();
+    path_rows_.resize(N_+1);
+    for (int r=0; r<nc_; ++r) {
+      if (a_row_[r].empty()) continue;
+      int kmin = N_, kmax = 0;
+      for (vector<pair<int, int> >::const_iterator it=a_row_[r].begin();
+           it!=a_row_[r].end(); ++it) {
+        kmin = std::min(kmin, var_stage_[it->first]);
+        kmax = std::max(kmax, var_stage_[it->first]);
+      }
+      if (kmin==kmax) {
+        path_rows_[kmin].push_back(r);
+        continue;
+      }
+      bool is_dynamics = kmax==kmin+1;
+      for (vector<pair<int, int> >::const_iterator it=a_row_[r].begin();
+           is_dynamics && it!=a_row_[r].end(); ++it) {
+        if (var_stage_[it->first]==kmax && it->first-offset_[kmax]>=nx_[kmax]) {
+          is_dynamics = false;
+        }
+      }
+      casadi_assert_message(is_dynamics,
+                            "RiccatiQp: constraint " << r << " is neither a dynamics constraint "
+                            "linking stage " << kmin << " to the state of stage " << kmin+1
+                            << ", nor a path constraint");
+      dyn_rows_[kmin].push_back(r);
+    }
+    for (int k=0; k<N_; ++k) {
+      casadi_assert_message(dyn_rows_[k].size()==nx_[k+1],
+                            "RiccatiQp: expected " << nx_[k+1] << " dynamics constraints "
+                            "linking stage " << k << " to stage " << k+1 << ", got "
+                            << dyn_rows_[k].size());
+    }
+
+    // Allocate work vectors
+    Ad_.resize(N_);
+    Bd_.resize(N_);
+    E_.resize(N_);
+    E_piv_.resize(N_);
+    K_.resize(N_);
+    Lr_.resize(N_);
+    Se_.resize(N_);
+    kff_.resize(N_);
+    c_.resize(N_);
+    for (int k=0; k<N_; ++k) {
+      int nx = nx_[k], nu = nu_[k], nxn = nx_[k+1];
+      Ad_[k].resize(nxn*nx);
+      Bd_[k].resize(nxn*nu);
+      E_[k].resize(nxn*nxn);
+      E_piv_[k].resize(nxn);
+      K_[k].resize(nu*nx);
+      Lr_[k].resize(nu*nu);
+      Se_[k].resize(nu*nx);
+      kff_[k].resize(nu);
+      c_[k].resize(nxn);
+    }
+    H0_.resize(N_+1);
+    Hk_.resize(N_+1);
+    P_.resize(N_+1);
+    p_.resize(N_+1);
+    for (int k=0; k<=N_; ++k) {
+      int nz = offset_[k+1]-offset_[k];
+      H0_[k].resize(nz*nz);
+      Hk_[k].resize(nz*nz);
+      P_[k].resize(nx_[k]*nx_[k]);
+      p_[k].resize(nx_[k]);
+    }
+    z_.resize(n_);
+    dz_.resize(n_);
+    grad_.resize(n_);
+    y_.resize(nc_);
+    y_new_.resize(nc_);
+    r_e_.resize(nc_);
+  }
+
+  void RiccatiQp::evaluate() {
+    if (inputs_check_) checkInputs();
+
+    const vector<double>& h = input(QP_SOLVER_H).data();
+    const vector<double>& g = input(QP_SOLVER_G).data();
+    const vector<double>& a = input(QP_SOLVER_A).data();
+    const vector<double>& lba = input(QP_SOLVER_LBA).data();
+    const vector<double>& uba = input(QP_SOLVER_UBA).data();
+    const vector<double>& lbx = input(QP_SOLVER_LBX).data();
+    const vector<double>& ubx = input(QP_SOLVER_UBX).data();
+    const vector<double>& x0 = input(QP_SOLVER_X0).data();
+
+    // The initial state is either fixed or free
+    int nfix = 0;
+    for (int j=0; j<nx_[0]; ++j) if (lbx[j]==ubx[j]) nfix++;
+    casadi_assert_message(nfix==0 || nfix==nx_[0],
+                          "RiccatiQp: the initial state must be either completely fixed or free");
+    x0_fixed_ = nx_[0]>0 && nfix==nx_[0];
+
+    // Equality constraints are limited to the dynamics
+    for (int j=x0_fixed_ ? nx_[0] : 0; j<n_; ++j) {
+      casadi_assert_message(lbx[j]!=ubx[j],
+                            "RiccatiQp: equal bounds are only supported on the initial state, "
+                            "not on variable " << j);
+    }
+    for (int k=0; k<N_; ++k) {
+      for (vector<int>::const_iterator r=dyn_rows_[k].begin(); r!=dyn_rows_[k].end(); ++r) {
+        casadi_assert_message(lba[*r]==uba[*r],
+                              "RiccatiQp: dynamics constraint " << *r << " must be an equality");
+      }
+    }
+    for (int k=0; k<=N_; ++k) {
+      for (vector<int>::const_iterator r=path_rows_[k].begin(); r!=path_rows_[k].end(); ++r) {
+        casadi_assert_message(lba[*r]!=uba[*r],
+                              "RiccatiQp: equality path constraints are not supported, "
+                              "constraint " << *r);
+      }
+    }
+
+    // Collect the one-sided inequalities
+    ineq_stage_.clear();
+    ineq_row_.clear();
+    ineq_var_.clear();
+    ineq_sign_.clear();
+    ineq_bound_.clear();
+    for (int k=0; k<=N_; ++k) {
+      for (int j=offset_[k]; j<offset_[k+1]; ++j) {
+        if (k==0 && x0_fixed_ && j<nx_[0]) continue;
+        for (int side=0; side<2; ++side) {
+          double bnd = side==0 ? lbx[j] : ubx[j];
+          if (isinf(bnd)) continue;
+          ineq_stage_.push_back(k);
+          ineq_row_.push_back(-1);
+          ineq_var_.push_back(j);
+          ineq_sign_.push_back(side==0 ? 1 : -1);
+          ineq_bound_.push_back(bnd);
+        }
+      }
+      for (vector<int>::const_iterator r=path_rows_[k].begin(); r!=path_rows_[k].end(); ++r) {
+        for (int side=0; side<2; ++side) {
+          double bnd = side==0 ? lba[*r] : uba[*r];
+          if (isinf(bnd)) continue;
+          ineq_stage_.push_back(k);
+          ineq_row_.push_back(*r);
+          ineq_var_.push_back(-1);
+          ineq_sign_.push_back(side==0 ? 1 : -1);
+          ineq_bound_.push_back(bnd);
+        }
+      }
+    }
+    int m = ineq_sign_.size();
+    s_.resize(m);
+    lam_.resize(m);
+    ds_.resize(m);
+    dlam_.resize(m);
+    r_p_.resize(m);
+    fval_.resize(m);
+    vector<double> r_c(m);
+
+    // Dynamics: E_k*x_{k+1} + A_k*x_k + B_k*u_k = b_k
+    for (int k=0; k<N_; ++k) {
+      int nx = nx_[k], nxn = nx_[k+1];
+      vector<double>& E = E_[k];
+      vector<double>& Ad = Ad_[k];
+      vector<double>& Bd = Bd_[k];
+      fill(E.begin(), E.end(), 0);
+      fill(Ad.begin(), Ad.end(), 0);
+      fill(Bd.begin(), Bd.end(), 0);
+      for (int i=0; i<nxn; ++i) {
+        const vector<pair<int, int> >& row = a_row_[dyn_rows_[k][i]];
+        for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+          int loc = it->first - offset_[var_stage_[it->first]];
+          if (var_stage_[it->first]==k+1) {
+            E[i+loc*nxn] = a[it->second];
+          } else if (loc<nx) {
+            Ad[i+loc*nxn] = -a[it->second];
+          } else {
+            Bd[i+(loc-nx)*nxn] = -a[it->second];
+          }
+        }
+      }
+      bool nonsingular = lu(nxn, getPtr(E), getPtr(E_piv_[k]));
+      casadi_assert_message(nonsingular,
+                            "RiccatiQp: the dynamics of stage " << k
+                            << " cannot be solved for the next state");
+      for (int j=0; j<nx; ++j) luSolve(nxn, getPtr(E), getPtr(E_piv_[k]), &Ad[j*nxn], false);
+      for (int j=0; j<nu_[k]; ++j) luSolve(nxn, getPtr(E), getPtr(E_piv_[k]), &Bd[j*nxn], false);
+    }
+
+    // Stage Hessians, symmetrized from the lower triangle
+    for (int k=0; k<=N_; ++k) fill(H0_[k].begin(), H0_[k].end(), 0);
+    for (int i=0; i<h_nz_.size(); ++i) {
+      int nz = offset_[h_stage_[i]+1]-offset_[h_stage_[i]];
+      vector<double>& H = H0_[h_stage_[i]];
+      H[h_row_[i]+h_col_[i]*nz] = h[h_nz_[i]];
+      H[h_col_[i]+h_row_[i]*nz] = h[h_nz_[i]];
+    }
+
+    // Initial guess
+    copy(x0.begin(), x0.end(), z_.begin());
+    if (x0_fixed_) copy(lbx.begin(), lbx.begin()+nx_[0], z_.begin());
+    fill(y_.begin(), y_.end(), 0);
+    for (int i=0; i<m; ++i) {
+      double v;
+      if (ineq_row_[i]<0) {
+        v = z_[ineq_var_[i]];
+      } else {
+        v = 0;
+        const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+        for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+          v += a[it->second]*z_[it->first];
+        }
+      }
+      s_[i] = std::max(ineq_sign_[i]*(v-ineq_bound_[i]), 1.);
+      lam_[i] = 1;
+    }
+
+    // Mehrotra predictor-corrector iterations
+    int iter;
+    bool converged = false;
+    for (iter=0; ; ++iter) {
+      // Inequality values and primal residual
+      for (int i=0; i<m; ++i) {
+        double v;
+        if (ineq_row_[i]<0) {
+          v = z_[ineq_var_[i]];
+        } else {
+          v = 0;
+          const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+          for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+            v += a[it->second]*z_[it->first];
+          }
+        }
+        fval_[i] = ineq_sign_[i]*(v-ineq_bound_[i]);
+        r_p_[i] = s_[i]-fval_[i];
+      }
+
+      // Dynamics residual
+      for (int k=0; k<N_; ++k) {
+        for (vector<int>::const_iterator r=dyn_rows_[k].begin(); r!=dyn_rows_[k].end(); ++r) {
+          double v = -lba[*r];
+          for (vector<pair<int, int> >::const_iterator it=a_row_[*r].begin();
+               it!=a_row_[*r].end(); ++it) {
+            v += a[it->second]*z_[it->first];
+          }
+          r_e_[*r] = v;
+        }
+      }
+
+      // Gradient of the Lagrangian, without the dynamics
+      copy(g.begin(), g.end(), grad_.begin());
+      for (int i=0; i<h_nz_.size(); ++i) {
+        int r = offset_[h_stage_[i]]+h_row_[i], c = offset_[h_stage_[i]]+h_col_[i];
+        grad_[r] += h[h_nz_[i]]*z_[c];
+        if (r!=c) grad_[c] += h[h_nz_[i]]*z_[r];
+      }
+      for (int i=0; i<m; ++i) {
+        if (ineq_row_[i]<0) {
+          grad_[ineq_var_[i]] -= ineq_sign_[i]*lam_[i];
+        } else {
+          const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+          for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+            grad_[it->first] -= ineq_sign_[i]*lam_[i]*a[it->second];
+          }
+        }
+      }
+
+      // Convergence check
+      double err = 0;
+      vector<double> r_d = grad_;
+      for (int k=0; k<N_; ++k) {
+        for (vector<int>::const_iterator r=dyn_rows_[k].begin(); r!=dyn_rows_[k].end(); ++r) {
+          for (vector<pair<int, int> >::const_iterator it=a_row_[*r].begin();
+               it!=a_row_[*r].end(); ++it) {
+            r_d[it->first] += a[it->second]*y_[*r];
+          }
+          err = std::max(err, fabs(r_e_[*r]));
+        }
+      }
+      for (int j=x0_fixed_ ? nx_[0] : 0; j<n_; ++j) err = std::max(err, fabs(r_d[j]));
+      for (int i=0; i<m; ++i) err = std::max(err, fabs(r_p_[i]));
+      double mu = 0;
+      for (int i=0; i<m; ++i) mu += s_[i]*lam_[i];
+      if (m>0) mu /= m;
+      if (verbose()) {
+        cout << "RiccatiQp: iter " << setw(3) << iter << ", residual " << setw(12) << err
+             << ", mu " << setw(12) << mu << endl;
+      }
+      if (err<tol_ && mu<tol_) {
+        converged = true;
+        break;
+      }
+      if (iter>=max_iter_) break;
+
+      // Factorize the Newton system
+      factorize();
+
+      // Affine scaling (predictor) step
+      for (int i=0; i<m; ++i) r_c[i] = s_[i]*lam_[i];
+      solveNewton(r_c);
+
+      double alpha = 1;
+      if (m>0) {
+        // Centering parameter from the predicted complementarity
+        double alpha_aff = std::min(1., std::min(maxStep(s_, ds_), maxStep(lam_, dlam_)));
+        double mu_aff = 0;
+        for (int i=0; i<m; ++i) mu_aff += (s_[i]+alpha_aff*ds_[i])*(lam_[i]+alpha_aff*dlam_[i]);
+        mu_aff /= m;
+        double sigma = std::pow(mu_aff/mu, 3.);
+
+        // Combined (corrector) step
+        for (int i=0; i<m; ++i) r_c[i] = s_[i]*lam_[i] + ds_[i]*dlam_[i] - sigma*mu;
+        solveNewton(r_c);
+
+        // Fraction to the boundary rule
+        alpha = std::min(1., 0.995*std::min(maxStep(s_, ds_), maxStep(lam_, dlam_)));
+      }
+
+      // Take the step
+      for (int j=0; j<n_; ++j) z_[j] += alpha*dz_[j];
+      for (int r=0; r<nc_; ++r) y_[r] += alpha*(y_new_[r]-y_[r]);
+      for (int i=0; i<m; ++i) {
+        s_[i] += alpha*ds_[i];
+        lam_[i] += alpha*dlam_[i];
+      }
+    }
+
+    // Primal solution and cost
+    output(QP_SOLVER_X).set(z_);
+    double cost = 0;
+    for (int j=0; j<n_; ++j) cost += g[j]*z_[j];
+    for (int i=0; i<h_nz_.size(); ++i) {
+      int r = offset_[h_stage_[i]]+h_row_[i], c = offset_[h_stage_[i]]+h_col_[i];
+      cost += (r==c ? 0.5 : 1)*h[h_nz_[i]]*z_[r]*z_[c];
+    }
+    output(QP_SOLVER_COST).set(cost);
+
+    // Multipliers of the linear constraints
+    vector<double>& lam_a = output(QP_SOLVER_LAM_A).data();
+    vector<double>& lam_x = output(QP_SOLVER_LAM_X).data();
+    fill(lam_a.begin(), lam_a.end(), 0);
+    fill(lam_x.begin(), lam_x.end(), 0);
+    for (int k=0; k<N_; ++k) {
+      for (vector<int>::const_iterator r=dyn_rows_[k].begin(); r!=dyn_rows_[k].end(); ++r) {
+        lam_a[*r] = y_[*r];
+      }
+    }
+    for (int i=0; i<m; ++i) {
+      if (ineq_row_[i]<0) {
+        lam_x[ineq_var_[i]] -= ineq_sign_[i]*lam_[i];
+      } else {
+        lam_a[ineq_row_[i]] -= ineq_sign_[i]*lam_[i];
+      }
+    }
+
+    // Multipliers of a fixed initial state from stationarity
+    if (x0_fixed_) {
+      vector<double> r_d(g.begin(), g.end());
+      for (int i=0; i<h_nz_.size(); ++i) {
+        int r = offset_[h_stage_[i]]+h_row_[i], c = offset_[h_stage_[i]]+h_col_[i];
+        r_d[r] += h[h_nz_[i]]*z_[c];
+        if (r!=c) r_d[c] += h[h_nz_[i]]*z_[r];
+      }
+      for (int r=0; r<nc_; ++r) {
+        for (vector<pair<int, int> >::const_iterator it=a_row_[r].begin();
+             it!=a_row_[r].end(); ++it) {
+          r_d[it->first] += a[it->second]*lam_a[r];
+        }
+      }
+      for (int j=0; j<nx_[0]; ++j) lam_x[j] = -r_d[j];
+    }
+
+    stats_["iter_count"] = iter;
+    stats_["return_status"] = converged ? "Solve_Succeeded" : "Maximum_Iterations_Exceeded";
+  }
+
+  void RiccatiQp::factorize() {
+    const vector<double>& a = input(QP_SOLVER_A).data();
+
+    // Stage Hessians with the barrier term
+    for (int k=0; k<=N_; ++k) Hk_[k] = H0_[k];
+    for (int i=0; i<ineq_sign_.size(); ++i) {
+      int k = ineq_stage_[i], nz = offset_[k+1]-offset_[k];
+      double w = lam_[i]/s_[i];
+      vector<double>& H = Hk_[k];
+      if (ineq_row_[i]<0) {
+        int loc = ineq_var_[i]-offset_[k];
+        H[loc+loc*nz] += w;
+      } else {
+        const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+        for (vector<pair<int, int> >::const_iterator it1=row.begin(); it1!=row.end(); ++it1) {
+          for (vector<pair<int, int> >::const_iterator it2=row.begin(); it2!=row.end(); ++it2) {
+            H[it1->first-offset_[k] + (it2->first-offset_[k])*nz] +=
+              w*a[it1->second]*a[it2->second];
+          }
+        }
+      }
+    }
+
+    // Backward Riccati recursion
+    P_[N_] = Hk_[N_];
+    for (int k=N_-1; k>=0; --k) {
+      int nx = nx_[k], nu = nu_[k], nz = nx+nu, nxn = nx_[k+1];
+      const vector<double>& H = Hk_[k];
+      const vector<double>& P = P_[k+1];
+
+      // P_{k+1}*Ad and P_{k+1}*Bd
+      vector<double> PA(nxn*nx), PB(nxn*nu);
+      mul(false, false, nxn, nx, nxn, getPtr(P), getPtr(Ad_[k]), 0, getPtr(PA));
+      mul(false, false, nxn, nu, nxn, getPtr(P), getPtr(Bd_[k]), 0, getPtr(PB));
+
+      // Re = R + Bd'*P*Bd, Se = S + Bd'*P*Ad, Qe = Q + Ad'*P*Ad
+      vector<double>& Re = Lr_[k];
+      vector<double>& Se = Se_[k];
+      vector<double>& Qe = P_[k];
+      for (int j=0; j<nu; ++j) {
+        for (int i=0; i<nu; ++i) Re[i+j*nu] = H[nx+i+(nx+j)*nz];
+      }
+      for (int j=0; j<nx; ++j) {
+        for (int i=0; i<nu; ++i) Se[i+j*nu] = H[nx+i+j*nz];
+        for (int i=0; i<nx; ++i) Qe[i+j*nx] = H[i+j*nz];
+      }
+      mul(true, false, nu, nu, nxn, getPtr(Bd_[k]), getPtr(PB), 1, getPtr(Re));
+      mul(true, false, nu, nx, nxn, getPtr(Bd_[k]), getPtr(PA), 1, getPtr(Se));
+      mul(true, false, nx, nx, nxn, getPtr(Ad_[k]), getPtr(PA), 1, getPtr(Qe));
+
+      // K = -Re^{-1}*Se
+      bool posdef = chol(nu, getPtr(Re));
+      casadi_assert_message(posdef,
+                            "RiccatiQp: reduced Hessian of stage " << k
+                            << " is not positive definite");
+      vector<double>& K = K_[k];
+      for (int j=0; j<nx; ++j) {
+        for (int i=0; i<nu; ++i) K[i+j*nu] = -Se[i+j*nu];
+        cholSolve(nu, getPtr(Re), &K[j*nu]);
+      }
+
+      // P_k = Qe + Se'*K, symmetrized
+      mul(true, false, nx, nx, nu, getPtr(Se), getPtr(K), 1, getPtr(Qe));
+      for (int j=0; j<nx; ++j) {
+        for (int i=j+1; i<nx; ++i) {
+          Qe[i+j*nx] = Qe[j+i*nx] = 0.5*(Qe[i+j*nx]+Qe[j+i*nx]);
+        }
+      }
+    }
+
+    // The cost-to-go must be positive definite in a free initial state
+    if (!x0_fixed_) {
+      P0_chol_ = P_[0];
+      bool posdef = chol(nx_[0], getPtr(P0_chol_));
+      casadi_assert_message(posdef,
+                            "RiccatiQp: cost-to-go Hessian of the initial state "
+                            "is not positive definite");
+    }
+  }
+
+  void RiccatiQp::solveNewton(const std::vector<double>& r_c) {
+    const vector<double>& a = input(QP_SOLVER_A).data();
+    int m = ineq_sign_.size();
+
+    // Condensed gradient: grad + F'*S^{-1}*(r_c - Lambda*r_p)
+    vector<double> q = grad_;
+    for (int i=0; i<m; ++i) {
+      double w = ineq_sign_[i]*(r_c[i]-lam_[i]*r_p_[i])/s_[i];
+      if (ineq_row_[i]<0) {
+        q[ineq_var_[i]] += w;
+      } else {
+        const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+        for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+          q[it->first] += w*a[it->second];
+        }
+      }
+    }
+
+    // Backward pass: cost-to-go gradient and feedforward
+    copy(q.begin()+offset_[N_], q.begin()+offset_[N_]+nx_[N_], p_[N_].begin());
+    for (int k=N_-1; k>=0; --k) {
+      int nx = nx_[k], nu = nu_[k], nxn = nx_[k+1];
+
+      // Defect c_k = -E^{-1}*r_e
+      vector<double>& c = c_[k];
+      for (int i=0; i<nxn; ++i) c[i] = -r_e_[dyn_rows_[k][i]];
+      luSolve(nxn, getPtr(E_[k]), getPtr(E_piv_[k]), getPtr(c), false);
+
+      // P_{k+1}*c_k + p_{k+1}
+      vector<double> Pcp = p_[k+1];
+      mul(false, false, nxn, 1, nxn, getPtr(P_[k+1]), getPtr(c), 1, getPtr(Pcp));
+
+      // kff = -Re^{-1}*(r + Bd'*(P*c + p))
+      vector<double>& kff = kff_[k];
+      copy(q.begin()+offset_[k]+nx, q.begin()+offset_[k]+nx+nu, kff.begin());
+      mul(true, false, nu, 1, nxn, getPtr(Bd_[k]), getPtr(Pcp), 1, getPtr(kff));
+      cholSolve(nu, getPtr(Lr_[k]), getPtr(kff));
+      for (int i=0; i<nu; ++i) kff[i] = -kff[i];
+
+      // p_k = q + Ad'*(P*c + p) + Se'*kff
+      vector<double>& p = p_[k];
+      copy(q.begin()+offset_[k], q.begin()+offset_[k]+nx, p.begin());
+      mul(true, false, nx, 1, nxn, getPtr(Ad_[k]), getPtr(Pcp), 1, getPtr(p));
+      mul(true, false, nx, 1, nu, getPtr(Se_[k]), getPtr(kff), 1, getPtr(p));
+    }
+
+    // Initial state step
+    if (x0_fixed_) {
+      fill(dz_.begin(), dz_.begin()+nx_[0], 0);
+    } else {
+      for (int i=0; i<nx_[0]; ++i) dz_[i] = -p_[0][i];
+      cholSolve(nx_[0], getPtr(P0_chol_), getPtr(dz_));
+    }
+
+    // Forward pass: controls, states and multipliers of the dynamics
+    for (int k=0; k<N_; ++k) {
+      int nx = nx_[k], nu = nu_[k], nxn = nx_[k+1];
+      double* dx = &dz_[offset_[k]];
+      double* du = dx + nx;
+      double* dxn = &dz_[offset_[k+1]];
+
+      // du = K*dx + kff
+      copy(kff_[k].begin(), kff_[k].end(), du);
+      mul(false, false, nu, 1, nx, getPtr(K_[k]), dx, 1, du);
+
+      // dx_{k+1} = Ad*dx + Bd*du + c
+      copy(c_[k].begin(), c_[k].end(), dxn);
+      mul(false, false, nxn, 1, nx, getPtr(Ad_[k]), dx, 1, dxn);
+      mul(false, false, nxn, 1, nu, getPtr(Bd_[k]), du, 1, dxn);
+
+      // y = -E^{-T}*(P_{k+1}*dx_{k+1} + p_{k+1})
+      vector<double> v = p_[k+1];
+      mul(false, false, nxn, 1, nxn, getPtr(P_[k+1]), dxn, 1, getPtr(v));
+      luSolve(nxn, getPtr(E_[k]), getPtr(E_piv_[k]), getPtr(v), true);
+      for (int i=0; i<nxn; ++i) y_new_[dyn_rows_[k][i]] = -v[i];
+    }
+
+    // Slack and multiplier steps
+    for (int i=0; i<m; ++i) {
+      double v;
+      if (ineq_row_[i]<0) {
+        v = dz_[ineq_var_[i]];
+      } else {
+        v = 0;
+        const vector<pair<int, int> >& row = a_row_[ineq_row_[i]];
+        for (vector<pair<int, int> >::const_iterator it=row.begin(); it!=row.end(); ++it) {
+          v += a[it->second]*dz_[it->first];
+        }
+      }
+      ds_[i] = ineq_sign_[i]*v - r_p_[i];
+      dlam_[i] = -(r_c[i] + lam_[i]*ds_[i])/s_[i];
+    }
+  }
+
+  double RiccatiQp::maxStep(const std::vector<double>& v, const std::vector<double>& dv) {
+    double alpha = numeric_limits<double>::infinity();
+    for (int i=0; i<v.size(); ++i) {
+      if (dv[i]<0) alpha = std::min(alpha, -v[i]/dv[i]);
+    }
+    return alpha;
+  }
+
+  void RiccatiQp::mul(bool tA, bool tB, int m, int n, int k,
+                      const double* A, const double* B, double beta, double* C) {
+    for (int j=0; j<n; ++j) {
+      for (int i=0; i<m; ++i) {
+        double v = beta==0 ? 0 : beta*C[i+j*m];
+        for (int l=0; l<k; ++l) {
+          v += (tA ? A[l+i*k] : A[i+l*m]) * (tB ? B[j+l*n] : B[l+j*k]);
+        }
+        C[i+j*m] = v;
+      }
+    }
+  }
+
+  bool RiccatiQp::chol(int n, double* A) {
+    for (int j=0; j<n; ++j) {
+      double d = A[j+j*n];
+      for (int l=0; l<j; ++l) d -= A[j+l*n]*A[j+l*n];
+      if (!(d>0)) return false;
+      d = sqrt(d);
+      A[j+j*n] = d;
+      for (int i=j+1; i<n; ++i) {
+        double v = A[i+j*n];
+        for (int l=0; l<j; ++l) v -= A[i+l*n]*A[j+l*n];
+        A[i+j*n] = v/d;
+      }
+    }
+    return true;
+  }
+
+  void RiccatiQp::cholSolve(int n, const double* L, double* x) {
+    // Forward substitution with L
+    for (int i=0; i<n; ++i) {
+      for (int l=0; l<i; ++l) x[i] -= L[i+l*n]*x[l];
+      x[i] /= L[i+i*n];
+    }
+    // Backward substitution with L'
+    for (int i=n-1; i>=0; --i) {
+      for (int l=i+1; l<n; ++l) x[i] -= L[l+i*n]*x[l];
+      x[i] /= L[i+i*n];
+    }
+  }
+
+  bool RiccatiQp::lu(int n, double* A, int* piv) {
+    for (int j=0; j<n; ++j) {
+      // Pivot on the largest entry of the column
+      int p = j;
+      for (int i=j+1; i<n; ++i) if (fabs(A[i+j*n])>fabs(A[p+j*n])) p = i;
+      piv[j] = p;
+      if (A[p+j*n]==0) return false;
+      if (p!=j) {
+        for (int l=0; l<n; ++l) std::swap(A[j+l*n], A[p+l*n]);
+      }
+      // Eliminate below the diagonal
+      for (int i=j+1; i<n; ++i) {
+        A[i+j*n] /= A[j+j*n];
+        for (int l=j+1; l<n; ++l) A[i+l*n] -= A[i+j*n]*A[j+l*n];
+      }
+    }
+    return true;
+  }
+
+  void RiccatiQp::luSolve(int n, const double* LU, const int* piv, double* x, bool transpose) {
+    if (!transpose) {
+      // P*A = L*U: apply the row interchanges, then L and U
+      for (int j=0; j<n; ++j) std::swap(x[j], x[piv[j]]);
+      for (int i=0; i<n; ++i) {
+        for (int l=0; l<i; ++l) x[i] -= LU[i+l*n]*x[l];
+      }
+      for (int i=n-1; i>=0; --i) {
+        for (int l=i+1; l<n; ++l) x[i] -= LU[i+l*n]*x[l];
+        x[i] /= LU[i+i*n];
+      }
+    } else {
+      // A' = U'*L'*P: solve with U' and L', then undo the interchanges
+      for (int i=0; i<n; ++i) {
+        for (int l=0; l<i; ++l) x[i] -= LU[l+i*n]*x[l];
+        x[i] /= LU[i+i*n];
+      }
+      for (int i=n-1; i>=0; --i) {
+        for (int l=i+1; l<n; ++l) x[i] -= LU[l+i*n]*x[l];
+      }
+      for (int j=n-1; j>=0; --j) std::swap(x[j], x[piv[j]]);
+    }
+  }
+
+} // namespace casadi
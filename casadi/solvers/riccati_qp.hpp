@@ -0,0 +1,172 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_RICCATI_QP_HPP
+#define CASADI_RICCATI_QP_HPP
+
+#include "casadi/core/function/qp_solver_internal.hpp"
+
+#include <casadi/solvers/casadi_qpsolver_riccati_export.h>
+
+
+/** \defgroup plugin_QpSolver_riccati
+   Structure-exploiting interior point solver for QPs arising from optimal control.
+
+   The decision variables must be ordered stage-wise, [x0, u0, x1, u1, ..., xN],
+   with the stage dimensions given by the options nx and nu. From the sparsity of A,
+   constraints coupling (x_k, u_k) and x_{k+1} are identified as dynamics, constraints
+   on a single stage as path constraints. H may not couple different stages.
+   The initial state may be fixed by setting equal bounds on x0.
+
+   Each interior point iteration factorizes the Newton system with a Riccati recursion,
+   so the cost grows linearly with the horizon length.
+*/
+
+/** \pluginsection{QpSolver,riccati} */
+
+/// \cond INTERNAL
+namespace casadi {
+
+  /** \brief \pluginbrief{QpSolver,riccati}
+
+   @copydoc QpSolver_doc
+   @copydoc plugin_QpSolver_riccati
+
+   \date 2015
+  */
+  class CASADI_QPSOLVER_RICCATI_EXPORT RiccatiQp : public QpSolverInternal {
+  public:
+    /** \brief  Create a new Solver */
+    explicit RiccatiQp(const std::vector<Sparsity> &st);
+
+    /** \brief  Clone */
+    virtual RiccatiQp* clone() const { return new RiccatiQp(*this);}
+
+    /** \brief  Create a new QP Solver */
+    static QpSolverInternal* creator(const QPStructure& st)
+    { return new RiccatiQp(st);}
+
+    /** \brief  Destructor */
+    virtual ~RiccatiQp();
+
+    /** \brief  Initialize */
+    virtual void init();
+
+    /** \brief  Solve the QP */
+    virtual void evaluate();
+
+    /// A documentation string
+    static const std::string meta_doc;
+
+  protected:
+
+    /// Factorize the Newton system: dynamics, stage Hessians and Riccati recursion
+    void factorize();
+
+    /// Solve the Newton system for a given complementarity residual
+    void solveNewton(const std::vector<double>& r_c);
+
+    /// Largest step in (0, 1] keeping v + alpha*dv positive
+    static double maxStep(const std::vector<double>& v, const std::vector<double>& dv);
+
+    ///@{
+    /** \brief Dense linear algebra on column-major blocks */
+    // C = beta*C + op(A)*op(B), op(A) is m-by-k and op(B) is k-by-n
+    static void mul(bool tA, bool tB, int m, int n, int k,
+                    const double* A, const double* B, double beta, double* C);
+    // In-place Cholesky factorization, lower triangle
+    static bool chol(int n, double* A);
+    // Solve with a Cholesky factorization
+    static void cholSolve(int n, const double* L, double* x);
+    // In-place LU factorization with partial pivoting
+    static bool lu(int n, double* A, int* piv);
+    // Solve with an LU factorization
+    static void luSolve(int n, const double* LU, const int* piv, double* x, bool transpose);
+    ///@}
+
+    /// Stage dimensions
+    std::vector<int> nx_, nu_;
+
+    /// Number of stages (excluding the terminal)
+    int N_;
+
+    /// Offset of x_k in the decision vector, the controls follow directly
+    std::vector<int> offset_;
+
+    /// Stage of each variable
+    std::vector<int> var_stage_;
+
+    /// Entries of the lower triangle of H: nonzero index, stage, local row, local column
+    std::vector<int> h_nz_, h_stage_, h_row_, h_col_;
+
+    /// Nonzeros of A by row: column and nonzero index
+    std::vector<std::vector<std::pair<int, int> > > a_row_;
+
+    /// Dynamics constraints linking stage k to k+1
+    std::vector<std::vector<int> > dyn_rows_;
+
+    /// Path constraints of each stage
+    std::vector<std::vector<int> > path_rows_;
+
+    /// One-sided inequalities: stage, constraint row (-1 for a bound), variable, sign, bound
+    std::vector<int> ineq_stage_, ineq_row_, ineq_var_;
+    std::vector<double> ineq_sign_, ineq_bound_;
+
+    /// Is the initial state fixed by its bounds
+    bool x0_fixed_;
+
+    /// Dynamics x_{k+1} = Ad*x_k + Bd*u_k + c_k, and LU factors of the x_{k+1} block
+    std::vector<std::vector<double> > Ad_, Bd_, E_;
+    std::vector<std::vector<int> > E_piv_;
+
+    /// Stage Hessians, without and with the barrier term
+    std::vector<std::vector<double> > H0_, Hk_;
+
+    /// Riccati recursion: cost-to-go Hessian, feedback, Cholesky factor of R, and cross term
+    std::vector<std::vector<double> > P_, K_, Lr_, Se_;
+
+    /// Riccati recursion: cost-to-go gradient, feedforward and dynamics defect
+    std::vector<std::vector<double> > p_, kff_, c_;
+
+    /// Cholesky factor of the cost-to-go Hessian at the free initial state
+    std::vector<double> P0_chol_;
+
+    /// Iterates
+    std::vector<double> z_, y_, s_, lam_;
+
+    /// Newton step
+    std::vector<double> dz_, y_new_, ds_, dlam_;
+
+    /// Residuals, and the Lagrangian gradient without the dynamics terms
+    std::vector<double> r_p_, r_e_, fval_, grad_;
+
+    /// Solver options
+    int max_iter_;
+    double tol_;
+  };
+
+} // namespace casadi
+/// \endcond
+#endif // CASADI_RICCATI_QP_HPP
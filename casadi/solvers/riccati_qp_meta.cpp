@@ -0,0 +1,77 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+
+      #include "riccati_qp.hpp"
+      #include <string>
+
+      const std::string casadi::RiccatiQp::meta_doc=
+      "\n"
+"Structure-exploiting interior point solver for QPs arising from optimal\n"
+"control.\n"
+"\n"
+"The decision variables must be ordered stage-wise, [x0, u0, x1, u1, ...,\n"
+"xN], with the stage dimensions given by the options nx and nu. From the\n"
+"sparsity of A, constraints coupling (x_k, u_k) and x_{k+1} are identified\n"
+"as dynamics, constraints on a single stage as path constraints. H may not\n"
+"couple different stages. The initial state may be fixed by setting equal\n"
+"bounds on x0.\n"
+"\n"
+"Each interior point iteration factorizes the Newton system with a Riccati\n"
+"recursion, so the cost grows linearly with the horizon length.\n"
+"\n"
+">List of available options\n"
+"\n"
+"+----------+-----------+---------+----------------------------------+\n"
+"|    Id    |   Type    | Default |           Description            |\n"
+"+==========+===========+=========+==================================+\n"
+"| max_iter | OT_INTEGE | 100     | Maximum number of interior point |\n"
+"|          | R         |         | iterations                       |\n"
+"+----------+-----------+---------+----------------------------------+\n"
+"| nu       | OT_INTEGE | GenericT| Number of controls of each       |\n"
+"|          | RVECTOR   | ype()   | stage, length N [required]       |\n"
+"+----------+-----------+---------+----------------------------------+\n"
+"| nx       | OT_INTEGE | GenericT| Number of states of each stage,  |\n"
+"|          | RVECTOR   | ype()   | length N+1 [required]            |\n"
+"+----------+-----------+---------+----------------------------------+\n"
+"| tol      | OT_REAL   | 1e-8    | Tolerance on the residuals and   |\n"
+"|          |           |         | the complementarity measure      |\n"
+"+----------+-----------+---------+----------------------------------+\n"
+"\n"
+"\n"
+">List of available stats\n"
+"\n"
+"+---------------+\n"
+"|      Id       |\n"
+"+===============+\n"
+"| iter_count    |\n"
+"+---------------+\n"
+"| return_status |\n"
+"+---------------+\n"
+"\n"
+"\n"
+"\n"
+"\n"
+;
@@ -89,6 +89,9 @@ namespace casadi {
               "Print the header with problem statistics");
     addOption("codegen",           OT_BOOLEAN,  false,
               "C-code generation");
+    addOption("parallelization",   OT_STRING,   "serial",
+              "Split the lifted functions by lifted variable and evaluate the parts "
+              "concurrently", "serial|openmp");
     addOption("reg_threshold",     OT_REAL,      1e-8,
               "Threshold for the regularization.");
     addOption("name_x",      OT_STRINGVECTOR,  GenericType(),
@@ -124,6 +127,7 @@ namespace casadi {
     tol_reg_ = getOption("tol_reg");
     regularize_ = getOption("regularize");
     codegen_ = getOption("codegen");
+    parallelization_ = getOption("parallelization").toString();
     reg_threshold_ = getOption("reg_threshold");
     print_time_ = getOption("print_time");
     tol_pr_step_ = getOption("tol_pr_step");
@@ -334,12 +338,17 @@ namespace casadi {
       cout << "Generated residual function ( " << res_fcn.getAlgorithmSize() << " nodes)." << endl;
     }
 
-    // Generate c code and load as DLL
-    if (codegen_) {
-      res_fcn_ = dynamicCompilation(res_fcn, "res_fcn", "residual function", compiler);
-    } else {
-      res_fcn_ = res_fcn;
+    // The residuals of the lifted variables are independent of each other
+    vector<vector<int> > res_tasks(1);
+    res_tasks[0].push_back(res_f_);
+    res_tasks[0].push_back(res_gl_);
+    res_tasks[0].push_back(res_g_);
+    res_tasks[0].push_back(res_p_d_);
+    for (vector<Var>::iterator it=v_.begin(); it!=v_.end(); ++it) {
+      res_tasks.push_back(vector<int>(1, it->res_d));
+      if (!gauss_newton_) res_tasks.back().push_back(it->res_lam_d);
     }
+    res_fcn_ = parallelize(res_fcn, res_tasks, "res_fcn", "residual function", compiler);
 
     // Declare difference vector d and substitute out p and v
     stringstream ss;
@@ -449,12 +458,11 @@ namespace casadi {
     MXFunction mat_fcn(mfcn_in, mat_out);
     mat_fcn.init();
 
-    // Generate c code and load as DLL
-    if (codegen_) {
-      mat_fcn_ = dynamicCompilation(mat_fcn, "mat_fcn", "Matrices function", compiler);
-    } else {
-      mat_fcn_ = mat_fcn;
-    }
+    // Condensed Jacobian and Hessian
+    vector<vector<int> > mat_tasks(2);
+    mat_tasks[0].push_back(mat_jac_);
+    mat_tasks[1].push_back(mat_hes_);
+    mat_fcn_ = parallelize(mat_fcn, mat_tasks, "mat_fcn", "Matrices function", compiler);
 
     // Definition of intermediate variables
     n = mfcn_out.size();
@@ -507,12 +515,11 @@ namespace casadi {
            << " nodes)." << endl;
     }
 
-    // Generate c code and load as DLL
-    if (codegen_) {
-      vec_fcn_ = dynamicCompilation(vec_fcn, "vec_fcn", "linearization function", compiler);
-    } else {
-      vec_fcn_ = vec_fcn;
-    }
+    // Condensed gradient and constraint offset
+    vector<vector<int> > vec_tasks(2);
+    vec_tasks[0].push_back(vec_gf_);
+    vec_tasks[1].push_back(vec_g_);
+    vec_fcn_ = parallelize(vec_fcn, vec_tasks, "vec_fcn", "linearization function", compiler);
 
     // Expression a + A*du in Lifted Newton (Section 2.1 in Alberspeyer2010)
     MX du = MX::sym("du", nx_);   // Step in u
@@ -566,12 +573,13 @@ namespace casadi {
            << endl;
     }
 
-    // Generate c code and load as DLL
-    if (codegen_) {
-      exp_fcn_ = dynamicCompilation(exp_fcn, "exp_fcn", "step expansion function", compiler);
-    } else {
-      exp_fcn_ = exp_fcn;
+    // Primal and dual step expansion
+    vector<vector<int> > exp_tasks(gauss_newton_ ? 1 : 2);
+    for (vector<Var>::iterator it=v_.begin(); it!=v_.end(); ++it) {
+      exp_tasks[0].push_back(it->exp_def);
+      if (!gauss_newton_) exp_tasks[1].push_back(it->exp_defL);
     }
+    exp_fcn_ = parallelize(exp_fcn, exp_tasks, "exp_fcn", "step expansion function", compiler);
 
     // Allocate QP data
     Sparsity sp_B_obj = mat_fcn_.output(mat_hes_).sparsity();
@@ -1287,4 +1295,77 @@ namespace casadi {
   }
 
 
+  Function Scpgen::parallelize(const MXFunction& f,
+                               const std::vector<std::vector<int> >& all_tasks,
+                               const std::string& fname, const std::string& fdescr,
+                               const std::string& compiler) {
+    // Drop tasks without outputs
+    vector<vector<int> > tasks;
+    for (vector<vector<int> >::const_iterator it=all_tasks.begin(); it!=all_tasks.end(); ++it) {
+      if (!it->empty()) tasks.push_back(*it);
+    }
+
+    // Evaluate the complete function in one piece
+    if (parallelization_=="serial" || tasks.size()<2) {
+      if (codegen_) {
+        return dynamicCompilation(f, fname, fdescr, compiler);
+      } else {
+        return f;
+      }
+    }
+
+    // One function per task, calculating a subset of the outputs
+    const vector<MX>& f_in = f.inputExpr();
+    vector<Function> task_fcn(tasks.size());
+    int n_out = 0;
+    for (int k=0; k<tasks.size(); ++k) {
+      vector<MX> task_out;
+      for (vector<int>::const_iterator it=tasks[k].begin(); it!=tasks[k].end(); ++it) {
+        task_out.push_back(f.outputExpr(*it));
+      }
+      n_out += task_out.size();
+      MXFunction task(f_in, task_out);
+      task.init();
+      if (codegen_) {
+        stringstream ss;
+        ss << fname << "_" << k;
+        task_fcn[k] = dynamicCompilation(task, ss.str(), fdescr, compiler);
+      } else {
+        // The tasks are built from the same graph and would share the called functions,
+        // whose input and output buffers cannot be used by several threads at once
+        task_fcn[k] = deepcopy(task);
+      }
+    }
+    casadi_assert_message(n_out==f.getNumOutputs(),
+                          "Scpgen::parallelize: The tasks must cover all outputs of " << fname);
+
+    // Evaluate the tasks concurrently
+    Parallelizer par(task_fcn);
+    par.setOption("parallelization", parallelization_);
+    par.init();
+
+    // Pass the same arguments to all tasks
+    vector<MX> par_in;
+    for (int k=0; k<tasks.size(); ++k) {
+      par_in.insert(par_in.end(), f_in.begin(), f_in.end());
+    }
+    vector<MX> par_out = par.call(par_in);
+
+    // Restore the order of the outputs
+    vector<MX> f_out(f.getNumOutputs());
+    vector<MX>::const_iterator par_it = par_out.begin();
+    for (int k=0; k<tasks.size(); ++k) {
+      for (vector<int>::const_iterator it=tasks[k].begin(); it!=tasks[k].end(); ++it) {
+        f_out.at(*it) = *par_it++;
+      }
+    }
+    MXFunction ret(f_in, f_out);
+    ret.setOption("name", fname);
+    ret.init();
+    if (verbose_) {
+      cout << "Split " << fdescr << " into " << tasks.size() << " parallel tasks." << endl;
+    }
+    return ret;
+  }
+
 } // namespace casadi
@@ -28,6 +28,7 @@
 
 #include "casadi/core/function/nlp_solver_internal.hpp"
 #include "casadi/core/function/qp_solver.hpp"
+#include "casadi/core/function/mx_function.hpp"
 
 #include <casadi/solvers/casadi_nlpsolver_scpgen_export.h>
 
@@ -99,6 +100,16 @@ namespace casadi {
     // Evaluate the step expansion
     void eval_exp();
 
+    /** \brief Prepare a lifted function for evaluation
+     *
+     * Each task is a list of outputs of f. Unless the parallelization is "serial",
+     * the tasks are turned into separate functions, evaluated concurrently by a
+     * Parallelizer and wrapped into a function with the same signature as f.
+     */
+    Function parallelize(const MXFunction& f, const std::vector<std::vector<int> >& tasks,
+                         const std::string& fname, const std::string& fdescr,
+                         const std::string& compiler);
+
     // Timings
     double t_eval_mat_, t_eval_res_, t_eval_vec_, t_eval_exp_, t_solve_qp_, t_mainloop_;
 
@@ -143,6 +154,9 @@ namespace casadi {
     /// Enable Code generation
     bool codegen_;
 
+    /// Parallelization of the lifted functions
+    std::string parallelization_;
+
     /// Access QpSolver
     const QpSolver getQpSolver() const { return qp_solver_;}
 
@@ -86,6 +86,15 @@
 "| name_x          | OT_STRINGVECTOR | GenericType()   | Names of the    |\n"
 "|                 |                 |                 | variables.      |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| parallelization | OT_STRING       | \"serial\"        | Split the       |\n"
+"|                 |                 |                 | lifted          |\n"
+"|                 |                 |                 | functions by    |\n"
+"|                 |                 |                 | lifted variable |\n"
+"|                 |                 |                 | and evaluate    |\n"
+"|                 |                 |                 | the parts       |\n"
+"|                 |                 |                 | concurrently    |\n"
+"|                 |                 |                 | (serial|openmp) |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| print_header    | OT_BOOLEAN      | true            | Print the       |\n"
 "|                 |                 |                 | header with     |\n"
 "|                 |                 |                 | problem         |\n"
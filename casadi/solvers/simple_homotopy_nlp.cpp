@@ -27,6 +27,7 @@
 #include "casadi/core/std_vector_tools.hpp"
 #include "casadi/core/matrix/matrix_tools.hpp"
 #include "casadi/core/mx/mx_tools.hpp"
+#include "casadi/core/function/nlp_solver_internal.hpp"
 #include "casadi/core/function/mx_function.hpp"
 #include "casadi/core/casadi_calculus.hpp"
 #include <ctime>
@@ -60,10 +61,31 @@ namespace casadi {
     addOption("nlp_solver_options", OT_DICTIONARY, GenericType(),
               "Options to be passed to the Homotopy solver");
 
-    //addOption("max_step",            OT_REAL,      1.,
-    //          "The maximal homotopy step that is allowed");
+    addOption("max_step",            OT_REAL,      1.,
+              "The maximal homotopy step that is allowed");
+    addOption("min_step",            OT_REAL,      1e-6,
+              "The minimal homotopy step before giving up (adaptive mode)");
     addOption("num_steps",            OT_INTEGER,      10,
-              "Take this many steps to go from tau=0 to tau=1.");
+              "Take this many steps to go from tau=0 to tau=1. "
+              "In adaptive mode, this sets the initial step.");
+    addOption("adaptive",             OT_BOOLEAN,      false,
+              "Adapt the homotopy step: grow it after fast corrector solves, "
+              "shrink it and retry after failed ones.");
+    addOption("step_increase",        OT_REAL,      2.,
+              "Factor by which the step is grown (adaptive mode)");
+    addOption("step_decrease",        OT_REAL,      0.5,
+              "Factor by which the step is shrunk (adaptive mode)");
+    addOption("corrector_iter",       OT_INTEGER,      5,
+              "Grow the step if the corrector needed at most this many iterations "
+              "(adaptive mode)");
+    addOption("predictor",            OT_STRING,      "none",
+              "Initial guess for each corrector solve: 'none' uses the previous solution, "
+              "'tangent' adds a first-order step along the solution path",
+              "none|tangent");
+    addOption("active_tol",           OT_REAL,      1e-8,
+              "Tolerance for detecting active constraints (tangent predictor)");
+    addOption("linear_solver",        OT_STRING,      "csparse",
+              "Linear solver for the KKT system (tangent predictor)");
 
   }
 
@@ -97,12 +119,65 @@ namespace casadi {
     if (hasSetOption("nlp_solver_options")) {
       nlpsolver_.setOption(getOption("nlp_solver_options"));
     }
+    if (hasSetOption("active_tol")) {
+      nlpsolver_.setOption("sensitivity_active_tol", getOption("active_tol"));
+    }
+    if (hasSetOption("linear_solver")) {
+      nlpsolver_.setOption("sensitivity_linear_solver", getOption("linear_solver"));
+    }
 
     // Initialize the NLP solver
     nlpsolver_.init();
 
     num_steps_ = getOption("num_steps");
+    adaptive_ = getOption("adaptive");
+    max_step_ = getOption("max_step");
+    min_step_ = getOption("min_step");
+    step_increase_ = getOption("step_increase");
+    step_decrease_ = getOption("step_decrease");
+    corrector_iter_ = getOption("corrector_iter");
+    tangent_predictor_ = getOption("predictor")=="tangent";
+
+    casadi_assert_message(max_step_>0 && max_step_<=1, "max_step must be in (0, 1]");
+    casadi_assert_message(min_step_>0 && min_step_<=max_step_,
+                          "min_step must be in (0, max_step]");
+    casadi_assert_message(step_decrease_>0 && step_decrease_<1,
+                          "step_decrease must be in (0, 1)");
+    casadi_assert_message(step_increase_>=1, "step_increase must be at least 1");
+
+  }
+
+  bool SimpleHomotopyNlp::solve(double tau, int& iter) {
+    nlpsolver_.input(NLP_SOLVER_P)[np_] = tau;
+    try {
+      nlpsolver_.evaluate();
+    } catch(std::exception& ex) {
+      // Without step control there is nothing to retry, the failure is fatal
+      if (!adaptive_) throw;
+      if (verbose()) {
+        cout << "NLP solver failed at tau=" << tau << ": " << ex.what() << endl;
+      }
+      return false;
+    }
 
+    // Solvers report their status differently, only trust what is there
+    const Dictionary& stats = nlpsolver_.getStats();
+    Dictionary::const_iterator it = stats.find("iter_count");
+    iter = it==stats.end() ? 0 : static_cast<int>(it->second);
+    it = stats.find("return_status");
+    if (it==stats.end() || !it->second.isString()) return true;
+    const std::string& status = it->second;
+    return status=="Solve_Succeeded" || status=="Solved_To_Acceptable_Level";
+  }
+
+  void SimpleHomotopyNlp::computeTangent(std::vector<double>& dx, std::vector<double>& dlam_x,
+                                         std::vector<double>& dlam_g) {
+    DMatrix dtau = DMatrix::sparse(np_+1, 1);
+    dtau(np_) = 1;
+    std::vector<DMatrix> sens = nlpsolver_->getSensitivity(dtau);
+    dx = sens[0].data();
+    dlam_x = sens[1].data();
+    dlam_g = sens[2].data();
   }
 
   void SimpleHomotopyNlp::evaluate() {
@@ -119,25 +194,69 @@ namespace casadi {
               input(NLP_SOLVER_P).end(),
               nlpsolver_.input(NLP_SOLVER_P).begin());
 
-    for (int i=0;i<num_steps_;++i) {
-      nlpsolver_.input(NLP_SOLVER_P)[np_] = i*1.0/(num_steps_-1);
-      nlpsolver_.evaluate();
-
-      nlpsolver_.setInput(nlpsolver_.output(NLP_SOLVER_LAM_G), NLP_SOLVER_LAM_G0);
-      nlpsolver_.setInput(nlpsolver_.output(NLP_SOLVER_LAM_X), NLP_SOLVER_LAM_X0);
-     // nlpsolver_.setInput(nlpsolver_.output(NLP_SOLVER_LAM_P), NLP_SOLVER_LAM_P0);
-
-      nlpsolver_.setInput(nlpsolver_.output(NLP_SOLVER_X), NLP_SOLVER_X0);
-
+    // Last accepted point on the solution path
+    int iter;
+    bool success = solve(0, iter);
+    casadi_assert_message(success || !adaptive_,
+                          "SimpleHomotopyNlp: NLP solver failed at tau=0");
+    double tau = 0;
+    std::vector<double> x = nlpsolver_.output(NLP_SOLVER_X).data();
+    std::vector<double> lam_x = nlpsolver_.output(NLP_SOLVER_LAM_X).data();
+    std::vector<double> lam_g = nlpsolver_.output(NLP_SOLVER_LAM_G).data();
+
+    // Tangent at the last accepted point
+    std::vector<double> dx(nx_, 0), dlam_x(nx_, 0), dlam_g(ng_, 0);
+    if (tangent_predictor_) computeTangent(dx, dlam_x, dlam_g);
+
+    const std::vector<double>& lbx = input(NLP_SOLVER_LBX).data();
+    const std::vector<double>& ubx = input(NLP_SOLVER_UBX).data();
+
+    double h = std::min(num_steps_>1 ? 1.0/(num_steps_-1) : 1.0, max_step_);
+    int n_accepted = 0, n_rejected = 0;
+    while (tau<1) {
+      double tau_next = 1-tau<=h*(1+1e-8) ? 1 : tau+h;
+      double dtau = tau_next - tau;
+
+      // Predictor
+      for (int i=0; i<nx_; ++i) {
+        nlpsolver_.input(NLP_SOLVER_X0).at(i) =
+          std::min(std::max(x[i] + dtau*dx[i], lbx[i]), ubx[i]);
+        nlpsolver_.input(NLP_SOLVER_LAM_X0).at(i) = lam_x[i] + dtau*dlam_x[i];
+      }
+      for (int i=0; i<ng_; ++i) {
+        nlpsolver_.input(NLP_SOLVER_LAM_G0).at(i) = lam_g[i] + dtau*dlam_g[i];
+      }
+
+      // Corrector
+      success = solve(tau_next, iter);
+      if (!success && adaptive_) {
+        n_rejected++;
+        h *= step_decrease_;
+        casadi_assert_message(h>=min_step_, "SimpleHomotopyNlp: homotopy step became "
+                              "smaller than min_step at tau=" << tau);
+        continue;
+      }
+
+      // Accept the step
+      n_accepted++;
+      tau = tau_next;
+      x = nlpsolver_.output(NLP_SOLVER_X).data();
+      lam_x = nlpsolver_.output(NLP_SOLVER_LAM_X).data();
+      lam_g = nlpsolver_.output(NLP_SOLVER_LAM_G).data();
+      if (tangent_predictor_ && tau<1) computeTangent(dx, dlam_x, dlam_g);
+      if (adaptive_ && iter<=corrector_iter_) h = std::min(h*step_increase_, max_step_);
     }
 
+    stats_["accepted_steps"] = n_accepted;
+    stats_["rejected_steps"] = n_rejected;
+
     setOutput(nlpsolver_.output(NLP_SOLVER_X), NLP_SOLVER_X);
     setOutput(nlpsolver_.output(NLP_SOLVER_LAM_X), NLP_SOLVER_LAM_X);
     setOutput(nlpsolver_.output(NLP_SOLVER_LAM_G), NLP_SOLVER_LAM_G);
 
 
-    std::copy(nlpsolver_.output(NLP_SOLVER_P).begin(),
-              nlpsolver_.output(NLP_SOLVER_P).begin()+np_,
+    std::copy(nlpsolver_.output(NLP_SOLVER_LAM_P).begin(),
+              nlpsolver_.output(NLP_SOLVER_LAM_P).begin()+np_,
               output(NLP_SOLVER_LAM_P).begin());
 
 
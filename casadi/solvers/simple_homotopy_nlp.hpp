@@ -59,11 +59,33 @@ namespace casadi {
     virtual void init();
     virtual void evaluate();
 
+    /// Solve the NLP at a given tau, returns true on success
+    bool solve(double tau, int& iter);
+
+    /// Tangent of the solution path w.r.t. tau, with the active set kept fixed
+    void computeTangent(std::vector<double>& dx, std::vector<double>& dlam_x,
+                        std::vector<double>& dlam_g);
+
     NlpSolver nlpsolver_;
 
     /// Take this many steps to go from tau=0 to tau=1
     int num_steps_;
 
+    /// Adaptive step length control
+    bool adaptive_;
+
+    /// Bounds on the homotopy step
+    double max_step_, min_step_;
+
+    /// Step length adaptation factors
+    double step_increase_, step_decrease_;
+
+    /// Grow the step if the corrector needed at most this many iterations
+    int corrector_iter_;
+
+    /// Use a tangent predictor
+    bool tangent_predictor_;
+
     /// A documentation string
     static const std::string meta_doc;
 
@@ -27,6 +27,7 @@
 #include "casadi/core/std_vector_tools.hpp"
 #include "casadi/core/matrix/matrix_tools.hpp"
 #include "casadi/core/function/sx_function.hpp"
+#include "casadi/core/function/code_generator.hpp"
 #include "casadi/core/sx/sx_tools.hpp"
 #include "casadi/core/casadi_calculus.hpp"
 #include <ctime>
@@ -83,6 +84,10 @@ namespace casadi {
               "Print the header with problem statistics");
     addOption("min_step_size",     OT_REAL,   1e-10,
               "The size (inf-norm) of the step size should not become smaller than this.");
+    addOption("codegen_qp_max_iter", OT_INTEGER,   50,
+              "Maximum number of iterations of the dense QP solver in generated code");
+    addOption("codegen_qp_tol",    OT_REAL,     1e-10,
+              "Tolerance of the dense QP solver in generated code");
 
     // Monitors
     addOption("monitor",      OT_STRINGVECTOR, GenericType(),  "",
@@ -111,6 +116,8 @@ namespace casadi {
     regularize_ = getOption("regularize");
     exact_hessian_ = getOption("hessian_approximation")=="exact";
     min_step_size_ = getOption("min_step_size");
+    codegen_qp_max_iter_ = getOption("codegen_qp_max_iter");
+    codegen_qp_tol_ = getOption("codegen_qp_tol");
 
     // Get/generate required functions
     gradF();
@@ -977,4 +984,287 @@ namespace casadi {
     return pr_inf;
   }
 
+
+  void Sqpmethod::generateDeclarations(std::ostream &stream, const std::string& type,
+                                       CodeGenerator& gen) const {
+    // Functions called in the iterations
+    gen.addDependency(nlp_);
+    gen.addDependency(gradF_);
+    if (ng_>0) gen.addDependency(jacG_);
+    if (exact_hessian_) {
+      gen.addDependency(hessLag_);
+      gen.addSparsity(hessLag_.output(HESSLAG_HESS).sparsity());
+      gen.addAuxiliary(CodeGenerator::AUX_COPY_SPARSE);
+    } else {
+      gen.addDependency(bfgs_);
+    }
+
+    // Sparsity of the Hessian approximation and of the constraint Jacobian
+    gen.addSparsity(Bk_.sparsity());
+    gen.addSparsity(Jk_.sparsity());
+
+    // Vector operations and the QP solver for the subproblems
+    gen.addAuxiliary(CodeGenerator::AUX_COPY);
+    gen.addAuxiliary(CodeGenerator::AUX_FILL);
+    gen.addAuxiliary(CodeGenerator::AUX_DOT);
+    gen.addAuxiliary(CodeGenerator::AUX_DENSIFY);
+    gen.addAuxiliary(CodeGenerator::AUX_NORM_INF);
+    gen.addAuxiliary(CodeGenerator::AUX_MAX_VIOL);
+    gen.addAuxiliary(CodeGenerator::AUX_QP_DENSE);
+  }
+
+  void Sqpmethod::generateGradLag(std::ostream &stream, const std::string& glag,
+                                  CodeGenerator& gen) const {
+    stream << "    for (i=0; i<" << nx_ << "; ++i) {" << endl;
+    stream << "      " << glag << "[i] = gf[i] + mu_x[i];" << endl;
+    if (ng_>0) {
+      stream << "      for (el=jcol[i]; el<jcol[i+1]; ++el) "
+             << glag << "[i] += jk[el]*mu[jrow[el]];" << endl;
+    }
+    stream << "    }" << endl;
+  }
+
+  void Sqpmethod::generateEvalH(std::ostream &stream, CodeGenerator& gen) const {
+    stream << "    f" << gen.getDependency(hessLag_) << "(x, x" << NLP_SOLVER_P
+           << ", &one, mu, hk, 0, 0, 0, 0);" << endl;
+    stream << "    casadi_copy_sparse(hk, s"
+           << gen.getSparsity(hessLag_.output(HESSLAG_HESS).sparsity())
+           << ", bk, s" << gen.getSparsity(Bk_.sparsity()) << ");" << endl;
+
+    // Regularization with the Gershgorin circle theorem
+    if (regularize_) {
+      stream << "    reg = 0;" << endl;
+      stream << "    for (i=0; i<" << nx_ << "; ++i) {" << endl;
+      stream << "      tmp = 0;" << endl;
+      stream << "      for (el=bcol[i]; el<bcol[i+1]; ++el) "
+             << "tmp += brow[el]==i ? bk[el] : -fabs(bk[el]);" << endl;
+      stream << "      if (-tmp>reg) reg = -tmp;" << endl;
+      stream << "    }" << endl;
+      stream << "    for (i=0; i<" << nx_ << "; ++i) {" << endl;
+      stream << "      for (el=bcol[i]; el<bcol[i+1]; ++el) if (brow[el]==i) bk[el] += reg;"
+             << endl;
+      stream << "    }" << endl;
+    }
+  }
+
+  void Sqpmethod::generateBody(std::ostream &stream, const std::string& type,
+                               CodeGenerator& gen) const {
+    // Names of the inputs and outputs
+    string x0 = "x" + CodeGenerator::numToString(NLP_SOLVER_X0);
+    string p = "x" + CodeGenerator::numToString(NLP_SOLVER_P);
+    string lbx = "x" + CodeGenerator::numToString(NLP_SOLVER_LBX);
+    string ubx = "x" + CodeGenerator::numToString(NLP_SOLVER_UBX);
+    string lbg = "x" + CodeGenerator::numToString(NLP_SOLVER_LBG);
+    string ubg = "x" + CodeGenerator::numToString(NLP_SOLVER_UBG);
+    string lam_x0 = "x" + CodeGenerator::numToString(NLP_SOLVER_LAM_X0);
+    string lam_g0 = "x" + CodeGenerator::numToString(NLP_SOLVER_LAM_G0);
+    string r_x = "r" + CodeGenerator::numToString(NLP_SOLVER_X);
+    string r_f = "r" + CodeGenerator::numToString(NLP_SOLVER_F);
+    string r_g = "r" + CodeGenerator::numToString(NLP_SOLVER_G);
+    string r_lam_x = "r" + CodeGenerator::numToString(NLP_SOLVER_LAM_X);
+    string r_lam_g = "r" + CodeGenerator::numToString(NLP_SOLVER_LAM_G);
+    string r_lam_p = "r" + CodeGenerator::numToString(NLP_SOLVER_LAM_P);
+
+    // Sparsity patterns
+    int s_b = gen.getSparsity(Bk_.sparsity());
+    int s_j = gen.getSparsity(Jk_.sparsity());
+
+    // Work vectors of fixed size, the generated code does not allocate memory
+    int nx1 = std::max(nx_, 1), ng1 = std::max(ng_, 1);
+    stream << "  static d x[" << nx1 << "], x_cand[" << nx1 << "], x_old[" << nx1 << "], dx["
+           << nx1 << "], gf[" << nx1 << "], glag[" << nx1 << "], mu_x["
+           << nx1 << "], qp_lam_x[" << nx1 << "], lbdx[" << nx1 << "], ubdx[" << nx1 << "];"
+           << endl;
+    stream << "  static d g[" << ng1 << "], g_cand[" << ng1 << "], mu[" << ng1 << "], qp_lam_a["
+           << ng1 << "], lbdg[" << ng1 << "], ubdg[" << ng1 << "];" << endl;
+    stream << "  static d bk[" << std::max(Bk_.size(), 1) << "], jk["
+           << std::max(Jk_.size(), 1) << "];" << endl;
+    if (exact_hessian_) {
+      stream << "  static d hk[" << std::max(hessLag_.output(HESSLAG_HESS).size(), 1) << "];"
+             << endl;
+      stream << "  static const d one = 1;" << endl;
+      if (regularize_) stream << "  d reg;" << endl;
+    } else {
+      stream << "  static d bk_new[" << std::max(Bk_.size(), 1) << "], glag_old[" << nx1 << "];"
+             << endl;
+    }
+    stream << "  static d hd[" << std::max(nx_*nx_, 1) << "], jd[" << std::max(ng_*nx_, 1)
+           << "];" << endl;
+    stream << "  static d merit_mem[" << std::max(merit_memsize_, 1) << "];" << endl;
+    stream << "  static d w_qp[" << (nx_*nx_ + 2*nx_ + 18*(nx_+ng_)) << "];" << endl;
+    stream << "  d f, f_cand, sigma, t, tmp, pr_inf, du_inf, dx_norm, l1_infeas, l1_dir, "
+           << "l1_merit, merit_max;" << endl;
+    stream << "  int i, k, el, iter, ls_iter, n_mem;" << endl;
+    stream << "  const int *bcol = s" << s_b << "+2, *brow = bcol+" << (nx_+1) << ";" << endl;
+    stream << "  const int *jcol = s" << s_j << "+2, *jrow = jcol+" << (nx_+1) << ";" << endl;
+    stream << endl;
+
+    // Evaluation of the constraint Jacobian and the objective gradient
+    stringstream eval_jac_grad;
+    if (ng_>0) {
+      eval_jac_grad << "    f" << gen.getDependency(jacG_) << "(x, " << p << ", jk, 0, g);"
+                    << endl;
+    }
+    eval_jac_grad << "    f" << gen.getDependency(gradF_) << "(x, " << p << ", gf, &f, 0);"
+                  << endl;
+
+    // Initial guess
+    stream << "  /* Initial guess */" << endl;
+    stream << "  casadi_copy(" << nx_ << ", " << x0 << ", 1, x, 1);" << endl;
+    stream << "  casadi_copy(" << ng_ << ", " << lam_g0 << ", 1, mu, 1);" << endl;
+    stream << "  casadi_copy(" << nx_ << ", " << lam_x0 << ", 1, mu_x, 1);" << endl;
+    stream << "  casadi_fill(" << nx_ << ", 0., dx, 1);" << endl;
+    stream << "  casadi_fill(" << ng_ << ", 0., g, 1);" << endl;
+    stream << "  iter = 0;" << endl;
+    stream << "  n_mem = 0;" << endl;
+    stream << "  sigma = 0;" << endl;
+    stream << "  {" << endl;
+    stream << eval_jac_grad.str();
+
+    // Initial Hessian or Hessian approximation
+    if (exact_hessian_) {
+      generateEvalH(stream, gen);
+    } else {
+      stream << "    for (i=0; i<" << nx_ << "; ++i) {" << endl;
+      stream << "      for (el=bcol[i]; el<bcol[i+1]; ++el) bk[el] = brow[el]==i ? 1 : 0;"
+             << endl;
+      stream << "    }" << endl;
+    }
+    generateGradLag(stream, "glag", gen);
+    stream << "  }" << endl;
+    stream << endl;
+
+    // Main loop
+    stream << "  /* SQP iterations */" << endl;
+    stream << "  while (1) {" << endl;
+    stream << "    pr_inf = casadi_max_viol(" << nx_ << ", x, " << lbx << ", " << ubx << ");"
+           << endl;
+    stream << "    tmp = casadi_max_viol(" << ng_ << ", g, " << lbg << ", " << ubg << ");"
+           << endl;
+    stream << "    if (tmp>pr_inf) pr_inf = tmp;" << endl;
+    stream << "    du_inf = casadi_norm_inf(" << nx_ << ", glag);" << endl;
+    stream << "    dx_norm = casadi_norm_inf(" << nx_ << ", dx);" << endl;
+    stream << "    if (pr_inf<";
+    CodeGenerator::printConstant(stream, tol_pr_);
+    stream << " && du_inf<";
+    CodeGenerator::printConstant(stream, tol_du_);
+    stream << ") break;" << endl;
+    stream << "    if (iter>=" << max_iter_ << ") break;" << endl;
+    stream << "    if (iter>0 && dx_norm<=";
+    CodeGenerator::printConstant(stream, min_step_size_);
+    stream << ") break;" << endl;
+    stream << "    iter++;" << endl;
+    stream << endl;
+
+    // QP subproblem
+    stream << "    /* QP subproblem */" << endl;
+    stream << "    for (i=0; i<" << nx_ << "; ++i) {" << endl;
+    stream << "      lbdx[i] = " << lbx << "[i]-x[i];" << endl;
+    stream << "      ubdx[i] = " << ubx << "[i]-x[i];" << endl;
+    stream << "    }" << endl;
+    stream << "    for (i=0; i<" << ng_ << "; ++i) {" << endl;
+    stream << "      lbdg[i] = " << lbg << "[i]-g[i];" << endl;
+    stream << "      ubdg[i] = " << ubg << "[i]-g[i];" << endl;
+    stream << "    }" << endl;
+    stream << "    casadi_densify(bk, s" << s_b << ", hd);" << endl;
+    stream << "    casadi_densify(jk, s" << s_j << ", jd);" << endl;
+    stream << "    casadi_fill(" << nx_ << ", 0., dx, 1);" << endl;
+    stream << "    casadi_qp_dense(" << nx_ << ", " << ng_
+           << ", hd, gf, jd, lbdx, ubdx, lbdg, ubdg, dx, qp_lam_x, qp_lam_a, "
+           << codegen_qp_max_iter_ << ", ";
+    CodeGenerator::printConstant(stream, codegen_qp_tol_);
+    stream << ", w_qp);" << endl;
+    stream << endl;
+
+    // Merit function
+    stream << "    /* Penalty parameter and l1 merit function */" << endl;
+    stream << "    tmp = 1.01*casadi_norm_inf(" << nx_ << ", qp_lam_x);" << endl;
+    stream << "    if (tmp>sigma) sigma = tmp;" << endl;
+    stream << "    tmp = 1.01*casadi_norm_inf(" << ng_ << ", qp_lam_a);" << endl;
+    stream << "    if (tmp>sigma) sigma = tmp;" << endl;
+    stream << "    l1_infeas = pr_inf;" << endl;
+    stream << "    l1_dir = casadi_dot(" << nx_ << ", dx, 1, gf, 1) - sigma*l1_infeas;" << endl;
+    stream << "    l1_merit = f + sigma*l1_infeas;" << endl;
+    stream << "    if (n_mem==" << merit_memsize_ << ") {" << endl;
+    stream << "      for (k=1; k<n_mem; ++k) merit_mem[k-1] = merit_mem[k];" << endl;
+    stream << "      n_mem--;" << endl;
+    stream << "    }" << endl;
+    stream << "    merit_mem[n_mem++] = l1_merit;" << endl;
+    stream << endl;
+
+    // Line-search, a candidate with a NaN objective fails the Armijo test
+    stream << "    /* Line-search */" << endl;
+    stream << "    t = 1;" << endl;
+    if (max_iter_ls_>0) {
+      stream << "    ls_iter = 0;" << endl;
+      stream << "    while (1) {" << endl;
+      stream << "      for (i=0; i<" << nx_ << "; ++i) x_cand[i] = x[i] + t*dx[i];" << endl;
+      stream << "      f" << gen.getDependency(nlp_) << "(x_cand, " << p << ", &f_cand, "
+             << (ng_>0 ? "g_cand" : "0") << ");" << endl;
+      stream << "      ls_iter++;" << endl;
+      stream << "      l1_infeas = casadi_max_viol(" << nx_ << ", x_cand, " << lbx << ", "
+             << ubx << ");" << endl;
+      stream << "      tmp = casadi_max_viol(" << ng_ << ", g_cand, " << lbg << ", " << ubg
+             << ");" << endl;
+      stream << "      if (tmp>l1_infeas) l1_infeas = tmp;" << endl;
+      stream << "      merit_max = merit_mem[0];" << endl;
+      stream << "      for (k=1; k<n_mem; ++k) "
+             << "if (merit_mem[k]>merit_max) merit_max = merit_mem[k];" << endl;
+      stream << "      if (f_cand + sigma*l1_infeas <= merit_max + t*";
+      CodeGenerator::printConstant(stream, c1_);
+      stream << "*l1_dir) break;" << endl;
+      stream << "      if (ls_iter==" << max_iter_ls_ << ") break;" << endl;
+      stream << "      t *= ";
+      CodeGenerator::printConstant(stream, beta_);
+      stream << ";" << endl;
+      stream << "    }" << endl;
+    } else {
+      stream << "    for (i=0; i<" << nx_ << "; ++i) x_cand[i] = x[i] + dx[i];" << endl;
+    }
+
+    // Accept the step
+    stream << "    for (i=0; i<" << ng_ << "; ++i) mu[i] = t*qp_lam_a[i] + (1-t)*mu[i];" << endl;
+    stream << "    for (i=0; i<" << nx_ << "; ++i) mu_x[i] = t*qp_lam_x[i] + (1-t)*mu_x[i];"
+           << endl;
+    stream << "    casadi_copy(" << nx_ << ", x, 1, x_old, 1);" << endl;
+    stream << "    casadi_copy(" << nx_ << ", x_cand, 1, x, 1);" << endl;
+    stream << endl;
+
+    // Gradient of the Lagrangian with the old x but new mu (for BFGS)
+    if (!exact_hessian_) generateGradLag(stream, "glag_old", gen);
+
+    // Derivatives in the new iterate
+    stream << eval_jac_grad.str();
+    generateGradLag(stream, "glag", gen);
+
+    // Update the Hessian or Hessian approximation
+    if (exact_hessian_) {
+      generateEvalH(stream, gen);
+    } else {
+      stream << "    if (iter % " << lbfgs_memory_ << " == 0) {" << endl;
+      stream << "      for (i=0; i<" << nx_ << "; ++i) {" << endl;
+      stream << "        for (el=bcol[i]; el<bcol[i+1]; ++el) if (brow[el]!=i) bk[el] = 0;"
+             << endl;
+      stream << "      }" << endl;
+      stream << "    }" << endl;
+      stream << "    f" << gen.getDependency(bfgs_)
+             << "(bk, x, x_old, glag, glag_old, bk_new);" << endl;
+      stream << "    casadi_copy(" << Bk_.size() << ", bk_new, 1, bk, 1);" << endl;
+    }
+    stream << "  }" << endl;
+    stream << endl;
+
+    // Outputs
+    stream << "  /* Solution */" << endl;
+    stream << "  if (" << r_x << ") casadi_copy(" << nx_ << ", x, 1, " << r_x << ", 1);" << endl;
+    stream << "  if (" << r_f << ") *" << r_f << " = f;" << endl;
+    stream << "  if (" << r_g << ") casadi_copy(" << ng_ << ", g, 1, " << r_g << ", 1);" << endl;
+    stream << "  if (" << r_lam_x << ") casadi_copy(" << nx_ << ", mu_x, 1, " << r_lam_x << ", 1);"
+           << endl;
+    stream << "  if (" << r_lam_g << ") casadi_copy(" << ng_ << ", mu, 1, " << r_lam_g << ", 1);"
+           << endl;
+    stream << "  if (" << r_lam_p << ") casadi_fill(" << input(NLP_SOLVER_P).size() << ", 0., "
+           << r_lam_p << ", 1);" << endl;
+  }
+
 } // namespace casadi
@@ -34,6 +34,10 @@
 
 /** \defgroup plugin_NlpSolver_sqpmethod
  A textbook SQPMethod
+
+ The complete iteration can be exported with generateCode. The generated C code
+ uses fixed-size work arrays and solves the QP subproblems with a built-in dense
+ interior point method instead of the configured QP solver.
 */
 
 /** \pluginsection{NlpSolver,sqpmethod} */
@@ -58,6 +62,20 @@ namespace casadi {
     virtual void init();
     virtual void evaluate();
 
+    /** \brief Generate code for the declarations of the C function */
+    virtual void generateDeclarations(std::ostream &stream, const std::string& type,
+                                      CodeGenerator& gen) const;
+
+    /** \brief Generate code for the function body */
+    virtual void generateBody(std::ostream &stream, const std::string& type,
+                              CodeGenerator& gen) const;
+
+    /// Generate code for the gradient of the Lagrangian
+    void generateGradLag(std::ostream &stream, const std::string& glag, CodeGenerator& gen) const;
+
+    /// Generate code for evaluating the exact Hessian of the Lagrangian
+    void generateEvalH(std::ostream &stream, CodeGenerator& gen) const;
+
     /// QP solver for the subproblems
     QpSolver qp_solver_;
 
@@ -89,6 +107,10 @@ namespace casadi {
     /// Hessian regularization
     double reg_;
 
+    /// Iteration limit and tolerance of the QP solver in generated code
+    int codegen_qp_max_iter_;
+    double codegen_qp_tol_;
+
     /// Access QpSolver
     const QpSolver getQpSolver() const { return qp_solver_;}
 
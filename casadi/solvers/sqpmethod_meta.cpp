@@ -30,6 +30,10 @@
       "\n"
 "A textbook SQPMethod\n"
 "\n"
+"The complete iteration can be exported with generateCode. The generated C\n"
+"code uses fixed-size work arrays and solves the QP subproblems with a\n"
+"built-in dense interior point method instead of the configured QP solver.\n"
+"\n"
 "\n"
 ">List of available options\n"
 "\n"
@@ -48,6 +52,17 @@
 "|                 |                 |                 | decrease in     |\n"
 "|                 |                 |                 | merit           |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
+"| codegen_qp_max_ | OT_INTEGER      | 50              | Maximum number  |\n"
+"| iter            |                 |                 | of iterations   |\n"
+"|                 |                 |                 | of the dense QP |\n"
+"|                 |                 |                 | solver in       |\n"
+"|                 |                 |                 | generated code  |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
+"| codegen_qp_tol  | OT_REAL         | 0.000           | Tolerance of    |\n"
+"|                 |                 |                 | the dense QP    |\n"
+"|                 |                 |                 | solver in       |\n"
+"|                 |                 |                 | generated code  |\n"
+"+-----------------+-----------------+-----------------+-----------------+\n"
 "| hessian_approxi | OT_STRING       | \"exact\"         | limited-        |\n"
 "| mation          |                 |                 | memory|exact    |\n"
 "+-----------------+-----------------+-----------------+-----------------+\n"
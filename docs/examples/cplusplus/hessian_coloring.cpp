@@ -0,0 +1,123 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Star versus acyclic coloring of Hessians
+ * NOTE: Example is mainly intended for developers of CasADi.
+ * Hessians are calculated with forward-over-adjoint sweeps, one per color of the
+ * sparsity pattern. A star coloring allows reading off the entries directly, whereas an
+ * acyclic coloring needs fewer colors but recovers the entries by substitution.
+ * This example compares the number of sweeps and the time needed to form and evaluate
+ * the Hessian for some banded and arrowhead test problems.
+ */
+
+#include "casadi/casadi.hpp"
+#include <ctime>
+#include <iomanip>
+
+using namespace casadi;
+using namespace std;
+
+// Objective with a Hessian of half bandwidth k
+SX banded(const SX& x, int k) {
+  int n = x.size1();
+  SX f = sumAll(pow(x, 4));
+  for (int j=1; j<=k; ++j) {
+    f += sumAll(sin(x(Slice(0, n-j))*x(Slice(j, n))));
+  }
+  return f;
+}
+
+// Objective with an arrowhead Hessian with m dense rows and columns
+SX arrowhead(const SX& x, int m) {
+  int n = x.size1();
+  SX f = sumAll(pow(x, 4));
+  for (int j=0; j<m; ++j) {
+    f += sumAll(cos(x(j)+x(Slice(m, n))));
+  }
+  return f;
+}
+
+int main() {
+  int n = 1000;
+
+  // Test problems
+  vector<string> name;
+  vector<SX> obj;
+  SX x = SX::sym("x", n);
+  for (int k=1; k<=4; k*=2) {
+    stringstream ss;
+    ss << "banded, k=" << k;
+    name.push_back(ss.str());
+    obj.push_back(banded(x, k));
+  }
+  for (int m=1; m<=4; m*=2) {
+    stringstream ss;
+    ss << "arrowhead, m=" << m;
+    name.push_back(ss.str());
+    obj.push_back(arrowhead(x, m));
+  }
+
+  // Linearization point
+  vector<double> x0(n);
+  for (int i=0; i<n; ++i) x0[i] = sin(0.1*i);
+
+  cout << setw(16) << "problem" << setw(8) << "nnz"
+       << setw(8) << "star" << setw(8) << "acyclic"
+       << setw(12) << "t_star" << setw(12) << "t_acyclic" << setw(12) << "max_diff" << endl;
+  for (int p=0; p<obj.size(); ++p) {
+    DMatrix H[2];
+    double t[2];
+    int ncolors[2];
+    const char* coloring[2] = {"star", "acyclic"};
+    for (int c=0; c<2; ++c) {
+      SXFunction f(x, obj[p]);
+      f.setOption("symmetric_coloring", coloring[c]);
+      f.init();
+
+      // Number of sweeps, the star coloring is used unless the acyclic coloring is better
+      Sparsity sp = f.hessian().output().sparsity();
+      ncolors[c] = sp.starColoring().size2();
+      if (c==1) {
+        Sparsity D = sp.acyclicColoring(1, ncolors[c]-1);
+        if (!D.isNull()) ncolors[c] = D.size2();
+      }
+
+      // Form and evaluate the Hessian
+      clock_t t0 = clock();
+      Function h = f.hessian();
+      h.init();
+      h.setInput(x0);
+      h.evaluate();
+      t[c] = double(clock()-t0)/CLOCKS_PER_SEC;
+      H[c] = h.output();
+    }
+    cout << setw(16) << name[p] << setw(8) << H[0].size()
+         << setw(8) << ncolors[0] << setw(8) << ncolors[1]
+         << setw(12) << t[0] << setw(12) << t[1]
+         << setw(12) << norm_inf(H[0]-H[1]).at(0) << endl;
+  }
+
+  return 0;
+}
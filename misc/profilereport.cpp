@@ -69,12 +69,14 @@ typedef std::map<long,functionstat> Stats;
 int main(int argc, char* argv[])
 {
     Stats data;
+    std::vector<ProfilingData_CLOCK> clocks;
+    std::vector<ProfilingData_EVENT> events;
     if (argc < 1) {
         std::cerr << "Usage: " << argv[0] << "prof.log" << std::endl;
         return 1;
     }
     
-  std::ifstream myfile (argv[1]);
+  std::ifstream myfile (argv[1], std::ifstream::in | std::ifstream::binary);
   if (myfile.is_open())
   {
     while (!myfile.eof()) {
@@ -159,6 +161,20 @@ int main(int argc, char* argv[])
       it->second.total_time +=s.total;
       //std::cout << "Exit " << s.thisp << ": " << s.total << std::endl;
      }; break;
+     case (ProfilingData_Type_CLOCK) : {
+      ProfilingData_CLOCK s;
+      myfile.read(reinterpret_cast<char*>(&s), sizeof(s));
+      clocks.push_back(s);
+     }; break;
+     case (ProfilingData_Type_EVENTS) : {
+      ProfilingData_EVENTS s;
+      myfile.read(reinterpret_cast<char*>(&s), sizeof(s));
+      ProfilingData_EVENT e;
+      for (int i=0;i<s.count;++i) {
+        myfile.read(reinterpret_cast<char*>(&e), sizeof(e));
+        events.push_back(e);
+      }
+     }; break;
      default:
        std::cerr << "Unknown type in profile header: " << hd.type << std::endl;
     }
@@ -166,6 +182,28 @@ int main(int argc, char* argv[])
   } else {
     std::cerr << "Unable to open file" << std::endl;
   }
+  
+  // Timed spans, converted from ticks to seconds with the clock records
+  double seconds_per_tick = 1e-9;
+  if (clocks.size()>=2 && clocks.back().ticks>clocks.front().ticks &&
+      clocks.back().time>clocks.front().time) {
+    seconds_per_tick = (clocks.back().time-clocks.front().time)/
+      (clocks.back().ticks-clocks.front().ticks);
+  }
+  for (std::vector<ProfilingData_EVENT>::const_iterator it2=events.begin();
+       it2!=events.end();++it2) {
+    Stats::iterator it = data.find(it2->thisp);
+    if (it==data.end()) continue;
+    double t = (it2->stop-it2->start)*seconds_per_tick;
+    if (it2->line_number<0) {
+      it->second.count+=1;
+      it->second.total_time+=t;
+    } else if (it2->line_number<it->second.lines.size()) {
+      it->second.lines[it2->line_number].count+=1;
+      it->second.lines[it2->line_number].total_time+=t;
+    }
+  }
+  
   std::cout << "== Here comes the stats ==" << std::endl;
   
   for (Stats::const_iterator it = data.begin();it!=data.end();++it) {
@@ -0,0 +1,230 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+/** \brief Convert a binary profiling log to the Chrome trace-event format
+ *
+ * Usage: profiletrace prof.log trace.json
+ *
+ * Open the result in chrome://tracing or https://ui.perfetto.dev to inspect nested
+ * function calls on a per-thread timeline. Every recorded call becomes a complete ("X")
+ * event named after the function, every profiled line of its algorithm a nested event
+ * named after the source line.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <set>
+
+#include "casadi/core/profiling.hpp"
+
+using namespace casadi;
+
+struct functioninfo {
+  std::string name;
+  std::vector<std::string> lines;
+};
+
+struct threadevent {
+  int thread;
+  ProfilingData_EVENT e;
+};
+
+/// Quote a string for JSON, keeping only its first line
+std::string jsonString(const std::string& s, size_t max_length) {
+  std::stringstream ss;
+  ss << '"';
+  for (size_t i=0; i<s.size() && i<max_length; ++i) {
+    char c = s[i];
+    if (c=='\n' || c=='\r') break;
+    if (c=='"' || c=='\\') {
+      ss << '\\' << c;
+    } else if (static_cast<unsigned char>(c)<0x20) {
+      ss << ' ';
+    } else {
+      ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+
+template<typename T>
+bool readRecord(std::ifstream& f, T& s) {
+  return static_cast<bool>(f.read(reinterpret_cast<char*>(&s), sizeof(s)));
+}
+
+std::string readString(std::ifstream& f, int length) {
+  std::string s(length, ' ');
+  if (length>0) f.read(&s[0], length);
+  return s;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " prof.log trace.json" << std::endl;
+    return 1;
+  }
+
+  std::ifstream log(argv[1], std::ifstream::in | std::ifstream::binary);
+  if (!log.is_open()) {
+    std::cerr << "Unable to open file " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::map<long, functioninfo> functions;
+  std::vector<ProfilingData_CLOCK> clocks;
+  std::vector<threadevent> events;
+
+  ProfilingHeader hd;
+  while (readRecord(log, hd)) {
+    switch (hd.type) {
+    case ProfilingData_Type_NAME: {
+      ProfilingData_NAME s;
+      readRecord(log, s);
+      functions[s.thisp].name = readString(log, s.length);
+      ProfilingData_IO io;
+      for (int i=0; i<s.numin+s.numout; ++i) readRecord(log, io);
+      break;
+    }
+    case ProfilingData_Type_SOURCE: {
+      ProfilingData_SOURCE s;
+      readRecord(log, s);
+      std::vector<std::string>& lines = functions[s.thisp].lines;
+      if (s.line_number>=static_cast<int>(lines.size())) lines.resize(s.line_number+1);
+      lines[s.line_number] = readString(log, s.length);
+      break;
+    }
+    case ProfilingData_Type_CLOCK: {
+      ProfilingData_CLOCK s;
+      readRecord(log, s);
+      clocks.push_back(s);
+      break;
+    }
+    case ProfilingData_Type_EVENTS: {
+      ProfilingData_EVENTS s;
+      readRecord(log, s);
+      threadevent t;
+      t.thread = s.thread;
+      for (int i=0; i<s.count && readRecord(log, t.e); ++i) events.push_back(t);
+      break;
+    }
+    case ProfilingData_Type_TIMELINE: {
+      ProfilingData_TIMELINE s;
+      readRecord(log, s);
+      break;
+    }
+    case ProfilingData_Type_ENTRY: {
+      ProfilingData_ENTRY s;
+      readRecord(log, s);
+      break;
+    }
+    case ProfilingData_Type_EXIT: {
+      ProfilingData_EXIT s;
+      readRecord(log, s);
+      break;
+    }
+    default:
+      std::cerr << "Unknown type in profile header: " << hd.type << std::endl;
+      return 1;
+    }
+  }
+
+  if (events.empty()) {
+    std::cerr << "No events found, was the log written in binary mode?" << std::endl;
+  }
+
+  // Ticks to microseconds, from the first and last clock records
+  unsigned long long origin = 0;
+  double us_per_tick = 1e-3;
+  if (!clocks.empty()) origin = clocks.front().ticks;
+  if (clocks.size()>=2 && clocks.back().ticks>clocks.front().ticks &&
+      clocks.back().time>clocks.front().time) {
+    us_per_tick = 1e6*(clocks.back().time-clocks.front().time)/
+      static_cast<double>(clocks.back().ticks-clocks.front().ticks);
+  } else {
+    std::cerr << "No usable clock records, assuming one tick per nanosecond" << std::endl;
+  }
+
+  std::ofstream trace(argv[2]);
+  if (!trace.is_open()) {
+    std::cerr << "Unable to open file " << argv[2] << std::endl;
+    return 1;
+  }
+  trace.precision(15);
+  trace << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" << std::endl;
+
+  std::set<int> threads;
+  for (std::vector<threadevent>::const_iterator it=events.begin(); it!=events.end(); ++it) {
+    threads.insert(it->thread);
+  }
+  bool first = true;
+  for (std::set<int>::const_iterator it=threads.begin(); it!=threads.end(); ++it) {
+    trace << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+          << "\"tid\":" << *it << ",\"args\":{\"name\":\"thread " << *it << "\"}}";
+    first = false;
+  }
+
+  for (std::vector<threadevent>::const_iterator it=events.begin(); it!=events.end(); ++it) {
+    const ProfilingData_EVENT& e = it->e;
+    std::map<long, functioninfo>::const_iterator f = functions.find(e.thisp);
+    std::string fname;
+    if (f==functions.end()) {
+      std::stringstream ss;
+      ss << "0x" << std::hex << e.thisp;
+      fname = ss.str();
+    } else {
+      fname = f->second.name;
+    }
+
+    std::string name;
+    if (e.line_number<0) {
+      name = fname;
+    } else if (f!=functions.end() &&
+               e.line_number<static_cast<int>(f->second.lines.size())) {
+      name = f->second.lines[e.line_number];
+    } else {
+      std::stringstream ss;
+      ss << fname << ":" << e.line_number;
+      name = ss.str();
+    }
+
+    trace << (first ? "" : ",\n") << "{\"name\":" << jsonString(name, 80)
+          << ",\"cat\":\"" << (e.line_number<0 ? "call" : "line") << "\",\"ph\":\"X\""
+          << ",\"ts\":" << static_cast<double>(static_cast<long long>(e.start-origin))*us_per_tick
+          << ",\"dur\":" << static_cast<double>(e.stop-e.start)*us_per_tick
+          << ",\"pid\":0,\"tid\":" << it->thread
+          << ",\"args\":{\"function\":" << jsonString(fname, 80);
+    if (e.line_number>=0) trace << ",\"line\":" << e.line_number;
+    trace << "}}";
+    first = false;
+  }
+
+  trace << "\n]}" << std::endl;
+  return 0;
+}
@@ -0,0 +1,99 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+#include <casadi/core/function/function_internal.hpp>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ctime>
+#include <map>
+
+using namespace casadi;
+using namespace std;
+
+/// Shared objects in a directory, with their modification times
+map<string, time_t> sharedObjects(const string& dir) {
+  map<string, time_t> ret;
+  DIR* d = opendir(dir.c_str());
+  if (d==0) return ret;
+  for (dirent* e=readdir(d); e!=0; e=readdir(d)) {
+    string name = e->d_name;
+    if (name.size()<3 || name.substr(name.size()-3)!=".so") continue;
+    struct stat st;
+    if (stat((dir + "/" + name).c_str(), &st)==0) ret[name] = st.st_mtime;
+  }
+  closedir(d);
+  return ret;
+}
+
+/// Compile a function with dynamicCompilation and evaluate it at x=2
+double compileAndEvaluate(const SX& expr, const SX& x) {
+  Function f = SXFunction(x, expr);
+  f.init();
+  Function g = f->dynamicCompilation(f, "codegen_cache_test", "test function",
+                                     string(CASADI_TEST_C_COMPILER) + " -fPIC -O1");
+  g.setInput(2.0);
+  g.evaluate();
+  return g.output().toScalar();
+}
+
+/** \brief Persistent cache of dynamicCompilation
+ *
+ * Compiling the same function twice must reuse the shared object of the first compilation,
+ * while a changed function must miss the cache and be compiled.
+ */
+int main() {
+  string dir = "codegen_cache";
+  CASADI_CHECK(system(("rm -rf " + dir + " && mkdir " + dir).c_str())==0);
+  CasadiOptions::setCodegenCacheDir(dir);
+
+  SX x = SX::sym("x");
+
+  // First compilation fills the cache
+  CASADI_CHECK(compileAndEvaluate(x*x+1, x)==5);
+  map<string, time_t> first = sharedObjects(dir);
+  CASADI_CHECK(first.size()==1);
+
+  // The timestamps below must be able to tell a recompilation apart
+  sleep(1);
+
+  // Same function: hit, the shared object is neither added nor rewritten
+  CASADI_CHECK(compileAndEvaluate(x*x+1, x)==5);
+  CASADI_CHECK(sharedObjects(dir)==first);
+
+  // Changed function: miss, a second shared object is added
+  CASADI_CHECK(compileAndEvaluate(x*x+2, x)==6);
+  map<string, time_t> second = sharedObjects(dir);
+  CASADI_CHECK(second.size()==2);
+  for (map<string, time_t>::const_iterator it=first.begin(); it!=first.end(); ++it) {
+    CASADI_CHECK(second.count(it->first)==1 && second[it->first]==it->second);
+  }
+
+  CasadiOptions::setCodegenCacheDir("");
+  return casadi_test::result();
+}
@@ -0,0 +1,135 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+#include <casadi/core/function/function_internal.hpp>
+#include <fstream>
+#ifdef USE_CXX11
+#include <thread>
+#endif // USE_CXX11
+
+using namespace casadi;
+using namespace std;
+
+/// Evaluate a function repeatedly, count the results that differ from the reference
+void evaluateRepeatedly(Function f, DMatrix x, DMatrix ref, int* nwrong) {
+  for (int k=0; k<200; ++k) {
+    f.setInput(x);
+    f.evaluate();
+    if (casadi_test::maxDiff(f.output(1), ref)>1e-12) (*nwrong)++;
+  }
+}
+
+/** \brief Code generation in chunks
+ *
+ * A function whose algorithm is split into chunks is compiled, once with all chunks in
+ * one file and once with every chunk as a separate translation unit. Both must agree with
+ * the unchunked function, also when evaluated repeatedly. The chunks are named after the
+ * function, and with C++11 the compiled function is evaluated from several threads at once.
+ */
+int main() {
+  // Enough operations for several chunks, using the sq and sign auxiliaries
+  SX x = SX::sym("x", 4);
+  SX r = x;
+  for (int k=0; k<20; ++k) {
+    SX x0 = r[0], x1 = r[1], x2 = r[2], x3 = r[3];
+    vector<SX> next;
+    next.push_back(sin(x1) + 0.1*sq(x3));
+    next.push_back(x0*sign(x2) - 0.2*x1);
+    next.push_back(cos(x3)*x2 + 0.3);
+    next.push_back(0.5*x0 - fabs(x1));
+    r = vertcat(next);
+  }
+  vector<SX> res;
+  res.push_back(r);
+  res.push_back(inner_prod(r, r));
+  SXFunction f(x, res);
+  f.init();
+
+  SXFunction fc(x, res);
+  fc.setOption("codegen_chunk_size", 25);
+  fc.setOption("name", "chunked");
+  fc.init();
+  CASADI_CHECK(fc.getAlgorithmSize()>3*25);
+
+  // All chunks in the same file, named after the function, no static work array
+  fc.generateCode("codegen_chunks.c");
+  ifstream cfile("codegen_chunks.c");
+  stringstream code;
+  code << cfile.rdbuf();
+  CASADI_CHECK(code.str().find("void chunked_chunk0(")!=string::npos);
+  CASADI_CHECK(code.str().find("static")==string::npos);
+  CASADI_CHECK(casadi_test::compile("codegen_chunks.c", "codegen_chunks.so"));
+  ExternalFunction e("./codegen_chunks.so");
+  e.init();
+
+  // Every chunk in a separate translation unit
+  Function fcf = fc;
+  Function u = fcf->dynamicCompilation(fcf, "codegen_chunks_units", "chunked function",
+                                       string(CASADI_TEST_C_COMPILER) + " -fPIC -O1");
+
+  // Repeated evaluations must not depend on the previous ones
+  for (int k=0; k<3; ++k) {
+    DMatrix xv = DMatrix::zeros(4, 1);
+    for (int i=0; i<4; ++i) xv.at(i) = 0.3*(i+1) - 0.5*k;
+    f.setInput(xv);
+    f.evaluate();
+    e.setInput(xv);
+    e.evaluate();
+    u.setInput(xv);
+    u.evaluate();
+    for (int i=0; i<f.getNumOutputs(); ++i) {
+      CASADI_CHECK_CLOSE(e.output(i), f.output(i), 1e-12);
+      CASADI_CHECK_CLOSE(u.output(i), f.output(i), 1e-12);
+    }
+  }
+
+#ifdef USE_CXX11
+  // Concurrent evaluations of the compiled function with different inputs
+  const int nthreads = 4;
+  vector<Function> ef(nthreads);
+  vector<DMatrix> xv(nthreads), ref(nthreads);
+  vector<int> nwrong(nthreads, 0);
+  for (int t=0; t<nthreads; ++t) {
+    ef[t] = ExternalFunction("./codegen_chunks.so");
+    ef[t].init();
+    xv[t] = DMatrix::zeros(4, 1);
+    for (int i=0; i<4; ++i) xv[t].at(i) = 0.2*(i+1) - 0.3*t;
+    f.setInput(xv[t]);
+    f.evaluate();
+    ref[t] = f.output(1);
+  }
+  vector<thread> threads;
+  for (int t=0; t<nthreads; ++t) {
+    threads.push_back(thread(evaluateRepeatedly, ef[t], xv[t], ref[t], &nwrong[t]));
+  }
+  for (int t=0; t<nthreads; ++t) {
+    threads[t].join();
+    CASADI_CHECK(nwrong[t]==0);
+  }
+#endif // USE_CXX11
+
+  return casadi_test::result();
+}
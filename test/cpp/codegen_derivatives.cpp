@@ -0,0 +1,127 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+
+using namespace casadi;
+using namespace std;
+
+/** \brief Derivative kernels and Jacobian sparsity exported by generated code
+ *
+ * A function is generated with codegen_derivatives, compiled and loaded as an
+ * ExternalFunction. Its directional derivatives, full Jacobian and Jacobian sparsity
+ * must agree with those of the original function. The Jacobian of a function with one
+ * input and one output, which is the exported kernel itself, must be ready for evaluation.
+ */
+int main() {
+  SX x = SX::sym("x", 3), y = SX::sym("y", 2);
+  vector<SX> arg;
+  arg.push_back(x);
+  arg.push_back(y);
+  vector<SX> res;
+  SX x0 = x[0], x1 = x[1], x2 = x[2], y0 = y[0], y1 = y[1];
+  res.push_back(vertcat(sin(x0)*y0, vertcat(x1*x2, y1*y1)));
+  res.push_back(inner_prod(x, x) + exp(y0));
+  SXFunction f(arg, res);
+  f.setOption("codegen_derivatives", true);
+  f.init();
+
+  f.generateCode("codegen_derivatives.c");
+  CASADI_CHECK(casadi_test::compile("codegen_derivatives.c", "codegen_derivatives.so"));
+  ExternalFunction e("./codegen_derivatives.so");
+  e.init();
+
+  // Nondifferentiated evaluation
+  double x_val[] = {0.3, -1.2, 2.0}, y_val[] = {0.7, 1.5};
+  vector<double> xv(x_val, x_val+3), yv(y_val, y_val+2);
+  f.setInput(xv, 0);
+  f.setInput(yv, 1);
+  f.evaluate();
+  e.setInput(xv, 0);
+  e.setInput(yv, 1);
+  e.evaluate();
+  for (int i=0; i<f.getNumOutputs(); ++i) {
+    CASADI_CHECK_CLOSE(e.output(i), f.output(i), 1e-12);
+  }
+
+  // One forward and one adjoint direction
+  Function fd = f.derivative(1, 1), ed = e.derivative(1, 1);
+  fd.init();
+  ed.init();
+  CASADI_CHECK(ed.getNumInputs()==fd.getNumInputs());
+  CASADI_CHECK(ed.getNumOutputs()==fd.getNumOutputs());
+  for (int i=0; i<fd.getNumInputs(); ++i) {
+    DMatrix v = DMatrix::zeros(fd.input(i).sparsity());
+    for (int k=0; k<v.size(); ++k) v.at(k) = 0.1*(k+1) + 0.3*i;
+    fd.setInput(v, i);
+    ed.setInput(v, i);
+  }
+  fd.evaluate();
+  ed.evaluate();
+  for (int i=0; i<fd.getNumOutputs(); ++i) {
+    CASADI_CHECK_CLOSE(ed.output(i), fd.output(i), 1e-12);
+  }
+
+  // Full Jacobian
+  Function fj = f.fullJacobian(), ej = e.fullJacobian();
+  fj.init();
+  ej.init();
+  for (int i=0; i<fj.getNumInputs(); ++i) {
+    fj.setInput(f.input(i), i);
+    ej.setInput(f.input(i), i);
+  }
+  fj.evaluate();
+  ej.evaluate();
+  for (int i=0; i<fj.getNumOutputs(); ++i) {
+    CASADI_CHECK(ej.output(i).sparsity().isEqual(fj.output(i).sparsity()));
+    CASADI_CHECK_CLOSE(ej.output(i), fj.output(i), 1e-12);
+  }
+
+  // Exported Jacobian sparsity
+  for (int iind=0; iind<f.getNumInputs(); ++iind) {
+    for (int oind=0; oind<f.getNumOutputs(); ++oind) {
+      CASADI_CHECK(e.jacSparsity(iind, oind).isEqual(f.jacSparsity(iind, oind)));
+    }
+  }
+
+  // Jacobian of a function with one input and one output, from the exported kernel
+  SXFunction g(x, vertcat(sin(x0)*x1, x2*x2));
+  g.setOption("codegen_derivatives", true);
+  g.init();
+  g.generateCode("codegen_derivatives_jac.c");
+  CASADI_CHECK(casadi_test::compile("codegen_derivatives_jac.c", "codegen_derivatives_jac.so"));
+  ExternalFunction eg("./codegen_derivatives_jac.so");
+  eg.init();
+  Function gj = g.jacobian(0, 0, true), egj = eg.jacobian(0, 0, true);
+  CASADI_CHECK(egj.isInit());
+  gj.init();
+  gj.setInput(xv);
+  egj.setInput(xv);
+  gj.evaluate();
+  egj.evaluate();
+  CASADI_CHECK_CLOSE(egj.output(), gj.output(), 1e-12);
+
+  return casadi_test::result();
+}
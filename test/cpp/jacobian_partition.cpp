@@ -0,0 +1,114 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+#include <casadi/core/function/function_internal.hpp>
+
+using namespace casadi;
+using namespace std;
+
+/// Random numbers that are the same on all platforms
+struct Random {
+  explicit Random(unsigned int seed) : state(seed) {}
+  int next(int n) {
+    state = 1103515245*state + 12345;
+    return (state >> 16) % n;
+  }
+  unsigned int state;
+};
+
+/// A nonlinear function of x with sparse mixing and with a dense row and/or column
+MX randomFunction(const MX& x, int seed, bool dense_row, bool dense_col) {
+  int n = x.size();
+  Random rnd(seed);
+  vector<MX> e(n);
+  for (int i=0; i<n; ++i) {
+    MX xi = x[i];
+    MX xj = x[rnd.next(n)];
+    switch (rnd.next(4)) {
+    case 0: e[i] = sin(xi)*xj; break;
+    case 1: e[i] = xi*xi + xj; break;
+    case 2: e[i] = cos(xj)*xi; break;
+    default: e[i] = xi/(2+xj*xj);
+    }
+  }
+  MX y = vertcat(e);
+  DMatrix M = DMatrix::sparse(n, n);
+  for (int k=0; k<n; ++k) M(rnd.next(n), rnd.next(n)) = 0.1*(rnd.next(11)-5);
+  y = y + mul(M, sin(x));
+  int r = rnd.next(n);
+  MX xc = x[rnd.next(n)];
+  if (dense_row) y = vertcat(y(Slice(0, r)), vertcat(sumAll(x*x*xc), y(Slice(r+1, n))));
+  if (dense_col) y = y + xc*cos(x);
+  return y;
+}
+
+/// Jacobian of y with respect to x in a given ad_mode, at x_k = (k+1)/10
+DMatrix jacobian(const MX& x, const MX& y, const string& ad_mode) {
+  MXFunction f(x, y);
+  f.setOption("ad_mode", ad_mode);
+  f.init();
+  Function J = f.jacobian(0, 0);
+  J.init();
+  for (int k=0; k<x.size(); ++k) J.input()[k] = 0.1*(k+1);
+  J.evaluate();
+  return J.output();
+}
+
+/** \brief Partitioning and recovery of Jacobians
+ *
+ * An arrow-shaped Jacobian is computed with two forward and one adjoint direction in
+ * automatic mode. For MX functions with dense rows and columns, the Jacobians in forward,
+ * reverse and automatic mode must agree.
+ */
+int main() {
+  // Nonzero indices with a nested-slice prefix followed by other indices
+  int v[] = {0, 1, 5, 6, 7, 9};
+  CASADI_CHECK(!Slice::isSlice2(vector<int>(v, v+6)));
+  CASADI_CHECK(Slice::isSlice2(vector<int>(v, v+4)));
+
+  // Arrow: dense first row and first column
+  int n = 50;
+  SX x = SX::sym("x", n);
+  SX x0 = x[0];
+  SX rest = x(Slice(1, n));
+  Function f = SXFunction(x, vertcat(sumAll(x*x), sin(x0)*rest + rest*rest));
+  f.init();
+  Sparsity D1, D2;
+  f->getPartition(0, 0, D1, D2, true, false);
+  CASADI_CHECK(!D1.isNull() && D1.size2()==2);
+  CASADI_CHECK(!D2.isNull() && D2.size2()==1);
+
+  // Random MX functions
+  for (int seed=0; seed<60; ++seed) {
+    MX x = MX::sym("x", 12);
+    MX y = randomFunction(x, seed, seed%3!=1, seed%3!=0);
+    DMatrix J_fwd = jacobian(x, y, "forward");
+    CASADI_CHECK_CLOSE(jacobian(x, y, "reverse"), J_fwd, 1e-12);
+    CASADI_CHECK_CLOSE(jacobian(x, y, "automatic"), J_fwd, 1e-12);
+  }
+
+  return casadi_test::result();
+}
@@ -0,0 +1,116 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "test_tools.hpp"
+#include <casadi/core/matrix/sparsity_internal.hpp>
+
+using namespace casadi;
+using namespace std;
+
+/// Laplacian on an n-by-m grid, with a 5-point or a 9-point stencil
+Sparsity grid(int n, int m, bool nine_point) {
+  vector<int> row, col;
+  for (int i=0; i<n; ++i) {
+    for (int j=0; j<m; ++j) {
+      for (int di=-1; di<=1; ++di) {
+        for (int dj=-1; dj<=1; ++dj) {
+          if (!nine_point && di!=0 && dj!=0) continue;
+          if (i+di<0 || i+di>=n || j+dj<0 || j+dj>=m) continue;
+          row.push_back(i*m+j);
+          col.push_back((i+di)*m+j+dj);
+        }
+      }
+    }
+  }
+  return Sparsity::triplet(n*m, n*m, row, col);
+}
+
+/// Laplacian on an n-by-n-by-n grid, 7-point stencil
+Sparsity grid3(int n) {
+  vector<int> row, col;
+  int offset[] = {1, n, n*n};
+  for (int k=0; k<n*n*n; ++k) {
+    row.push_back(k);
+    col.push_back(k);
+    for (int d=0; d<3; ++d) {
+      if ((k/offset[d])%n>0) {
+        row.push_back(k);
+        col.push_back(k-offset[d]);
+        row.push_back(k-offset[d]);
+        col.push_back(k);
+      }
+    }
+  }
+  return Sparsity::triplet(n*n*n, n*n*n, row, col);
+}
+
+/// Number of nonzeros in the Cholesky factor of A(p, p)
+int fill(const Sparsity& A, const vector<int>& p) {
+  Sparsity C = triu(A->permute(SparsityInternal::invertPermutation(p), p, 0));
+  vector<int> parent = C->eliminationTree(false);
+  vector<int> post = SparsityInternal::postorder(parent, C.size2());
+  vector<int> c = C->counts(getPtr(parent), getPtr(post), 0);
+  int ret = 0;
+  for (int k=0; k<c.size(); ++k) ret += c[k];
+  return ret;
+}
+
+/// Check that p is a permutation and that it gives no more fill than AMD
+void checkOrdering(const Sparsity& A) {
+  vector<int> p = A->nestedDissection(1);
+  vector<int> p_sorted = p;
+  sort(p_sorted.begin(), p_sorted.end());
+  CASADI_CHECK(p_sorted==range(A.size2()));
+  int fill_nd = fill(A, p);
+  int fill_amd = fill(A, A->approximateMinimumDegree(1));
+  if (fill_nd>fill_amd) {
+    cerr << A.dimString() << ": nested dissection " << fill_nd << ", AMD " << fill_amd << endl;
+  }
+  CASADI_CHECK(fill_nd<=fill_amd);
+}
+
+/** \brief Fill of the nested dissection ordering
+ *
+ * On 2-D and 3-D grids, nested dissection must give no more fill in the Cholesky factor
+ * than approximate minimum degree. The ordering must also handle disconnected graphs.
+ */
+int main() {
+  // 2-D grids, square and rectangular
+  checkOrdering(grid(40, 40, false));
+  checkOrdering(grid(80, 80, false));
+  checkOrdering(grid(30, 60, false));
+  checkOrdering(grid(40, 40, true));
+
+  // 3-D grid
+  checkOrdering(grid3(12));
+
+  // Disconnected graph: two grids
+  checkOrdering(diagcat(grid(20, 20, false), grid(25, 15, false)));
+
+  // Grids are dissected
+  Sparsity A = grid(80, 80, false);
+  CASADI_CHECK(fill(A, A->nestedDissection(1)) < fill(A, A->approximateMinimumDegree(1)));
+
+  return casadi_test::result();
+}
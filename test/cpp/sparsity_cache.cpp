@@ -0,0 +1,101 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+
+#ifdef USE_CXX11
+#include <thread>
+#endif // USE_CXX11
+
+using namespace casadi;
+using namespace std;
+
+/// A pattern that differs for every k: three columns with two nonzeros each
+Sparsity pattern(int k) {
+  vector<int> colind(4), row;
+  for (int j=0; j<3; ++j) {
+    colind[j] = row.size();
+    row.push_back(j);
+    row.push_back(j + 1 + k%5);
+  }
+  colind[3] = row.size();
+  return Sparsity(10+k, 3, colind, row);
+}
+
+/// Create the patterns 0, ..., n-1
+void createPatterns(vector<Sparsity>* sp, int n) {
+  sp->resize(n);
+  for (int k=0; k<n; ++k) (*sp)[k] = pattern(k);
+}
+
+/** \brief Cache of sparsity patterns
+ *
+ * Creating an existing pattern again must be counted as a hit and share the node, a new
+ * pattern as a miss. With C++11, several threads create the same patterns concurrently and
+ * must end up with one node per pattern.
+ */
+int main() {
+  const int n = 200;
+  Sparsity::clearCache();
+
+  // Every pattern is created once, then found
+  vector<Sparsity> first, second;
+  createPatterns(&first, n);
+  Sparsity::CacheStats s = Sparsity::getCacheStats();
+  CASADI_CHECK(s.misses==n);
+  CASADI_CHECK(s.hits==0);
+  CASADI_CHECK(s.alive>=n);
+  createPatterns(&second, n);
+  s = Sparsity::getCacheStats();
+  CASADI_CHECK(s.misses==n);
+  CASADI_CHECK(s.hits==n);
+  for (int k=0; k<n; ++k) CASADI_CHECK(first[k].get()==second[k].get());
+
+  // Once deleted, a pattern has to be created again
+  first.clear();
+  second.clear();
+  createPatterns(&first, 1);
+  s = Sparsity::getCacheStats();
+  CASADI_CHECK(s.misses==n+1);
+  CASADI_CHECK(s.hits==n);
+
+#ifdef USE_CXX11
+  // Several threads creating the same patterns, all alive until the end
+  const int nthreads = 8;
+  Sparsity::clearCache();
+  vector<vector<Sparsity> > sp(nthreads);
+  vector<thread> threads;
+  for (int t=0; t<nthreads; ++t) threads.push_back(thread(createPatterns, &sp[t], n));
+  for (int t=0; t<nthreads; ++t) threads[t].join();
+  s = Sparsity::getCacheStats();
+  CASADI_CHECK(s.misses==n);
+  CASADI_CHECK(s.hits==(nthreads-1)*n);
+  for (int t=1; t<nthreads; ++t) {
+    for (int k=0; k<n; ++k) CASADI_CHECK(sp[t][k].get()==sp[0][k].get());
+  }
+#endif // USE_CXX11
+
+  return casadi_test::result();
+}
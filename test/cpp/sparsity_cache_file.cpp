@@ -0,0 +1,99 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "test_tools.hpp"
+#include <casadi/core/function/sparsity_cache.hpp>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+
+using namespace casadi;
+using namespace std;
+
+/// Write the header of a sparsity cache file followed by some integers
+void writeFile(const string& name, const vector<int>& v) {
+  ofstream s(name.c_str(), ios::binary | ios::trunc);
+  int version = 2;
+  s.write("CASPCACH", 8);
+  s.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  s.write(reinterpret_cast<const char*>(getPtr(v)), v.size()*sizeof(int));
+}
+
+/// A damaged file must not match any record and must be rewritten by the next store
+void checkDamaged(const string& name, const vector<int>& v) {
+  remove(name.c_str());
+  writeFile(name, v);
+  SparsityCache::Fingerprint fp(1, 7);
+  vector<Sparsity> sp;
+  bool found = true;
+  try {
+    found = SparsityCache::lookup(name, fp, sp);
+  } catch(exception& e) {
+    cerr << name << ": " << e.what() << endl;
+  }
+  CASADI_CHECK(!found);
+  vector<Sparsity> stored(1, Sparsity::dense(2, 3));
+  SparsityCache::store(name, fp, stored);
+  CASADI_CHECK(SparsityCache::lookup(name, fp, sp));
+  CASADI_CHECK(sp.size()==1 && sp[0]==stored[0]);
+}
+
+/** \brief Damaged files of the persistent sparsity cache
+ *
+ * Counts in a damaged file that exceed its size must be detected before memory is
+ * allocated for them. The records are then ignored and the file is rewritten.
+ */
+int main() {
+  // Record with a valid pattern, as written by the cache
+  const char* name = "sparsity_cache_file.cache";
+  remove(name);
+  SparsityCache::Fingerprint fp(3, 5);
+  vector<Sparsity> sp(2);
+  sp[1] = Sparsity::triplet(4, 3, vector<int>(1, 2), vector<int>(1, 1));
+  SparsityCache::store(name, fp, sp);
+  ifstream s(name, ios::binary);
+  s.seekg(12);
+  vector<int> valid;
+  int i;
+  while (s.read(reinterpret_cast<char*>(&i), sizeof(i))) valid.push_back(i);
+
+  // Damaged copies: number of fingerprint entries, of patterns, of columns and of nonzeros
+  vector<int> v = valid;
+  v[0] = INT_MAX;
+  checkDamaged("sparsity_cache_nfp.cache", v);
+  v = valid;
+  v[1+2*3] = INT_MAX;
+  checkDamaged("sparsity_cache_nsp.cache", v);
+  v = valid;
+  v[1+2*3+1+3+1] = INT_MAX;
+  checkDamaged("sparsity_cache_ncol.cache", v);
+  v = valid;
+  v[1+2*3+1+3+2] = INT_MAX;
+  checkDamaged("sparsity_cache_nnz.cache", v);
+  v = valid;
+  v.pop_back();
+  checkDamaged("sparsity_cache_truncated.cache", v);
+
+  return casadi_test::result();
+}
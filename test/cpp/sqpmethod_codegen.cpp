@@ -0,0 +1,141 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "test_tools.hpp"
+
+#include <limits>
+
+using namespace casadi;
+using namespace std;
+
+/// A test problem with its bounds and initial guess
+struct Problem {
+  string name;
+  Function nlp;
+  vector<double> x0, lbx, ubx, lbg, ubg;
+  double f_opt;
+};
+
+/// Rosenbrock with an equality constraint
+Problem rosenbrock() {
+  SX x = SX::sym("x", 3);
+  SX x0 = x[0], x1 = x[1], x2 = x[2];
+  Problem p;
+  p.name = "rosenbrock";
+  p.nlp = SXFunction(nlpIn("x", x), nlpOut("f", sq(x0) + 100*sq(x2),
+                                             "g", x2 + sq(1-x0) - x1));
+  double x0_val[] = {2.5, 3.0, 0.75};
+  p.x0.assign(x0_val, x0_val+3);
+  p.lbx.assign(3, -numeric_limits<double>::infinity());
+  p.ubx.assign(3, numeric_limits<double>::infinity());
+  p.lbg.assign(1, 0);
+  p.ubg.assign(1, 0);
+  p.f_opt = 0;
+  return p;
+}
+
+/// Hock-Schittkowski problem 71, with bounds and an inequality constraint
+Problem hs071() {
+  SX x = SX::sym("x", 4);
+  SX x0 = x[0], x1 = x[1], x2 = x[2], x3 = x[3];
+  Problem p;
+  p.name = "hs071";
+  p.nlp = SXFunction(nlpIn("x", x), nlpOut("f", x0*x3*(x0+x1+x2) + x2,
+                                             "g", vertcat(x0*x1*x2*x3, inner_prod(x, x))));
+  double x0_val[] = {1, 5, 5, 1};
+  p.x0.assign(x0_val, x0_val+4);
+  p.lbx.assign(4, 1);
+  p.ubx.assign(4, 5);
+  double lbg[] = {25, 40}, ubg[] = {numeric_limits<double>::infinity(), 40};
+  p.lbg.assign(lbg, lbg+2);
+  p.ubg.assign(ubg, ubg+2);
+  p.f_opt = 17.0140172891563;
+  return p;
+}
+
+/// Set the problem data as inputs of a solver
+void setInputs(Function& solver, const Problem& p) {
+  solver.setInput(p.x0, NLP_SOLVER_X0);
+  solver.setInput(p.lbx, NLP_SOLVER_LBX);
+  solver.setInput(p.ubx, NLP_SOLVER_UBX);
+  solver.setInput(p.lbg, NLP_SOLVER_LBG);
+  solver.setInput(p.ubg, NLP_SOLVER_UBG);
+}
+
+/** \brief Generated code of the SQP method
+ *
+ * The solver is generated, compiled and loaded as an ExternalFunction. On small problems,
+ * with the exact Hessian and with BFGS, it must find the same solution and multipliers as
+ * Sqpmethod itself.
+ */
+int main() {
+  NlpSolver::loadPlugin("sqpmethod");
+  QpSolver::loadPlugin("qpoases");
+
+  vector<Problem> problems;
+  problems.push_back(rosenbrock());
+  problems.push_back(hs071());
+  const char* hessians[] = {"exact", "limited-memory"};
+
+  for (int k=0; k<problems.size(); ++k) {
+    Problem& p = problems[k];
+    p.nlp.init();
+    for (int h=0; h<2; ++h) {
+      NlpSolver solver("sqpmethod", p.nlp);
+      solver.setOption("qp_solver", "qpoases");
+      Dictionary qp_options;
+      qp_options["printLevel"] = "none";
+      solver.setOption("qp_solver_options", qp_options);
+      solver.setOption("hessian_approximation", hessians[h]);
+      solver.setOption("print_header", false);
+      solver.setOption("print_time", false);
+      solver.setOption("tol_pr", 1e-10);
+      solver.setOption("tol_du", 1e-10);
+      solver.init();
+
+      // Reference solution
+      setInputs(solver, p);
+      solver.evaluate();
+      CASADI_CHECK_CLOSE(solver.output(NLP_SOLVER_F), DMatrix(p.f_opt), 1e-6);
+
+      // Generated solver
+      string fname = "sqpmethod_" + p.name + (h==0 ? "_exact" : "_bfgs");
+      solver.generateCode(fname + ".c");
+      CASADI_CHECK(casadi_test::compile(fname + ".c", fname + ".so"));
+      Function gen = ExternalFunction("./" + fname + ".so");
+      gen.init();
+      setInputs(gen, p);
+      gen.evaluate();
+
+      CASADI_CHECK_CLOSE(gen.output(NLP_SOLVER_X), solver.output(NLP_SOLVER_X), 1e-6);
+      CASADI_CHECK_CLOSE(gen.output(NLP_SOLVER_F), solver.output(NLP_SOLVER_F), 1e-6);
+      CASADI_CHECK_CLOSE(gen.output(NLP_SOLVER_G), solver.output(NLP_SOLVER_G), 1e-6);
+      CASADI_CHECK_CLOSE(gen.output(NLP_SOLVER_LAM_X), solver.output(NLP_SOLVER_LAM_X), 1e-5);
+      CASADI_CHECK_CLOSE(gen.output(NLP_SOLVER_LAM_G), solver.output(NLP_SOLVER_LAM_G), 1e-5);
+    }
+  }
+
+  return casadi_test::result();
+}
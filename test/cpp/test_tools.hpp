@@ -0,0 +1,98 @@
+/*
+ *    This file is part of CasADi.
+ *
+ *    CasADi -- A symbolic framework for dynamic optimization.
+ *    Copyright (C) 2010-2014 Joel Andersson, Joris Gillis, Moritz Diehl,
+ *                            K.U. Leuven. All rights reserved.
+ *    Copyright (C) 2011-2014 Greg Horn
+ *
+ *    CasADi is free software; you can redistribute it and/or
+ *    modify it under the terms of the GNU Lesser General Public
+ *    License as published by the Free Software Foundation; either
+ *    version 3 of the License, or (at your option) any later version.
+ *
+ *    CasADi is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    Lesser General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Lesser General Public
+ *    License along with CasADi; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef CASADI_TEST_TOOLS_HPP
+#define CASADI_TEST_TOOLS_HPP
+
+#include <casadi/casadi.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/** \brief Checks shared by the C++ tests
+ *
+ * A test is an executable that returns nonzero if any check failed. The checks report the
+ * failing expression and keep going, so that one run shows all failures.
+ */
+namespace casadi_test {
+
+  /// Number of failed checks
+  inline int& failures() {
+    static int n = 0;
+    return n;
+  }
+
+  /// Report a failed check
+  inline void fail(const std::string& msg, const char* file, int line) {
+    std::cerr << file << ":" << line << ": " << msg << std::endl;
+    failures()++;
+  }
+
+  /// Largest absolute difference between two matrices, infinite if the shapes differ
+  inline double maxDiff(const casadi::DMatrix& a, const casadi::DMatrix& b) {
+    if (a.size1()!=b.size1() || a.size2()!=b.size2()) return HUGE_VAL;
+    casadi::DMatrix ad = dense(a), bd = dense(b);
+    double d = 0;
+    for (int k=0; k<ad.size(); ++k) d = std::max(d, std::fabs(ad.at(k)-bd.at(k)));
+    return d;
+  }
+
+  /// Check that two matrices agree to a tolerance
+  inline void checkClose(const casadi::DMatrix& a, const casadi::DMatrix& b, double tol,
+                         const char* expr, const char* file, int line) {
+    double d = maxDiff(a, b);
+    if (!(d<=tol)) {
+      std::stringstream ss;
+      ss << "not close: " << expr << ", difference " << d;
+      fail(ss.str(), file, line);
+    }
+  }
+
+  /// Compile a C file into a shared object, returns false on failure
+  inline bool compile(const std::string& cname, const std::string& dlname) {
+    std::string cmd = std::string(CASADI_TEST_C_COMPILER) + " -fPIC -shared -O1 " + cname
+        + " -o " + dlname + " -lm";
+    return system(cmd.c_str())==0;
+  }
+
+  /// Exit status of a test
+  inline int result() {
+    if (failures()>0) std::cerr << failures() << " check(s) failed" << std::endl;
+    return failures()>0 ? 1 : 0;
+  }
+
+} // namespace casadi_test
+
+#define CASADI_CHECK(cond) \
+  do { if (!(cond)) casadi_test::fail("check failed: " #cond, __FILE__, __LINE__); } while (0)
+
+#define CASADI_CHECK_CLOSE(a, b, tol) \
+  casadi_test::checkClose(a, b, tol, #a " vs " #b, __FILE__, __LINE__)
+
+#endif // CASADI_TEST_TOOLS_HPP
@@ -842,6 +842,51 @@ class ADtests(casadiTestCase):
             H_ = Hf.getOutput()
           self.checkarray(Hf.getOutput(),H_,failmessage=("mode: %s" % mode))
           #self.checkarray(DMatrix(Gf.output().sparsity(),1),DMatrix(J_.sparsity(),1),str(mode)+str(out)+str(type(fun)))
+
+  def test_bidirectional(self):
+    self.message("bidirectional Jacobian partitioning")
+    n = 20
+    x = SX.sym("x",n)
+    # Arrow-shaped Jacobian: dense first row and first column
+    f = vertcat([sumAll(x**2),sin(x[0])*x[1:]+x[1:]**2])
+    x0 = DMatrix(range(1,n+1))/n
+    fun = SXFunction([x],[f])
+    J_ = None
+    for mode in ["forward","reverse","automatic"]:
+      fun.setOption("ad_mode",mode)
+      fun.init()
+      Jf=fun.jacobian(0,0)
+      Jf.init()
+      Jf.setInput(x0)
+      Jf.evaluate()
+      if J_ is None:
+        J_ = Jf.getOutput()
+      self.checkarray(Jf.getOutput(),J_,failmessage=("mode: %s" % mode))
+
+  def test_acyclic(self):
+    self.message("acyclic coloring of Hessians")
+    n = 20
+    x0 = DMatrix(range(1,n+1))/n
+    for X,Fun in [(SX,SXFunction),(MX,MXFunction)]:
+      x = X.sym("x",n)
+      # Banded Hessian
+      f = sumAll(x**4)
+      for j in range(1,4):
+        f = f + sumAll(sin(x[:n-j]*x[j:]))
+      H_ = None
+      for coloring in ["star","acyclic"]:
+        fun = Fun([x],[f])
+        fun.setOption("symmetric_coloring",coloring)
+        fun.init()
+        Hf=fun.hessian(0,0)
+        Hf.init()
+        Hf.setInput(x0)
+        Hf.evaluate()
+        if H_ is None:
+          H_ = Hf.getOutput()
+        self.checkarray(Hf.getOutput(),H_,failmessage=("coloring: %s" % coloring))
+    sp = Hf.getOutput().sparsity()
+    self.assertTrue(sp.acyclicColoring().size2()<sp.starColoring().size2())
     
 if __name__ == '__main__':
     unittest.main()
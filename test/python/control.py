@@ -99,6 +99,10 @@ if LinearSolver.hasPlugin("csparse") and DpleSolver.hasPlugin("simple"):
 if LinearSolver.hasPlugin("csparse") and DpleSolver.hasPlugin("condensing.simple"):
   dplesolvers.append(("condensing.simple",{"dle_solver_options": {"linear_solver": "csparse"}}))
 
+if LinearSolver.hasPlugin("csparse") and DpleSolver.hasPlugin("cyclic.simple"):
+  dplesolvers.append(("cyclic.simple",{"dle_solver_options": {"linear_solver": "csparse"}}))
+  dplesolvers.append(("cyclic.simple",{"parallelization": "expand", "dle_solver_options": {"linear_solver": "csparse"}}))
+
 if DpleSolver.hasPlugin("condensing.dple.slicot") and LinearSolver.hasPlugin("csparse"):
   dplesolvers.append(("condensing.dple.slicot",{"dle_solver_options.dple_solver_options": {"linear_solver": "csparse"}}))
 
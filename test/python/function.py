@@ -1165,7 +1165,150 @@ class Functiontests(casadiTestCase):
     f.init()
 
     self.checkarray(f(x=0.3)[0],DMatrix(0.09))
+
+  def test_sparsity_cache(self):
+    import tempfile, os
+    cache = os.path.join(tempfile.mkdtemp(),"sparsity.cache")
+
+    J_ = None
+    for X,Fun in [(SX,SXFunction),(MX,MXFunction),(MX,MXFunction)]:
+      x = X.sym("x",10)
+      f = Fun([x],[vertcat([sumAll(x**2),x[1:]*x[0]])])
+      f.setOption("sparsity_cache",cache)
+      f.init()
+      J = f.jacobian()
+      J.init()
+      J.setInput(range(10))
+      J.evaluate()
+      if J_ is None:
+        J_ = J.getOutput()
+      self.checkarray(J.getOutput(),J_)
+      self.checkarray(DMatrix(J.output().sparsity(),1),DMatrix(J_.sparsity(),1))
+    self.assertTrue(os.path.getsize(cache)>0)
+
+    # Same signature, different structure: the records of the first function must not match
+    x = SX.sym("x",10)
+    f = SXFunction([x],[vertcat([sumAll(x**2),x[1:]*x[1]])])
+    f.setOption("sparsity_cache",cache)
+    f.init()
+    J = f.jacobian()
+    J.init()
+    self.assertEqual(J.output().size(),27)
+    self.assertEqual(J.output().sparsity().colind()[2],11)
     
+  def test_sparsity_threads(self):
+    n = 300
+    x = SX.sym("x",n)
+    y = vertcat([x[i]*x[(i*7+13)%n]+sin(x[(i+1)%n]) for i in range(n)])
+    for symmetric in [False, True]:
+      if symmetric:
+        f = SXFunction([x],[gradient(sumAll(y**2),x)])
+      else:
+        f = SXFunction([x],[y])
+      for ad_mode in ["forward","reverse"]:
+        J = []
+        for threads in [1,4]:
+          g = SXFunction(f.inputExpr(),f.outputExpr())
+          g.setOption("sparsity_threads",threads)
+          g.setOption("ad_mode",ad_mode)
+          g.init()
+          J.append(g.jacSparsity(0,0,True,symmetric))
+        self.assertTrue(J[0].isEqual(J[1]))
+        if not symmetric:
+          self.assertEqual(J[0].size(),jacobian(f.outputExpr(0),x).size())
+
+  def test_gather_stats(self):
+    x = SX.sym("x",4)
+    g = SXFunction([x],[sin(x)*x])
+    g.setOption("name","g")
+    g.setOption("gather_stats",True)
+    g.init()
+
+    X = MX.sym("X",4)
+    f = MXFunction([X],[g([g([X])[0]*2])[0]])
+    f.setOption("name","f")
+    f.setOption("gather_stats",True)
+    f.init()
+
+    for i in range(5):
+      f.setInput(i)
+      f.evaluate()
+      f.getOutput()
+    self.assertEqual(g.getStat("n_eval"),10)
+
+    J = f.jacobian()
+    J.init()
+    J.setInput(1)
+    J.evaluate()
+
+    stats = f.getStats()
+    self.assertEqual(stats["n_eval"],5)
+    self.assertEqual(stats["n_eval_der"],1)
+    self.assertTrue(stats["t_eval_min"]<=stats["t_eval_max"])
+    self.assertEqual(stats["bytes_in"],5*4*8)
+    self.assertEqual(stats["bytes_out"],5*4*8)
+    self.assertEqual(stats["calls"]["g"]["n_eval"],10)
+
+  def test_gather_stats_unnamed(self):
+    x = SX.sym("x",2)
+    g1 = SXFunction([x],[sin(x)])
+    g1.init()
+    g2 = SXFunction([x],[cos(x)])
+    g2.init()
+
+    X = MX.sym("X",2)
+    h = MXFunction([X],[g1([X])[0]*2])
+    h.setOption("gather_stats",True)
+    h.init()
+
+    Y = MX.sym("Y",2)
+    f = MXFunction([Y],[g1([g2([Y])[0]])[0]+g2([Y])[0]+h([Y])[0]])
+    f.setOption("gather_stats",True)
+    f.init()
+    for i in range(3):
+      f.evaluate()
+
+    # Distinct functions with the same name are numbered in order of the first call
+    calls = f.getStats()["calls"]
+    self.assertEqual(sorted(calls.keys()),
+                     ["unnamed_mx_function","unnamed_sx_function[0]","unnamed_sx_function[1]"])
+    self.assertEqual(calls["unnamed_sx_function[0]"]["n_eval"],6)
+    self.assertEqual(calls["unnamed_sx_function[1]"]["n_eval"],3)
+    self.assertEqual(calls["unnamed_mx_function"]["n_eval"],3)
+    self.assertEqual(calls["unnamed_mx_function"]["calls"]["unnamed_sx_function"]["n_eval"],3)
+
+  def test_memory_usage(self):
+    x = SX.sym("x",10)
+    f = SXFunction([x],[sin(x)*x])
+    f.init()
+    J = f.jacobian()
+    J.init()
+
+    mem = f.getMemoryUsage()
+    self.assertTrue(mem["sx_nodes"]>0)
+    self.assertTrue(mem["derivatives"]>0)
+    self.assertAlmostEqual(mem["total"],sum(v for k,v in mem.items() if k!="total"))
+
+    mem = Function.getGlobalMemoryUsage()
+    self.assertTrue(mem["sparsity_cache"]>0)
+
+  def test_release_symbolic(self):
+    x = SX.sym("x",3)
+    X = MX.sym("X",3)
+    for f in [SXFunction([x],[sin(x)*x]), MXFunction([X],[sin(X)*X])]:
+      f.setOption("release_symbolic",True)
+      f.init()
+      f.setInput([1,2,3])
+      f.evaluate()
+      self.checkarray(f.getOutput(),DMatrix([sin(1),2*sin(2),3*sin(3)]))
+      self.assertEqual(f.getMemoryUsage()["symbolic"],0)
+      self.assertRaises(Exception,lambda : f.jacobian())
+      self.assertRaises(Exception,lambda : f.init())
+
+      # Symbolic calls remain possible
+      F = MXFunction([X],f.call([X]))
+      F.init()
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -35,6 +35,7 @@ solvers= []
  
 try:
   solvers.append((SimpleHomotopyNlpSolver,{"nlp_solver":"ipopt","nlp_solver_options": {"tol": 1e-12} }))
+  solvers.append((SimpleHomotopyNlpSolver,{"nlp_solver":"ipopt","nlp_solver_options": {"tol": 1e-12}, "adaptive": True, "predictor": "tangent" }))
   print "Will test SimpleHomotopyNlpSolver"
 except:
   pass
@@ -67,6 +68,30 @@ class NLPtests(casadiTestCase):
       self.checkarray(hnlpsolver.getOutput("x"),DMatrix([1.9635508794099052e-01,3.8009070491114780e-02]))
       self.checkarray(hnlpsolver.getOutput("lam_x"),DMatrix([0,0]))
       self.checkarray(hnlpsolver.getOutput("lam_g"),DMatrix([1.4371571368129470e+00]))
+
+  @requiresPlugin(HomotopyNlpSolver,"simple")
+  @requiresPlugin(NlpSolver,"sqpmethod")
+  @requiresPlugin(QpSolver,"qpoases")
+  def test_inner_failure(self):
+    x = SX.sym("x")
+    tau = SX.sym("tau")
+
+    # The constraints become infeasible for tau>0.5
+    hnlp = SXFunction(hnlpIn(x=x,tau=tau),nlpOut(f=(x-1)**2,g=vertcat([x-2*tau,x])))
+    hnlp.init()
+
+    for adaptive in [False, True]:
+      hnlpsolver = HomotopyNlpSolver("simple", hnlp)
+      hnlpsolver.setOption("nlp_solver","sqpmethod")
+      hnlpsolver.setOption("nlp_solver_options",{"qp_solver": "qpoases"})
+      hnlpsolver.setOption("adaptive",adaptive)
+      hnlpsolver.init()
+
+      hnlpsolver.setInput([0,-Inf],"lbg")
+      hnlpsolver.setInput([Inf,1],"ubg")
+
+      # The failure must not be hidden by accepting the previous step
+      self.assertRaises(Exception,lambda : hnlpsolver.evaluate())
       
 if __name__ == '__main__':
     unittest.main()
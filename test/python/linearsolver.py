@@ -458,6 +458,33 @@ class LinearSolverTests(casadiTestCase):
     C = S.getFactorization()
     self.checkarray(mul(C,C.T),M)
     
+  @requiresPlugin(LinearSolver,"csparse")
+  @requiresPlugin(LinearSolver,"csparsecholesky")
+  def test_ordering(self):
+    # 2-D Laplacian on an n-by-n grid, large enough to be dissected
+    n = 12
+    rows = []; cols = []; vals = []
+    for i in range(n):
+      for j in range(n):
+        k = i*n+j
+        rows.append(k); cols.append(k); vals.append(4.1)
+        for l,inside in [(k-n,i>0),(k+n,i<n-1),(k-1,j>0),(k+1,j<n-1)]:
+          if inside:
+            rows.append(k); cols.append(l); vals.append(-1)
+    A = DMatrix(Sparsity.triplet(n*n,n*n,rows,cols),vals)
+    b = DMatrix(range(n*n))
+    for Solver in ["csparse","csparsecholesky"]:
+      for ordering in ["natural","amd","nested_dissection"]:
+        solver = LinearSolver(Solver, A.sparsity())
+        solver.setOption("ordering",ordering)
+        solver.init()
+        solver.setInput(A,"A")
+        solver.prepare()
+        for tr in [False,True]:
+          solver.setInput(b,"B")
+          solver.solve(tr)
+          self.checkarray(mul(A.T if tr else A,solver.getOutput("X")),b)
+
   def test_large_sparse(self):
     numpy.random.seed(1)
     n = 10
@@ -2706,5 +2706,61 @@ class MXtests(casadiTestCase):
 
     h = g.jacobian(0,0,False,True)
 
+  def test_profiling_sampling(self):
+    import os
+    import json
+    import subprocess
+    import tempfile
+    from distutils.spawn import find_executable
+    for n in [0,-2]:
+      self.assertRaises(Exception,lambda : CasadiOptions.setProfilingSampling(n))
+    self.assertEqual(CasadiOptions.getProfilingSampling(),1)
+
+    fd, filename = tempfile.mkstemp()
+    os.close(fd)
+    fd, tracename = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    CasadiOptions.setProfilingSampling(3)
+    try:
+      # Functions are named in the log when they are initialized
+      CasadiOptions.startProfiling(filename)
+      x = SX.sym("x",3)
+      g = SXFunction([x],[sin(x)*x])
+      g.setOption("name","g")
+      g.init()
+
+      X = MX.sym("X",3)
+      f = MXFunction([X],[g([g([X])[0]*2])[0]])
+      f.setOption("name","f")
+      f.init()
+
+      for i in range(10):
+        f.setInput(i)
+        f.evaluate()
+        y = 2*sin(i)*i
+        self.checkarray(f.getOutput(),DMatrix.ones(3)*sin(y)*y)
+      CasadiOptions.stopProfiling()
+      self.assertTrue(os.path.getsize(filename)>0)
+
+      if "profiling," not in CasadiMeta.getFeatureList():
+        print "Built without profiling, skipping the trace check"
+        return
+      profiletrace = os.environ.get("CASADI_PROFILETRACE",find_executable("profiletrace"))
+      if profiletrace is None:
+        print "profiletrace not found, set CASADI_PROFILETRACE to check the trace"
+        return
+
+      # Calls 0, 3, 6 and 9 are recorded, with the two calls to g that each makes
+      subprocess.check_call([profiletrace,filename,tracename])
+      with open(tracename) as t:
+        trace = json.load(t)
+      calls = [e["name"] for e in trace["traceEvents"] if e.get("cat")=="call"]
+      self.assertEqual(calls.count("f"),4)
+      self.assertEqual(calls.count("g"),8)
+    finally:
+      CasadiOptions.setProfilingSampling(1)
+      os.remove(filename)
+      os.remove(tracename)
+
 if __name__ == '__main__':
     unittest.main()
@@ -81,6 +81,13 @@ try:
 except:
   pass
 
+try:
+  NlpSolver.loadPlugin("ipmethod")
+  solvers.append(("ipmethod",{"tol": 1e-10}))
+  print "Will test ipmethod"
+except:
+  pass
+
 """
 try:
   NlpSolver.loadPlugin("knitro")
@@ -1519,6 +1526,138 @@ class NLPtests(casadiTestCase):
       self.checkarray(solver.getOutput("x"),DMatrix([0]),digits=7)
       self.checkarray(solver.getOutput("lam_x"),DMatrix([0]),digits=7)
       
+  def test_sensitivity(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p",2)
+    nlp=SXFunction(nlpIn(x=x,p=p),nlpOut(f=sumAll((x-p)**2),g=x[0]+x[1]))
+
+    for Solver, solver_options in solvers:
+      self.message(Solver)
+      solver = NlpSolver(Solver, nlp)
+      solver.setOption(solver_options)
+      solver.init()
+      solver.setInput([0.3,0.1],"p")
+      solver.setInput(1,"lbg")
+      solver.setInput(1,"ubg")
+      solver.evaluate()
+
+      [dx,dlam_x,dlam_g] = solver.getSensitivity()
+      self.checkarray(dx,DMatrix([[0.5,-0.5],[-0.5,0.5]]),digits=7)
+      self.checkarray(dlam_x,DMatrix.zeros(2,2),digits=7)
+      self.checkarray(dlam_g,DMatrix([[1,1]]),digits=7)
+
+      # The problem is quadratic, the prediction is exact
+      solver.predict([0.5,0.2])
+      self.checkarray(solver.getInput("p"),DMatrix([0.5,0.2]),digits=7)
+      self.checkarray(solver.getInput("x0"),DMatrix([0.65,0.35]),digits=7)
+      self.checkarray(solver.getInput("lam_g0"),DMatrix([-0.3]),digits=7)
+
+  def test_batch(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p",2)
+    nlp=SXFunction(nlpIn(x=x,p=p),nlpOut(f=sumAll((x-p)**2),g=x[0]+x[1]))
+
+    P = DMatrix([[0.3,0.5,-1,2],[0.1,0.2,3,0]])
+    for Solver, solver_options in solvers:
+      self.message(Solver)
+      solver = NlpSolver(Solver, nlp)
+      solver.setOption(solver_options)
+      solver.init()
+      solver.setInput(1,"lbg")
+      solver.setInput(1,"ubg")
+
+      arg = [DMatrix() for i in range(NLP_SOLVER_NUM_IN)]
+      arg[NLP_SOLVER_P] = P
+      res = solver.solveBatch(arg)
+
+      self.checkarray(res[NLP_SOLVER_X],vertcat([(1+P[0,:]-P[1,:])/2,(1-P[0,:]+P[1,:])/2]),digits=7)
+      self.checkarray(res[NLP_SOLVER_LAM_G],P[0,:]+P[1,:]-1,digits=7)
+      for k in range(4):
+        solver.setInput(P[:,k],"p")
+        solver.evaluate()
+        self.checkarray(res[NLP_SOLVER_X][:,k],solver.getOutput("x"),digits=7)
+
+  @requiresPlugin(NlpSolver,"sqpmethod")
+  @requiresPlugin(QpSolver,"qpoases")
+  def test_batch_failure(self):
+    x=SX.sym("x")
+    p=SX.sym("p")
+    # Infeasible for p>1
+    nlp=SXFunction(nlpIn(x=x,p=p),nlpOut(f=x**2,g=vertcat([x-p,x])))
+
+    solver = NlpSolver("sqpmethod", nlp)
+    solver.setOption("qp_solver","qpoases")
+    solver.init()
+    solver.setInput([0,-Inf],"lbg")
+    solver.setInput([Inf,1],"ubg")
+
+    arg = [DMatrix() for i in range(NLP_SOLVER_NUM_IN)]
+    arg[NLP_SOLVER_P] = DMatrix([[0.5,2,0.2]])
+    res = solver.solveBatch(arg)
+
+    # The failed instance must not hold the solution of another one
+    self.checkarray(res[NLP_SOLVER_X][:,[0,2]],DMatrix([[0.5,0.2]]),digits=7)
+    for i in range(NLP_SOLVER_NUM_OUT):
+      self.assertTrue(isnan(array(res[i][:,1])).all())
+    self.assertFalse(solver.getBatchStats(1)["return_status"]=="Solve_Succeeded")
+
+  @requiresPlugin(NlpSolver,"sqpmethod")
+  @requiresPlugin(QpSolver,"qpoases")
+  def test_batch_reinit(self):
+    x=SX.sym("x",2)
+    p=SX.sym("p")
+    nlp=SXFunction(nlpIn(x=x,p=p),nlpOut(f=(p-x[0])**2+100*(x[1]-x[0]**2)**2))
+
+    solver = NlpSolver("sqpmethod", nlp)
+    solver.setOption("qp_solver","qpoases")
+    solver.init()
+    arg = [DMatrix() for i in range(NLP_SOLVER_NUM_IN)]
+    arg[NLP_SOLVER_P] = DMatrix([[0.5,0.8]])
+    solver.solveBatch(arg)
+    for k in range(2):
+      self.assertEqual(solver.getBatchStats(k)["return_status"],"Solve_Succeeded")
+
+    # The batch must be solved with the options of the last initialization
+    solver.setOption("max_iter",1)
+    solver.init()
+    solver.solveBatch(arg)
+    for k in range(2):
+      self.assertEqual(solver.getBatchStats(k)["return_status"],"Maximum_Iterations_Exceeded")
+
+  @requiresPlugin(NlpSolver,"scpgen")
+  @requiresPlugin(QpSolver,"qpoases")
+  def test_scpgen_parallelization(self):
+    # Single shooting, all intervals call the same step function
+    x=SX.sym("x",2)
+    u=SX.sym("u")
+    step=SXFunction([x,u],[x+0.1*vertcat([x[1],u-0.05*x[1]**2])])
+    step.init()
+
+    U=MX.sym("U",10)
+    X=MX.zeros(2,1)
+    for k in range(10):
+      X=step.call([X,U[k]])[0]
+      X.lift(X)
+    nlp=MXFunction(nlpIn(x=U),nlpOut(f=inner_prod(U,U),g=X))
+
+    for max_iter in [1,6]:
+      sol = {}
+      for parallelization in ["serial","openmp"]:
+        solver = NlpSolver("scpgen", nlp)
+        solver.setOption("qp_solver","qpoases")
+        solver.setOption("qp_solver_options",{"printLevel": "none"})
+        solver.setOption("print_header",False)
+        solver.setOption("max_iter",max_iter)
+        solver.setOption("parallelization",parallelization)
+        solver.init()
+        solver.setInput([1,0],"lbg")
+        solver.setInput([1,0],"ubg")
+        solver.evaluate()
+        sol[parallelization] = solver.getOutput("x")
+
+      # The tasks must not share the buffers of the step function
+      self.checkarray(sol["openmp"],sol["serial"],digits=12)
+
 if __name__ == '__main__':
     unittest.main()
     print solvers
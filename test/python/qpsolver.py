@@ -772,5 +772,159 @@ class QpSolverTests(casadiTestCase):
       
       self.assertAlmostEqual(solver.getOutput("cost")[0],7,5,str(qpsolver))
       
+  def test_hotstart_bounds(self):
+    if not QpSolver.hasPlugin("qpoases"): return
+    n = 10
+    H = DMatrix.zeros(n,n)
+    for i in range(n):
+      H[i,i] = 2
+      if i>0:
+        H[i,i-1] = H[i-1,i] = -0.5
+    A = DMatrix.sparse(0,n)
+
+    def solve(solver,H,G):
+      solver.setInput(H,"h")
+      solver.setInput(G,"g")
+      solver.setInput(-1,"lbx")
+      solver.setInput(1,"ubx")
+      solver.evaluate()
+
+    # Repeated solves of a box-constrained QP with a changing gradient and Hessian
+    solver = QpSolver("qpoases",qpStruct(h=H.sparsity(),a=A.sparsity()))
+    solver.setOption("share_working_set",True)
+    solver.init()
+    for k in range(4):
+      G = DMatrix([3*sin(0.7*i+0.1*k) for i in range(n)])
+      Hk = H + k*0.1*DMatrix.eye(n)
+      solve(solver,Hk,G)
+
+      ref = QpSolver("qpoases",qpStruct(h=H.sparsity(),a=A.sparsity()))
+      ref.init()
+      solve(ref,Hk,G)
+      self.checkarray(solver.getOutput(),ref.getOutput(),"hotstart %d" % k,digits=8)
+      self.checkarray(solver.getOutput("lam_x"),ref.getOutput("lam_x"),"hotstart %d" % k,digits=8)
+
+    # A new instance starts from the shared working set
+    solver2 = QpSolver("qpoases",qpStruct(h=H.sparsity(),a=A.sparsity()))
+    solver2.setOption("share_working_set",True)
+    solver2.init()
+    solve(solver2,Hk,G)
+    self.checkarray(solver2.getOutput(),solver.getOutput(),"shared working set",digits=8)
+    self.assertEqual(solver2.getStat("nWSR"),0)
+
+    # Only the working sets of the 16 most recently solved sparsity patterns are kept
+    for m in range(1,17):
+      other = QpSolver("qpoases",qpStruct(h=DMatrix.eye(m).sparsity(),a=DMatrix.sparse(0,m).sparsity()))
+      other.setOption("share_working_set",True)
+      other.init()
+      solve(other,DMatrix.eye(m),DMatrix.ones(m))
+    solver3 = QpSolver("qpoases",qpStruct(h=H.sparsity(),a=A.sparsity()))
+    solver3.setOption("share_working_set",True)
+    solver3.init()
+    solve(solver3,Hk,G)
+    self.assertEqual(solver3.getStat("nWSR"),ref.getStat("nWSR"))
+    self.assertTrue(solver3.getStat("nWSR")>0)
+
+  def test_admm(self):
+    if not QpSolver.hasPlugin("admm"): return
+    H = DMatrix([[1,-1],[-1,2]])
+    G = DMatrix([-2,-6])
+    A =  DMatrix([[1, 1],[-1, 2],[2, 1]])
+
+    solver = QpSolver("admm",qpStruct(h=H.sparsity(),a=A.sparsity()))
+    solver.setOption("eps_abs",1e-10)
+    solver.setOption("eps_rel",1e-10)
+    solver.init()
+
+    solver.setInput(H,"h")
+    solver.setInput(G,"g")
+    solver.setInput(A,"a")
+    solver.setInput(0,"lbx")
+    solver.setInput(inf,"ubx")
+    solver.setInput(-inf,"lba")
+    solver.setInput([2, 2, 3],"uba")
+
+    solver.evaluate()
+    self.checkarray(solver.getOutput(),DMatrix([2.0/3,4.0/3]),"admm",digits=6)
+    self.checkarray(solver.getOutput("lam_x"),DMatrix([0,0]),"admm",digits=6)
+    self.checkarray(solver.getOutput("lam_a"),DMatrix([3+1.0/9,4.0/9,0]),"admm",digits=6)
+    self.assertAlmostEqual(solver.getOutput("cost")[0],-8-2.0/9,6)
+    self.assertEqual(solver.getStat("return_status"),"Solve_Succeeded")
+
+    # Warm start from the previous solution, without refactorization
+    iter_cold = solver.getStat("iter_count")
+    solver.evaluate()
+    self.assertTrue(solver.getStat("iter_count")<iter_cold)
+    self.assertEqual(solver.getStat("n_factorizations"),0)
+
+    # Fixed iteration budget
+    solver.setOption("max_iter",2)
+    solver.setOption("warm_start",False)
+    solver.init()
+    solver.evaluate()
+    self.assertEqual(solver.getStat("iter_count"),2)
+    self.assertEqual(solver.getStat("return_status"),"Maximum_Iterations_Exceeded")
+
+    # Infeasibility detection
+    solver.setOption("max_iter",4000)
+    solver.init()
+    solver.setInput(5,"lbx")
+    with self.assertRaises(Exception):
+      solver.evaluate()
+    self.assertEqual(solver.getStat("return_status"),"Infeasible_Problem_Detected")
+
+  def test_riccati(self):
+    if not QpSolver.hasPlugin("riccati"): return
+    N = 5
+    nx = 2
+    nu = 1
+    # Stage-wise variables [x0,u0,...,xN], dynamics and a path constraint per stage
+    H = DMatrix.sparse(N*(nx+nu)+nx,N*(nx+nu)+nx)
+    A = DMatrix.sparse(2*N,N*(nx+nu)+nx)
+    G = DMatrix.zeros(N*(nx+nu)+nx)
+    LBX = DMatrix([-inf]*(N*(nx+nu)+nx))
+    UBX = DMatrix([inf]*(N*(nx+nu)+nx))
+    LBA = DMatrix.zeros(2*N)
+    UBA = DMatrix.zeros(2*N)
+    for k in range(N):
+      o = k*(nx+nu)
+      H[o,o] = 1
+      H[o+1,o+1] = 0.5
+      H[o+2,o+2] = 0.1
+      G[o+2] = 0.1
+      A[2*k,o+3] = 1
+      A[2*k,o] = -1
+      A[2*k,o+1] = -0.1
+      A[2*k+1,o+4] = 1
+      A[2*k+1,o+1] = -1
+      A[2*k+1,o+2] = -0.1
+      LBX[o+2] = -1
+      UBX[o+2] = 0.5
+    H[N*(nx+nu),N*(nx+nu)] = 5
+    H[N*(nx+nu)+1,N*(nx+nu)+1] = 5
+    LBX[0] = UBX[0] = 1
+    LBX[1] = UBX[1] = 0.5
+
+    for qpsolver, qp_options in qpsolvers:
+      if 'qcqp' in str(qpsolver): continue
+      self.message("riccati vs " + str(qpsolver))
+      solvers = []
+      for name, opts in [(qpsolver, qp_options), ("riccati", {"nx": [nx]*(N+1), "nu": [nu]*N})]:
+        solver = QpSolver(name,qpStruct(h=H.sparsity(),a=A.sparsity()))
+        solver.setOption(opts)
+        solver.init()
+        solver.setInput(H,"h")
+        solver.setInput(G,"g")
+        solver.setInput(A,"a")
+        solver.setInput(LBX,"lbx")
+        solver.setInput(UBX,"ubx")
+        solver.setInput(LBA,"lba")
+        solver.setInput(UBA,"uba")
+        solver.evaluate()
+        solvers.append(solver)
+
+      for out in ["x","lam_x","lam_a","cost"]:
+        self.checkarray(solvers[1].getOutput(out),solvers[0].getOutput(out),str(qpsolver) + ": " + out,digits=5)
+      
 if __name__ == '__main__':
     unittest.main()
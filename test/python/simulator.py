@@ -516,6 +516,47 @@ class Simulatortests(casadiTestCase):
     p=num['p']
 
     self.assertAlmostEqual(sim.getOutput()[0,-1],q0*exp((tend**3-0.7**3)/(3*p)),9,"Evaluation output mismatch")
+
+  def test_sim_streaming(self):
+    self.message("Simulator: streaming outputs")
+    num=self.num
+    q0=num['q0']
+    p=num['p']
+    t = n.linspace(0,num['tend'],100)
+
+    samples = []
+    @pycallback
+    def callback(f):
+      samples.append((f.getStat("t"),f.getOutput()[0]))
+      return 0
+
+    sim = Simulator(self.integrator,t)
+    sim.setOption("streaming",True)
+    sim.setOption("output_callback",callback)
+    sim.init()
+    self.assertEqual(sim.output().shape,(1,1))
+    sim.setInput([q0],0)
+    sim.setInput([p],1)
+    sim.evaluate()
+
+    self.assertEqual(len(samples),len(t))
+    self.checkarray(DMatrix([s[0] for s in samples]),DMatrix(t),"Streamed time mismatch")
+    self.checkarray(DMatrix([s[1] for s in samples]),DMatrix(q0*exp(t**3/(3*p))),"Streamed output mismatch",digits=9)
+
+  def test_sim_dense_output(self):
+    self.message("Simulator: dense output")
+    num=self.num
+    q0=num['q0']
+    p=num['p']
+    t = n.linspace(0,num['tend'],1000)
+    sim = Simulator(self.integrator,t)
+    sim.setOption("dense_output",True)
+    sim.init()
+    sim.setInput([q0],0)
+    sim.setInput([p],1)
+    sim.evaluate()
+
+    self.checkarray(sim.getOutput().T,DMatrix(q0*exp(t**3/(3*p))),"Evaluation output mismatch",digits=7)
             
 if __name__ == '__main__':
     unittest.main()